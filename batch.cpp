@@ -0,0 +1,664 @@
+#include "batch.hpp"
+
+#include "bounds.hpp"
+#include "graph.hpp"
+#include "graph6.hpp"
+#include "progress.hpp"
+#include "symmetry.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace {
+	// Lines decoded together by the reader
+	static constexpr std::size_t DECODE_CHUNK = 64;
+
+	struct batch_task {
+		std::size_t index_{ 0 };
+		std::string line_;
+		std::unique_ptr<graph> g_;
+
+		// With a schedule or an estimate log, by the worker that estimates
+		// the graph; the symmetries are kept for its solve
+		std::unique_ptr<graph_symmetry> sym_;
+		graph_features features_;
+		double predicted_{ 0 };
+	};
+
+	void estimate_task(batch_task& task, int probes) {
+		const game_bounds bounds = get_game_bounds(*task.g_);
+		if (bounds.lower_ < bounds.upper_) {
+			task.sym_ = std::make_unique<graph_symmetry>(*task.g_);
+		}
+
+		// Seeded by the input position, so the estimates do not depend on
+		// which worker makes them
+		std::mt19937_64 rng(task.index_);
+		task.features_ = get_graph_features(*task.g_, bounds, task.sym_.get(), probes, rng);
+		task.predicted_ = predict_solve_nodes(task.features_);
+	}
+
+	// One queue of tasks per worker, filled round robin. The owner takes from
+	// the front and thieves from the back, so they rarely meet. push() blocks
+	// while the queues are full, pop() while they are empty and not closed.
+	class task_queues {
+	  public:
+		task_queues(int workers, std::size_t capacity)
+			: lanes_(std::make_unique<lane[]>(workers)),
+			num_lanes_(workers),
+			capacity_(std::max<std::size_t>(capacity, 1)) { }
+
+		void push(batch_task&& task) {
+			std::unique_lock<std::mutex> lock(mutex_);
+			not_full_.wait(lock, [this]() { return queued_ < capacity_; });
+
+			lane& l = lanes_[next_];
+			next_ = (next_ + 1) % num_lanes_;
+			{
+				std::lock_guard<std::mutex> lane_lock(l.mutex_);
+				l.tasks_.push_back(std::move(task));
+			}
+
+			++queued_;
+			not_empty_.notify_one();
+		}
+
+		void close() {
+			std::lock_guard<std::mutex> lock(mutex_);
+			closed_ = true;
+			not_empty_.notify_all();
+		}
+
+		bool pop(int worker, batch_task& task, bool& stolen) {
+			for (;;) {
+				stolen = false;
+				bool found = take(lanes_[worker], task, true);
+
+				for (int i = 1; i < num_lanes_ && !found; ++i) {
+					found = stolen = take(lanes_[(worker + i) % num_lanes_], task, false);
+				}
+
+				std::unique_lock<std::mutex> lock(mutex_);
+
+				if (found) {
+					--queued_;
+					not_full_.notify_one();
+					return true;
+				}
+
+				// Tasks are counted once they are in a lane, so queued_ > 0 means
+				// another worker is about to take the last one; look again
+				if (queued_ == 0) {
+					if (closed_) {
+						return false;
+					}
+
+					not_empty_.wait(lock, [this]() { return queued_ > 0 || closed_; });
+				}
+			}
+		}
+
+	  private:
+		struct alignas(64) lane {
+			std::mutex mutex_;
+			std::deque<batch_task> tasks_;
+		};
+
+		static bool take(lane& l, batch_task& task, bool front) {
+			std::lock_guard<std::mutex> lock(l.mutex_);
+
+			if (l.tasks_.empty()) {
+				return false;
+			}
+
+			if (front) {
+				task = std::move(l.tasks_.front());
+				l.tasks_.pop_front();
+			}
+			else {
+				task = std::move(l.tasks_.back());
+				l.tasks_.pop_back();
+			}
+
+			return true;
+		}
+
+		std::unique_ptr<lane[]> lanes_;
+		const int num_lanes_;
+		const std::size_t capacity_;
+
+		std::mutex mutex_;
+		std::condition_variable not_full_;
+		std::condition_variable not_empty_;
+		std::size_t queued_{ 0 };
+		std::size_t next_{ 0 };
+		bool closed_{ false };
+	};
+
+	// A single queue of tasks, heaviest predicted first and in input order
+	// among equal predictions, e.g., of graphs settled by their bounds. Tasks
+	// come in unestimated, and the workers estimate every one of them before
+	// they solve any, so the reader only decodes. push() blocks while the
+	// window of tasks to estimate, being estimated and to solve is full,
+	// pop() while there is none of the first and the last and the queue is
+	// not closed, or some are being estimated.
+	class heaviest_first_queue {
+	  public:
+		explicit heaviest_first_queue(std::size_t capacity) : capacity_(std::max<std::size_t>(capacity, 1)) { }
+
+		void push(batch_task&& task) {
+			std::unique_lock<std::mutex> lock(mutex_);
+			not_full_.wait(lock, [this]() { return unestimated_.size() + estimating_ + tasks_.size() < capacity_; });
+
+			unestimated_.push_back(std::move(task));
+			not_empty_.notify_one();
+		}
+
+		void close() {
+			std::lock_guard<std::mutex> lock(mutex_);
+			closed_ = true;
+			not_empty_.notify_all();
+		}
+
+		// A task to estimate and hand back to estimated() if estimate is set,
+		// otherwise one to solve
+		bool pop(batch_task& task, bool& estimate) {
+			std::unique_lock<std::mutex> lock(mutex_);
+			not_empty_.wait(lock, [this]() {
+				return !unestimated_.empty() || !tasks_.empty() || (closed_ && estimating_ == 0);
+			});
+
+			estimate = !unestimated_.empty();
+
+			if (estimate) {
+				task = std::move(unestimated_.front());
+				unestimated_.pop_front();
+				++estimating_;
+				return true;
+			}
+
+			if (tasks_.empty()) {
+				return false;
+			}
+
+			std::pop_heap(tasks_.begin(), tasks_.end(), lighter);
+			task = std::move(tasks_.back());
+			tasks_.pop_back();
+			not_full_.notify_one();
+			return true;
+		}
+
+		void estimated(batch_task&& task) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			--estimating_;
+
+			tasks_.push_back(std::move(task));
+			std::push_heap(tasks_.begin(), tasks_.end(), lighter);
+
+			// The last estimate may let every waiting worker finish
+			if (closed_ && estimating_ == 0) {
+				not_empty_.notify_all();
+			}
+			else {
+				not_empty_.notify_one();
+			}
+		}
+
+	  private:
+		static bool lighter(const batch_task& a, const batch_task& b) {
+			return a.predicted_ != b.predicted_ ? a.predicted_ < b.predicted_ : a.index_ > b.index_;
+		}
+
+		const std::size_t capacity_;
+		std::deque<batch_task> unestimated_;
+		std::size_t estimating_{ 0 };
+		std::vector<batch_task> tasks_;
+
+		std::mutex mutex_;
+		std::condition_variable not_full_;
+		std::condition_variable not_empty_;
+		bool closed_{ false };
+	};
+
+	// Collects the results of the workers and writes them on its own thread.
+	// In input order, a result waits until all earlier ones are written.
+	class result_writer {
+	  public:
+		result_writer(std::ostream& out, const batch_options& options)
+			: out_(out), options_(options), thread_([this]() { run(); }) { }
+
+		~result_writer() {
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				done_ = true;
+			}
+
+			ready_.notify_one();
+			thread_.join();
+		}
+
+		// The estimate log line, if any, is written as it comes
+		void push(std::size_t index, std::string&& text, std::string&& log = std::string()) {
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				incoming_.emplace_back(index, std::move(text));
+				if (!log.empty()) {
+					logs_.push_back(std::move(log));
+				}
+			}
+
+			ready_.notify_one();
+		}
+
+	  private:
+		void run() {
+			std::vector<std::pair<std::size_t, std::string>> batch;
+			std::vector<std::string> logs;
+
+			for (bool done = false; !done; ) {
+				{
+					std::unique_lock<std::mutex> lock(mutex_);
+					ready_.wait(lock, [this]() { return done_ || !incoming_.empty(); });
+
+					batch.swap(incoming_);
+					logs.swap(logs_);
+					done = done_ && batch.empty();
+				}
+
+				if (options_.estimate_log_ != nullptr && !logs.empty()) {
+					for (const auto& log : logs) {
+						*options_.estimate_log_ << log << "\n";
+					}
+					options_.estimate_log_->flush();
+				}
+				logs.clear();
+
+				for (auto& [index, text] : batch) {
+					if (options_.completion_order_) {
+						write(text);
+					}
+					else {
+						pending_.emplace(index, std::move(text));
+					}
+				}
+				batch.clear();
+
+				for (auto it = pending_.begin(); it != pending_.end() && it->first == next_; it = pending_.erase(it)) {
+					write(it->second);
+				}
+
+				out_.flush();
+			}
+		}
+
+		void write(const std::string& text) {
+			out_ << text << "\n";
+			++next_;
+		}
+
+		std::ostream& out_;
+		const batch_options& options_;
+
+		std::mutex mutex_;
+		std::condition_variable ready_;
+		std::vector<std::pair<std::size_t, std::string>> incoming_;
+		std::vector<std::string> logs_;
+		bool done_{ false };
+
+		// Written by the writer thread only
+		std::map<std::size_t, std::string> pending_;
+		std::size_t next_{ 0 };
+
+		std::thread thread_;
+	};
+}
+
+bool parse_stats_format(const std::string& name, StatsFormat& format) {
+	if (name == "none") {
+		format = StatsFormat::None;
+	}
+	else if (name == "csv") {
+		format = StatsFormat::Csv;
+	}
+	else if (name == "json") {
+		format = StatsFormat::Json;
+	}
+	else {
+		return false;
+	}
+
+	return true;
+}
+
+int game_chromatic_number(const graph& g, const outcome_solver& solve, search_counters& counters,
+	std::vector<solve_record>& solves, const graph_symmetry* sym) {
+	const game_bounds bounds = get_game_bounds(g);
+	solves.clear();
+
+	if (bounds.lower_ >= bounds.upper_) {
+		return bounds.upper_;
+	}
+
+	std::unique_ptr<graph_symmetry> own;
+	if (sym == nullptr) {
+		own = std::make_unique<graph_symmetry>(g);
+		sym = own.get();
+	}
+
+	// Alice may win with k colors and lose with k + 1, so every k below the
+	// upper bound is tried in turn
+	for (int num_cols = bounds.lower_; num_cols < bounds.upper_; ++num_cols) {
+		solve_record& r = solves.emplace_back();
+		r.num_cols_ = num_cols;
+
+		const auto t1 = std::chrono::steady_clock::now();
+		r.outcome_ = solve(g, num_cols, *sym, r.counters_);
+		r.seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - t1).count();
+
+		counters += r.counters_;
+
+		if (r.outcome_ == Victory::Alice) {
+			return num_cols;
+		}
+	}
+
+	return bounds.upper_;
+}
+
+std::string format_solves(const std::vector<solve_record>& solves, StatsFormat format) {
+	if (format == StatsFormat::None) {
+		return std::string();
+	}
+
+	const bool json = format == StatsFormat::Json;
+
+	if (!json && solves.empty()) {
+		return "-";
+	}
+
+	std::ostringstream os;
+	os << std::setprecision(6);
+
+	if (json) {
+		os << "[";
+	}
+
+	for (std::size_t i = 0; i < solves.size(); ++i) {
+		const solve_record& r = solves[i];
+		const search_counters& c = r.counters_;
+		const char* winner = r.outcome_ == Victory::Alice ? "alice" : "bob";
+
+		if (i > 0) {
+			os << (json ? "," : ";");
+		}
+
+		if (json) {
+			os << "{\"k\":" << r.num_cols_ << ",\"winner\":\"" << winner << "\",\"seconds\":" << r.seconds_
+				<< ",\"nodes\":" << c.nodes_ << ",\"cutoffs\":" << c.cutoffs_ << ",\"tt_probes\":" << c.tt_probes_
+				<< ",\"tt_hits\":" << c.tt_hits_ << ",\"terminals\":" << c.terminals_ << ",\"max_ply\":" << c.max_ply_
+				<< ",\"ply_nodes\":[";
+		}
+		else {
+			os << r.num_cols_ << "," << winner << "," << r.seconds_ << "," << c.nodes_ << "," << c.cutoffs_ << ","
+				<< c.tt_probes_ << "," << c.tt_hits_ << "," << c.terminals_ << "," << c.max_ply_ << ",";
+		}
+
+		const int plies = std::min(c.max_ply_ + 1, MAX_STATS_PLIES);
+		for (int ply = 0; ply < plies; ++ply) {
+			os << (ply > 0 ? (json ? "," : "/") : "") << c.ply_nodes_[ply];
+		}
+
+		if (json) {
+			os << "]}";
+		}
+	}
+
+	if (json) {
+		os << "]";
+	}
+
+	return os.str();
+}
+
+batch_report run_g6_batch(const line_reader& next_line, std::ostream& out, const solver_factory& make_solver,
+	const batch_options& options, const line_filter& skip) {
+	const int num_workers = std::max(options.workers_, 1);
+	const auto start = std::chrono::steady_clock::now();
+
+	batch_report report;
+	report.workers_.resize(num_workers);
+	std::vector<search_counters> counters(num_workers);
+
+	// Only one of the two is used
+	const bool scheduled = options.schedule_window_ > 0;
+	const bool estimated = scheduled || options.estimate_log_ != nullptr;
+	task_queues queues(num_workers, scheduled ? 1 : options.queue_capacity_);
+	heaviest_first_queue heaviest(options.schedule_window_);
+
+	batch_progress progress(num_workers, std::cerr, options.progress_seconds_, options.verbose_);
+
+	{
+		result_writer writer(out, options);
+		std::vector<std::thread> workers;
+
+		for (int id = 0; id < num_workers; ++id) {
+			workers.emplace_back([&, id]() {
+				const outcome_solver inner = make_solver();
+				const outcome_solver solve = [&](const graph& g, int num_cols, const graph_symmetry& sym,
+					search_counters& c) {
+					progress.begin_solve(id, num_cols, c);
+					const Victory outcome = inner(g, num_cols, sym, c);
+					progress.end_solve(id, c);
+					return outcome;
+				};
+
+				worker_report& w = report.workers_[id];
+				batch_task task;
+				bool stolen = false;
+				bool estimate = false;
+				std::vector<solve_record> solves;
+
+				while (scheduled ? heaviest.pop(task, estimate) : queues.pop(id, task, stolen)) {
+					// Scheduled tasks go back to the queue once estimated; with
+					// only an estimate log, the worker estimates what it solves
+					if (estimate) {
+						estimate_task(task, options.estimate_probes_);
+						heaviest.estimated(std::move(task));
+						continue;
+					}
+
+					if (estimated && !scheduled) {
+						estimate_task(task, options.estimate_probes_);
+					}
+
+					progress.begin_graph(id, task.line_);
+
+					const auto t1 = std::chrono::steady_clock::now();
+					const int k = game_chromatic_number(*task.g_, solve, counters[id], solves, task.sym_.get());
+					const auto t2 = std::chrono::steady_clock::now();
+
+					++w.graphs_;
+					w.solves_ += solves.size();
+					w.bounded_ += solves.empty();
+					w.steals_ += stolen;
+					w.busy_seconds_ += std::chrono::duration<double>(t2 - t1).count();
+
+					progress.end_graph(id, w, counters[id]);
+
+					std::string text = task.line_ + " " + std::to_string(k) + " " + std::to_string(solves.size());
+					if (options.stats_ != StatsFormat::None) {
+						text += " " + format_solves(solves, options.stats_);
+					}
+
+					std::string log;
+					if (options.estimate_log_ != nullptr) {
+						std::uint64_t actual = 0;
+						for (const solve_record& r : solves) {
+							actual += r.counters_.nodes_ + r.counters_.endgame_nodes_;
+						}
+
+						const graph_features& f = task.features_;
+						std::ostringstream os;
+						os << std::setprecision(6) << task.line_ << " " << f.vertices_ << " " << f.edges_ << " "
+							<< f.degeneracy_ << " " << f.lower_ << " " << f.upper_ << " " << f.tree_size_ << " "
+							<< task.predicted_ << " " << actual;
+						log = os.str();
+					}
+
+					writer.push(task.index_, std::move(text), std::move(log));
+				}
+			});
+		}
+
+		// The reader runs on this thread, decoding a chunk of lines at a time
+		std::vector<batch_task> chunk;
+		std::vector<std::string_view> views;
+		graph6_batch decoder;
+		std::vector<index_t> wide_rows;
+		std::size_t index = 0;
+		std::uint64_t lines_read = 0;
+
+		const auto report_read = [&]() {
+			const double fraction = options.input_fraction_ ? options.input_fraction_()
+				: (options.num_lines_ > 0 ? static_cast<double>(lines_read) / options.num_lines_ : -1.0);
+			progress.read(index, report.skipped_, report.malformed_, fraction);
+		};
+
+		const auto push_chunk = [&]() {
+			views.clear();
+			for (const auto& task : chunk) {
+				views.push_back(task.line_);
+			}
+
+			decoder.decode(views.data(), views.size());
+
+			for (std::size_t i = 0; i < chunk.size(); ++i) {
+				const int n = decoder.num_vertices(i);
+
+				if (n != NOT_GRAPH6) {
+					chunk[i].g_ = std::make_unique<graph>(n, decoder.rows(i));
+				}
+				else {
+					// Graphs of more than 64 vertices, or malformed lines
+					const int wide_n = decode_graph6(chunk[i].line_, wide_rows);
+
+					if (wide_n == NOT_GRAPH6) {
+						++report.malformed_;
+						continue;
+					}
+
+					chunk[i].g_ = std::make_unique<graph>(wide_n, wide_rows.data());
+				}
+
+				chunk[i].index_ = index++;
+
+				if (scheduled) {
+					heaviest.push(std::move(chunk[i]));
+				}
+				else {
+					queues.push(std::move(chunk[i]));
+				}
+			}
+
+			chunk.clear();
+		};
+
+		std::string_view line;
+
+		while (next_line(line)) {
+			if (++lines_read % DECODE_CHUNK == 0) {
+				report_read();
+			}
+
+			if (line.empty()) {
+				continue;
+			}
+
+			if (skip && skip(line)) {
+				++report.skipped_;
+				continue;
+			}
+
+			chunk.emplace_back().line_ = line;
+
+			if (chunk.size() == DECODE_CHUNK) {
+				push_chunk();
+			}
+		}
+
+		push_chunk();
+		report_read();
+		queues.close();
+		heaviest.close();
+
+		for (auto& worker : workers) {
+			worker.join();
+		}
+
+		report.graphs_ = index;
+	}
+
+	for (const auto& c : counters) {
+		report.counters_ += c;
+	}
+
+	for (const auto& w : report.workers_) {
+		report.solves_ += w.solves_;
+		report.bounded_ += w.bounded_;
+	}
+
+	report.wall_seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return report;
+}
+
+batch_report run_g6_batch(std::istream& in, std::ostream& out, const solver_factory& make_solver,
+	const batch_options& options, const line_filter& skip) {
+	std::string buffer;
+
+	const line_reader next_line = [&](std::string_view& line) {
+		if (!std::getline(in, buffer)) {
+			return false;
+		}
+
+		line = buffer;
+		return true;
+	};
+
+	return run_g6_batch(next_line, out, make_solver, options, skip);
+}
+
+void print_batch_report(const batch_report& report, std::ostream& os) {
+	os << "Solved " << report.graphs_ << " graphs (skipped " << report.skipped_ << ", malformed "
+		<< report.malformed_ << ") in "
+		<< std::fixed << std::setprecision(3) << report.wall_seconds_ << "s\n";
+	os << "Solved " << report.solves_ << " games, and settled " << report.bounded_
+		<< " graphs by their bounds alone\n";
+	os << "Searched " << report.counters_.nodes_ << " nodes, skipped "
+		<< report.counters_.orbit_prunes_ << " vertices by orbits and "
+		<< report.counters_.twin_prunes_ << " by twins and "
+		<< report.counters_.tempo_prunes_ << " as tempo moves\n";
+	os << "Decided " << report.counters_.safe_wins_ << " nodes as safe and " << report.counters_.threat_wins_
+		<< " by Bob's threats, which ruled out " << report.counters_.threat_prunes_ << " of Alice's vertices\n";
+	os << "Handed " << report.counters_.endgame_solves_ << " nodes to the endgame solver, which searched "
+		<< report.counters_.endgame_nodes_ << " positions\n";
+	os << "Solved " << report.counters_.tablebase_solves_ << " games by tablebase, over "
+		<< report.counters_.tablebase_states_ << " colorings\n";
+
+	for (std::size_t i = 0; i < report.workers_.size(); ++i) {
+		const worker_report& w = report.workers_[i];
+		const double utilization = report.wall_seconds_ > 0 ? 100 * w.busy_seconds_ / report.wall_seconds_ : 0;
+
+		os << "Worker " << i << ": " << w.graphs_ << " graphs, " << w.steals_ << " stolen, busy "
+			<< std::setprecision(3) << w.busy_seconds_ << "s (" << std::setprecision(1) << utilization << "%)\n";
+	}
+}
\ No newline at end of file
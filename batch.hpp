@@ -0,0 +1,154 @@
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include "game_state.hpp"
+#include "minimax.hpp"
+#include "estimate.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class graph;
+class graph_symmetry;
+
+// Decides whether Alice wins g with the given number of colors
+typedef std::function<Victory(const graph&, int, const graph_symmetry&, search_counters&)> outcome_solver;
+
+// Makes the solver of one worker, so that every worker owns its tables
+typedef std::function<outcome_solver()> solver_factory;
+
+// Sets its argument to the next input line and returns true, or returns
+// false at the end of the input. The view must stay valid until the next
+// call.
+typedef std::function<bool(std::string_view&)> line_reader;
+
+// Whether the graph6 line is to be left out
+typedef std::function<bool(std::string_view)> line_filter;
+
+static constexpr std::size_t DEFAULT_BATCH_QUEUE = 1024;
+
+static constexpr double DEFAULT_PROGRESS_SECONDS = 10;
+
+// Statistics of every solve written after a result, see format_solves()
+enum class StatsFormat {
+	None = 0,
+	Csv = 1,
+	Json = 2
+};
+
+bool parse_stats_format(const std::string& name, StatsFormat& format);
+
+struct batch_options {
+	int workers_{ 1 };
+
+	// Emit results as they complete instead of in input order
+	bool completion_order_{ false };
+
+	// Graphs decoded ahead of the workers, at most
+	std::size_t queue_capacity_{ DEFAULT_BATCH_QUEUE };
+
+	// If positive, the graphs read ahead, at most, of which the workers
+	// always take the one predicted to be the heaviest, see
+	// predict_solve_nodes(). Otherwise they take them in input order.
+	std::size_t schedule_window_{ 0 };
+	int estimate_probes_{ DEFAULT_ESTIMATE_PROBES };
+
+	// If set, gets a line "<graph6> <vertices> <edges> <degeneracy> <lower>
+	// <upper> <tree size> <predicted> <actual>" for every graph as it is
+	// solved, where actual counts the nodes and endgame positions searched
+	std::ostream* estimate_log_{ nullptr };
+
+	// Number of input lines, if known, for the ETA
+	std::size_t num_lines_{ 0 };
+
+	// The fraction of the input read so far, for the ETA, if known; called
+	// on the thread that reads the lines, after a chunk of them
+	std::function<double()> input_fraction_;
+
+	// Seconds between progress lines on stderr, none if 0. With verbose_,
+	// SIGUSR1 dumps the totals so far in any case, see batch_progress.
+	double progress_seconds_{ DEFAULT_PROGRESS_SECONDS };
+
+	StatsFormat stats_{ StatsFormat::None };
+
+	bool verbose_{ true };
+};
+
+struct worker_report {
+	std::uint64_t graphs_{ 0 };
+
+	// Games solved, and graphs whose bounds met so that none was
+	std::uint64_t solves_{ 0 };
+	std::uint64_t bounded_{ 0 };
+	std::uint64_t steals_{ 0 };
+	double busy_seconds_{ 0 };
+};
+
+struct batch_report {
+	std::uint64_t graphs_{ 0 };
+	std::uint64_t skipped_{ 0 };
+
+	// Lines that are not graph6 with at most MAX_VERTICES vertices
+	std::uint64_t malformed_{ 0 };
+
+	// Totals of the workers
+	std::uint64_t solves_{ 0 };
+	std::uint64_t bounded_{ 0 };
+
+	double wall_seconds_{ 0 };
+	search_counters counters_;
+	std::vector<worker_report> workers_;
+};
+
+// One game solved for a graph
+struct solve_record {
+	int num_cols_{ 0 };
+	Victory outcome_{ Victory::Bob };
+	double seconds_{ 0 };
+	search_counters counters_;
+};
+
+// The fewest colors with which Alice wins on g, trying every k from the
+// lower bound of get_game_bounds() up to, but not including, the upper one.
+// solves gets a record of every game solved, none if the bounds meet, and
+// counters their sum. The symmetries of g are computed here unless given.
+int game_chromatic_number(const graph& g, const outcome_solver& solve, search_counters& counters,
+	std::vector<solve_record>& solves, const graph_symmetry* sym = nullptr);
+
+// The solves as one field without spaces. As CSV, every solve is a group
+// "k,winner,seconds,nodes,cutoffs,tt_probes,tt_hits,terminals,max_ply,
+// ply_nodes" with the nodes of every ply joined by '/', and groups are
+// separated by ';', or "-" if there are none. As JSON, an array with an
+// object of the same fields per solve. Empty without a format.
+std::string format_solves(const std::vector<solve_record>& solves, StatsFormat format);
+
+// Solves every nonempty graph6 line of next_line and writes
+// "<line> <k> <solves>" for it to out, followed by the field of
+// format_solves() with a format. Lines for which skip() holds are left
+// out, as are malformed ones.
+//
+// A reader thread decodes the lines into one queue per worker, holding
+// queue_capacity_ graphs in total. Workers take from the front of their own
+// queue and, once it is empty, steal from the back of the others. With a
+// schedule_window_, the reader instead keeps that many in a single queue,
+// which the workers estimate before they solve any and then take by their
+// predictions, heaviest first, so that a graph far heavier than the rest
+// starts as soon as it is read. A worker keeps the symmetries it finds for
+// an estimate for the solve. A writer
+// thread emits the results in input order, or as they complete if
+// completion_order_ is set, so workers never wait on the output.
+batch_report run_g6_batch(const line_reader& next_line, std::ostream& out, const solver_factory& make_solver,
+	const batch_options& options, const line_filter& skip = nullptr);
+
+// The same for the lines of a stream
+batch_report run_g6_batch(std::istream& in, std::ostream& out, const solver_factory& make_solver,
+	const batch_options& options, const line_filter& skip = nullptr);
+
+// Totals and the utilization of every worker
+void print_batch_report(const batch_report& report, std::ostream& os);
+
+#endif
\ No newline at end of file
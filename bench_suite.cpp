@@ -0,0 +1,421 @@
+#include "bench_suite.hpp"
+
+#include "batch.hpp"
+#include "dfpn.hpp"
+#include "graph.hpp"
+#include "graph6.hpp"
+#include "minimax.hpp"
+#include "transposition_table.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+namespace {
+	struct suite_config {
+		std::string name_;
+		search_options options_;
+
+		// Larger graphs are left out
+		int max_vertices_;
+	};
+
+	std::vector<suite_config> get_configs() {
+		search_options alphabeta;
+		alphabeta.fixed_kernels_ = false;
+
+		search_options dfpn;
+		dfpn.engine_ = Engine::ProofNumber;
+
+		search_options tablebase;
+		tablebase.engine_ = Engine::Tablebase;
+
+		return {
+			{ "alphabeta", alphabeta, MAX_VERTICES },
+			{ "fixed", search_options(), MAX_VERTICES },
+			{ "dfpn", dfpn, MAX_VERTICES },
+			{ "tablebase", tablebase, 10 }
+		};
+	}
+
+	// A solver with tables of its own, as a batch worker has
+	outcome_solver make_solver(const search_options& options) {
+		if (options.engine_ == Engine::ProofNumber) {
+			auto table = std::make_shared<pn_table>();
+			return [table, options](const graph& g, int num_cols, const graph_symmetry& sym, search_counters& counters) {
+				return solve_outcome_dfpn(g, num_cols, *table, &sym, &counters, options);
+			};
+		}
+
+		auto tt = std::make_shared<transposition_table>();
+		return [tt, options](const graph& g, int num_cols, const graph_symmetry& sym, search_counters& counters) {
+			return solve_outcome(g, num_cols, *tt, &sym, &counters, options);
+		};
+	}
+
+	// One trial of a configuration on a family
+	struct trial_sample {
+		double seconds_{ 0 };
+		std::uint64_t nodes_{ 0 };
+		std::uint64_t solves_{ 0 };
+	};
+
+	// The nearest-rank percentile
+	double percentile(std::vector<double> samples, double p) {
+		std::sort(samples.begin(), samples.end());
+		const std::size_t rank = static_cast<std::size_t>(std::ceil(p * samples.size()));
+		return samples[std::max<std::size_t>(rank, 1) - 1];
+	}
+
+	suite_result summarize(std::vector<trial_sample> samples) {
+		std::vector<double> ms;
+		for (const auto& s : samples) {
+			ms.push_back(1000 * s.seconds_);
+		}
+
+		std::sort(samples.begin(), samples.end(), [](const trial_sample& a, const trial_sample& b) {
+			return a.seconds_ < b.seconds_;
+		});
+		const trial_sample& median = samples[(samples.size() - 1) / 2];
+		const double seconds = std::max(median.seconds_, 1e-9);
+
+		suite_result r;
+		r.median_ms_ = percentile(ms, 0.5);
+		r.p95_ms_ = percentile(ms, 0.95);
+		r.nodes_per_sec_ = median.nodes_ / seconds;
+		r.solves_per_sec_ = median.solves_ / seconds;
+		return r;
+	}
+
+	// A minimal reader for the JSON of write_suite_results()
+	class json_reader {
+	  public:
+		explicit json_reader(std::string text)
+			: text_(std::move(text)) { }
+
+		bool consume(char c) {
+			skip_space();
+			if (pos_ < text_.size() && text_[pos_] == c) {
+				++pos_;
+				return true;
+			}
+			return false;
+		}
+
+		bool read_string(std::string& s) {
+			if (!consume('"')) {
+				return false;
+			}
+
+			const std::size_t end = text_.find('"', pos_);
+			if (end == std::string::npos) {
+				return false;
+			}
+
+			s = text_.substr(pos_, end - pos_);
+			pos_ = end + 1;
+			return true;
+		}
+
+		bool read_number(double& x) {
+			skip_space();
+			const char* first = text_.c_str() + pos_;
+			char* last = nullptr;
+			x = std::strtod(first, &last);
+
+			if (last == first) {
+				return false;
+			}
+
+			pos_ += last - first;
+			return true;
+		}
+
+		bool at_end() {
+			skip_space();
+			return pos_ == text_.size();
+		}
+
+	  private:
+		void skip_space() {
+			while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+				++pos_;
+			}
+		}
+
+		std::string text_;
+		std::size_t pos_{ 0 };
+	};
+}
+
+const std::vector<corpus_graph>& get_corpus() {
+	static const std::vector<corpus_graph> corpus = []() {
+		std::vector<corpus_graph> c;
+
+		for (const int n : { 5, 8, 12, 16 }) {
+			c.push_back({ "cycles", to_graph6(get_cycle(n)), 3 });
+		}
+
+		for (const int n : { 7, 13, 40, 100 }) {
+			c.push_back({ "stars", to_graph6(get_star(n)), 2 });
+		}
+
+		for (const int n : { 5, 8 }) {
+			c.push_back({ "complete", to_graph6(get_complete_graph(n)), n });
+		}
+
+		for (const int n : { 6, 8, 10 }) {
+			c.push_back({ "wheels", to_graph6(get_wheel(n)), 4 });
+		}
+
+		const std::vector<corpus_graph> samples = {
+			{ "outerplanar", "I?Xm?rGEG", 4 },
+			{ "outerplanar", "JGY?oI?FTP?", 4 },
+			{ "outerplanar", "J`p?[OPI@_?", 4 },
+			{ "outerplanar", "JQ_I?`LB@C?", 4 },
+			{ "outerplanar", "K?KCAHr_?dcc", 4 },
+			{ "outerplanar", "KBSD?QAg_K@w", 4 },
+			{ "outerplanar", "L?SQC?_@Sp?OY`", 4 },
+			{ "outerplanar", "LO??IY_EOgw?Go", 4 },
+			{ "planar", "GSF@uC", 3 },
+			{ "planar", "HzXrFOO", 5 },
+			{ "planar", "IdgmObZcG", 5 },
+			{ "planar", "I?RHOR|[G", 4 },
+			{ "planar", "J?QelECCeS_", 4 },
+			{ "planar", "JZWEAGLQJc?", 4 },
+			{ "planar", "K@LGE?azX_{U", 5 },
+			{ "planar", "KOwT?hGQFxG@", 5 },
+			{ "random", "LvNM?OfoZp??g?", 5 },
+			{ "random", "LLpppohaaYG^Ac", 5 },
+			{ "random", "MCPWq?W?IwQO?OwH?", 5 },
+			{ "random", "MY^G_oPY_XEPIc?C?", 5 },
+			{ "random", "N?GB?OO?\\AAQQAqFSC_", 4 },
+			{ "tests", "E?~o", 3 },
+			{ "tests", "FhCKG", 3 },
+			{ "tests", "G?AFCs", 4 },
+			{ "tests", "GQz~vk", 5 },
+			{ "tests", "H?AADrq", 3 },
+			{ "tests", "I?D_f@Z_o", 4 },
+			{ "tests", "IKc@g[OOG", 4 },
+			{ "tests", "Igh?c?ECO", 3 }
+		};
+
+		c.insert(c.end(), samples.cbegin(), samples.cend());
+		return c;
+	}();
+
+	return corpus;
+}
+
+bool run_bench_suite(const suite_options& options, std::ostream& os) {
+	const auto& corpus = get_corpus();
+	const int trials = std::max(options.trials_, 1);
+	bool ok = true;
+
+	std::vector<std::string> families;
+	for (const auto& c : corpus) {
+		if (std::find(families.cbegin(), families.cend(), c.family_) == families.cend()) {
+			families.push_back(c.family_);
+		}
+	}
+
+	for (const auto& name : options.configs_) {
+		const auto& configs = get_configs();
+		if (std::none_of(configs.cbegin(), configs.cend(), [&](const suite_config& c) { return c.name_ == name; })) {
+			os << "ERROR: unknown configuration " << name << "\n";
+			return false;
+		}
+	}
+
+	suite_results results;
+
+	os << "Benchmark suite: " << corpus.size() << " graphs, " << trials << " trials\n";
+	os << std::left << std::setw(24) << "config/family" << std::right << std::setw(8) << "graphs"
+		<< std::setw(12) << "median ms" << std::setw(12) << "p95 ms" << std::setw(12) << "Mnodes/s"
+		<< std::setw(12) << "solves/s" << "\n";
+
+	for (const auto& config : get_configs()) {
+		if (!options.configs_.empty() &&
+			std::find(options.configs_.cbegin(), options.configs_.cend(), config.name_) == options.configs_.cend()) {
+			continue;
+		}
+
+		std::map<std::string, std::vector<trial_sample>> samples;
+		std::map<std::string, int> sizes;
+
+		for (int trial = 0; trial < trials; ++trial) {
+			const outcome_solver solve = make_solver(config.options_);
+			std::map<std::string, trial_sample> sums;
+
+			for (const auto& c : corpus) {
+				const graph g = read_graph6(c.graph6_);
+				if (g.num_vertices() > static_cast<index_t>(config.max_vertices_)) {
+					continue;
+				}
+
+				search_counters counters;
+				std::vector<solve_record> solves;
+
+				const auto t1 = std::chrono::steady_clock::now();
+				const int k = game_chromatic_number(g, solve, counters, solves);
+				const auto t2 = std::chrono::steady_clock::now();
+
+				if (k != c.k_) {
+					os << "WRONG " << config.name_ << " " << c.graph6_ << ": " << k << " instead of " << c.k_ << "\n";
+					ok = false;
+				}
+
+				trial_sample& s = sums[c.family_];
+				s.seconds_ += std::chrono::duration<double>(t2 - t1).count();
+				s.nodes_ += counters.nodes_ + counters.tablebase_states_;
+				s.solves_ += solves.size();
+
+				if (trial == 0) {
+					++sizes[c.family_];
+				}
+			}
+
+			for (const auto& [family, s] : sums) {
+				samples[family].push_back(s);
+			}
+		}
+
+		for (const auto& family : families) {
+			if (samples[family].empty()) {
+				continue;
+			}
+
+			const std::string key = config.name_ + "/" + family;
+			const suite_result r = summarize(samples[family]);
+			results[key] = r;
+
+			os << std::left << std::setw(24) << key << std::right << std::setw(8) << sizes[family] << std::fixed
+				<< std::setprecision(2) << std::setw(12) << r.median_ms_ << std::setw(12) << r.p95_ms_
+				<< std::setw(12) << r.nodes_per_sec_ / 1e6 << std::setprecision(0) << std::setw(12) << r.solves_per_sec_
+				<< "\n";
+		}
+	}
+
+	if (!options.baseline_.empty()) {
+		std::ifstream in(options.baseline_);
+		suite_results baseline;
+
+		if (!in || !read_suite_results(in, baseline)) {
+			os << "ERROR: could not read the baseline " << options.baseline_ << "\n";
+			ok = false;
+		}
+		else {
+			const auto regressions = find_regressions(baseline, results, options.threshold_);
+
+			for (const auto& key : regressions) {
+				os << "REGRESSION " << key << ": median " << std::setprecision(2) << baseline.at(key).median_ms_
+					<< " ms -> " << results.at(key).median_ms_ << " ms\n";
+			}
+
+			os << regressions.size() << " regressions beyond " << std::setprecision(0) << 100 * options.threshold_
+				<< "% against " << options.baseline_ << "\n";
+			ok = ok && regressions.empty();
+		}
+	}
+
+	if (!options.save_.empty()) {
+		std::ofstream out(options.save_, std::ios::trunc);
+		write_suite_results(results, out);
+	}
+
+	return ok;
+}
+
+void write_suite_results(const suite_results& results, std::ostream& os) {
+	os << "{\n" << std::setprecision(6);
+
+	std::size_t i = 0;
+	for (const auto& [key, r] : results) {
+		os << "  \"" << key << "\": {\"median_ms\": " << r.median_ms_ << ", \"p95_ms\": " << r.p95_ms_
+			<< ", \"nodes_per_sec\": " << r.nodes_per_sec_ << ", \"solves_per_sec\": " << r.solves_per_sec_ << "}"
+			<< (++i < results.size() ? "," : "") << "\n";
+	}
+
+	os << "}\n";
+}
+
+bool read_suite_results(std::istream& is, suite_results& results) {
+	std::ostringstream text;
+	text << is.rdbuf();
+	json_reader json(text.str());
+
+	results.clear();
+
+	if (!json.consume('{')) {
+		return false;
+	}
+
+	if (json.consume('}')) {
+		return json.at_end();
+	}
+
+	do {
+		std::string key;
+		suite_result r;
+
+		if (!json.read_string(key) || !json.consume(':') || !json.consume('{')) {
+			return false;
+		}
+
+		do {
+			std::string field;
+			double x = 0;
+
+			if (!json.read_string(field) || !json.consume(':') || !json.read_number(x)) {
+				return false;
+			}
+
+			if (field == "median_ms") {
+				r.median_ms_ = x;
+			}
+			else if (field == "p95_ms") {
+				r.p95_ms_ = x;
+			}
+			else if (field == "nodes_per_sec") {
+				r.nodes_per_sec_ = x;
+			}
+			else if (field == "solves_per_sec") {
+				r.solves_per_sec_ = x;
+			}
+		} while (json.consume(','));
+
+		if (!json.consume('}')) {
+			return false;
+		}
+
+		results[key] = r;
+	} while (json.consume(','));
+
+	return json.consume('}') && json.at_end();
+}
+
+std::vector<std::string> find_regressions(const suite_results& baseline, const suite_results& results, double threshold) {
+	std::vector<std::string> keys;
+
+	for (const auto& [key, r] : results) {
+		const auto it = baseline.find(key);
+		if (it == baseline.cend()) {
+			continue;
+		}
+
+		const double before = it->second.median_ms_;
+
+		if (r.median_ms_ > before * (1 + threshold) && r.median_ms_ - before > SUITE_NOISE_MS) {
+			keys.push_back(key);
+		}
+	}
+
+	return keys;
+}
\ No newline at end of file
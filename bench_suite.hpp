@@ -0,0 +1,71 @@
+#ifndef BENCH_SUITE_HPP
+#define BENCH_SUITE_HPP
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+// A graph of the benchmark corpus with its game chromatic number
+struct corpus_graph {
+	std::string family_;
+	std::string graph6_;
+	int k_;
+};
+
+// Cycles, stars, complete graphs, wheels, outerplanar and planar samples,
+// random graphs and the graphs of the tests, from 5 to 100 vertices. The
+// answers were found by alpha-beta, df-pn and tablebases alike.
+const std::vector<corpus_graph>& get_corpus();
+
+// The timings of one engine configuration on one family: the median and
+// 95th percentile of the time of all trials, and the rates of the median
+// trial. Nodes include the colorings decided by tablebases.
+struct suite_result {
+	double median_ms_{ 0 };
+	double p95_ms_{ 0 };
+	double nodes_per_sec_{ 0 };
+	double solves_per_sec_{ 0 };
+};
+
+// Results by "<config>/<family>"
+typedef std::map<std::string, suite_result> suite_results;
+
+static constexpr double DEFAULT_SUITE_THRESHOLD = 0.15;
+
+// Below this many milliseconds, a slowdown is taken for noise
+static constexpr double SUITE_NOISE_MS = 1.0;
+
+struct suite_options {
+	int trials_{ 5 };
+
+	// Configurations to run, all if empty: alphabeta (without the fixed
+	// kernels), fixed, dfpn and tablebase (graphs of at most 10 vertices)
+	std::vector<std::string> configs_;
+
+	// Baseline to compare with, and file to save the results to; none if
+	// empty
+	std::string baseline_;
+	std::string save_;
+
+	// Largest slowdown of a median that is not a regression
+	double threshold_{ DEFAULT_SUITE_THRESHOLD };
+};
+
+// Solves the corpus trials_ times with every configuration and prints the
+// results, and any regression against the baseline. False if an answer was
+// wrong, the baseline could not be read or something regressed.
+bool run_bench_suite(const suite_options& options, std::ostream& os);
+
+// As JSON, one result per line
+void write_suite_results(const suite_results& results, std::ostream& os);
+
+// Reads what write_suite_results() wrote; false if it is malformed
+bool read_suite_results(std::istream& is, suite_results& results);
+
+// The keys of both whose median grew by more than threshold, and by more
+// than SUITE_NOISE_MS
+std::vector<std::string> find_regressions(const suite_results& baseline, const suite_results& results, double threshold);
+
+#endif
\ No newline at end of file
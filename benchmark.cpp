@@ -0,0 +1,801 @@
+#include "benchmark.hpp"
+#include "graph.hpp"
+#include "graph6.hpp"
+#include "vertex_coloring.hpp"
+#include "bitboard_coloring.hpp"
+#include "game_state.hpp"
+#include "minimax.hpp"
+#include "dfpn.hpp"
+#include "tablebase.hpp"
+#include "fixed_coloring.hpp"
+#include "symmetry.hpp"
+#include "transposition_table.hpp"
+#include "perf_counters.hpp"
+#include "common.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace {
+	struct bench_case {
+		std::string name_;
+		graph g_;
+		int num_cols_;
+		int depth_;
+	};
+
+	// The graphs of test_minimax and a few members of the test families
+	std::vector<bench_case> get_coloring_cases() {
+		return {
+			{ "H?AADrq", read_graph6("H?AADrq"), 3, 6 },
+			{ "H?AADrq", read_graph6("H?AADrq"), 4, 5 },
+			{ "GQz~vk", read_graph6("GQz~vk"), 5, 5 },
+			{ "G?AFCs", read_graph6("G?AFCs"), 4, 5 },
+			{ "C10", get_cycle(10), 3, 5 },
+			{ "K1,9", get_star(10), 3, 5 },
+		};
+	}
+
+	struct family_case {
+		std::string name_;
+		graph g_;
+	};
+
+	std::vector<family_case> get_family_cases() {
+		std::vector<family_case> cases;
+
+		for (int n = 6; n <= 12; n += 2) {
+			cases.push_back({ "C" + std::to_string(n), get_cycle(n) });
+		}
+
+		for (int n = 6; n <= 10; n += 2) {
+			cases.push_back({ "K1," + std::to_string(n - 1), get_star(n) });
+		}
+
+		for (int n = 6; n <= 10; n += 2) {
+			cases.push_back({ "W" + std::to_string(n - 1), get_wheel(n) });
+		}
+
+		for (const auto& s : { "H?AADrq", "GQz~vk", "G?AFCs" }) {
+			cases.push_back({ s, read_graph6(s) });
+		}
+
+		return cases;
+	}
+
+	// Solves for every number of colors up to the game chromatic number
+	int game_chromatic_number(const graph& g, const graph_symmetry* sym, transposition_table& tt, search_counters& counters,
+		const search_options& options = search_options()) {
+		endgame_table endgames;
+
+		for (int k = 1; ; ++k) {
+			bitboard_coloring col(g, k);
+
+			tt.new_search();
+			game_state root(col, &tt, sym);
+			root.ordering_.set_policy(true, options.alice_ordering_);
+			root.ordering_.set_policy(false, options.bob_ordering_);
+			root.safe_reductions_ = options.safe_reductions_;
+			root.bob_threats_ = options.bob_threats_;
+			root.endgame_vertices_ = options.endgame_vertices_;
+			root.endgames_ = &endgames;
+			const bool win = alice_wins(root);
+
+			counters += root.counters_;
+
+			if (win) {
+				return k;
+			}
+		}
+	}
+
+	// Walks the game tree to a fixed depth doing the same per-node work as
+	// minimax(), but without pruning, so both colorings visit the same nodes
+	template <typename Coloring>
+	std::uint64_t walk(Coloring& col, index_t uncols, int depth) {
+		if (col.is_colored() || col.is_deadend() || col.has_conflict() || depth == 0) {
+			return 1;
+		}
+
+		std::uint64_t nodes = 1;
+
+		for (index_t rest = uncols; rest != 0; rest &= rest - 1) {
+			const index_t v = std::countr_zero(rest);
+
+			for (index_t col_mask = col.get_allowed_colors(v); col_mask != 0; col_mask &= col_mask - 1) {
+				const index_t c = std::countr_zero(col_mask);
+
+				col.color_vertex(v, c);
+				nodes += walk(col, uncols & ~(1ULL << v), depth - 1);
+				col.uncolor_vertex(v, c);
+			}
+		}
+
+		return nodes;
+	}
+
+	template <typename Coloring>
+	double time_walk(const bench_case& b, std::uint64_t& nodes) {
+		Coloring col(b.g_, b.num_cols_);
+		const index_t all = ALL_ONES >> (BIT_LEN - b.g_.num_vertices());
+
+		const auto t1 = std::chrono::steady_clock::now();
+		nodes = walk(col, all, b.depth_);
+		const auto t2 = std::chrono::steady_clock::now();
+
+		return std::chrono::duration<double>(t2 - t1).count();
+	}
+
+	// Plays random legal moves, e.g., to reach a middlegame position
+	template <typename Coloring>
+	void play_randomly(Coloring& col, int moves, std::mt19937_64& rng) {
+		for (int i = 0; i < moves; ++i) {
+			std::vector<std::pair<index_t, index_t>> legal;
+			for (index_t v = 0; v < static_cast<index_t>(col.num_vertices()); ++v) {
+				for (index_t cols = col.is_colored(v) ? 0 : col.get_allowed_colors(v); cols != 0; cols &= cols - 1) {
+					legal.emplace_back(v, std::countr_zero(cols));
+				}
+			}
+
+			if (legal.empty()) {
+				return;
+			}
+
+			const auto [v, c] = legal[rng() % legal.size()];
+			col.color_vertex(v, c);
+		}
+	}
+
+	struct op_timing {
+		double ns_per_op_;
+		perf_sample sample_;
+		std::uint64_t ops_;
+	};
+
+	// Times op(i) for i = 0, 1, ..., about 20 ms worth of times. The runs
+	// that find the count also warm up the caches and branch predictors.
+	template <typename Op>
+	op_timing time_op(perf_counters& perf, std::uint64_t& checksum, Op&& op) {
+		std::uint64_t ops = 256;
+
+		for (;;) {
+			const auto t1 = std::chrono::steady_clock::now();
+			for (std::uint64_t i = 0; i < ops; ++i) {
+				checksum += op(i);
+			}
+			const auto t2 = std::chrono::steady_clock::now();
+
+			if (std::chrono::duration<double>(t2 - t1).count() > 0.002) {
+				break;
+			}
+			ops *= 2;
+		}
+
+		ops *= 10;
+
+		perf.start();
+		const auto t1 = std::chrono::steady_clock::now();
+		for (std::uint64_t i = 0; i < ops; ++i) {
+			checksum += op(i);
+		}
+		const auto t2 = std::chrono::steady_clock::now();
+		const perf_sample sample = perf.stop();
+
+		return { std::chrono::duration<double, std::nano>(t2 - t1).count() / ops, sample, ops };
+	}
+
+	void print_op(const std::string& op, const std::string& graph, const op_timing& t) {
+		const auto per_op = [&](PerfEvent e) {
+			std::ostringstream s;
+			if (t.sample_.has(e)) {
+				s << std::fixed << std::setprecision(3) << static_cast<double>(t.sample_.get(e)) / t.ops_;
+			}
+			else {
+				s << "-";
+			}
+			return s.str();
+		};
+
+		std::string ipc = "-";
+		if (t.sample_.has(PerfEvent::Cycles) && t.sample_.has(PerfEvent::Instructions) && t.sample_.get(PerfEvent::Cycles) > 0) {
+			std::ostringstream s;
+			s << std::fixed << std::setprecision(2)
+				<< static_cast<double>(t.sample_.get(PerfEvent::Instructions)) / t.sample_.get(PerfEvent::Cycles);
+			ipc = s.str();
+		}
+
+		std::cout << std::left << std::setw(40) << op << std::setw(10) << graph << std::right << std::fixed
+			<< std::setprecision(2) << std::setw(10) << t.ns_per_op_ << std::setw(8) << ipc << std::setw(12)
+			<< per_op(PerfEvent::Instructions) << std::setw(12) << per_op(PerfEvent::BranchMisses) << std::setw(12)
+			<< per_op(PerfEvent::CacheMisses) << "\n";
+	}
+
+	// The primitives of a coloring in a position halfway through a game
+	template <typename Coloring>
+	void benchmark_coloring_primitives(const std::string& prefix, const std::string& name, const graph& g, int num_cols,
+		perf_counters& perf, std::uint64_t& checksum) {
+		std::mt19937_64 rng(23);
+		Coloring col(g, num_cols);
+		play_randomly(col, g.num_vertices() / 2, rng);
+
+		const index_t n = g.num_vertices();
+		std::vector<std::pair<index_t, index_t>> legal;
+		for (index_t v = 0; v < n; ++v) {
+			for (index_t cols = col.is_colored(v) ? 0 : col.get_allowed_colors(v); cols != 0; cols &= cols - 1) {
+				legal.emplace_back(v, std::countr_zero(cols));
+			}
+		}
+
+		if (!legal.empty()) {
+			print_op(prefix + "color+uncolor_vertex", name, time_op(perf, checksum, [&](std::uint64_t i) {
+				const auto [v, c] = legal[i % legal.size()];
+				col.color_vertex(v, c);
+				const index_t allowed = col.get_allowed_colors(v);
+				col.uncolor_vertex(v, c);
+				return allowed;
+			}));
+		}
+
+		print_op(prefix + "get_allowed_colors", name, time_op(perf, checksum, [&](std::uint64_t i) {
+			return col.get_allowed_colors(i % n);
+		}));
+
+		print_op(prefix + "is_deadend", name, time_op(perf, checksum, [&](std::uint64_t) {
+			return col.is_deadend();
+		}));
+
+		print_op(prefix + "has_conflict", name, time_op(perf, checksum, [&](std::uint64_t) {
+			return col.has_conflict();
+		}));
+	}
+}
+
+void benchmark_all() {
+	benchmark_colorings();
+	benchmark_symmetry();
+	benchmark_ordering();
+	benchmark_engines();
+	benchmark_kernels();
+	benchmark_reductions();
+	benchmark_endgame();
+	benchmark_tablebase();
+	benchmark_cliques();
+	benchmark_graph6();
+	benchmark_primitives();
+}
+
+void benchmark_colorings() {
+	std::cout << "Benchmarking vertex_coloring vs. bitboard_coloring (ns/node)\n";
+	std::cout << std::left << std::setw(10) << "graph" << std::setw(4) << "k" << std::setw(4) << "d"
+		<< std::right << std::setw(12) << "nodes" << std::setw(12) << "vertex"
+		<< std::setw(12) << "bitboard" << std::setw(10) << "speedup" << "\n";
+
+	for (const auto& b : get_coloring_cases()) {
+		std::uint64_t n1 = 0;
+		std::uint64_t n2 = 0;
+		const double t1 = time_walk<vertex_coloring>(b, n1);
+		const double t2 = time_walk<bitboard_coloring>(b, n2);
+
+		if (n1 != n2) {
+			std::cout << "ERROR: node counts differ for " << b.name_ << "\n";
+			continue;
+		}
+
+		std::cout << std::left << std::setw(10) << b.name_ << std::setw(4) << b.num_cols_ << std::setw(4) << b.depth_
+			<< std::right << std::setw(12) << n1
+			<< std::setw(12) << std::fixed << std::setprecision(1) << t1 * 1e9 / n1
+			<< std::setw(12) << t2 * 1e9 / n2
+			<< std::setw(9) << std::setprecision(2) << t1 / t2 << "x\n";
+	}
+}
+
+void benchmark_symmetry() {
+	std::cout << "Benchmarking symmetry pruning (nodes up to the game chromatic number)\n";
+	std::cout << std::left << std::setw(10) << "graph" << std::right << std::setw(10) << "|Aut|"
+		<< std::setw(8) << "orbits" << std::setw(4) << "k" << std::setw(12) << "plain"
+		<< std::setw(12) << "pruned" << std::setw(10) << "by orbit" << std::setw(10) << "by twin" << "\n";
+
+	transposition_table tt;
+
+	for (const auto& f : get_family_cases()) {
+		const graph_symmetry sym(f.g_);
+
+		search_counters plain;
+		search_counters pruned;
+		const int k1 = game_chromatic_number(f.g_, nullptr, tt, plain);
+		const int k2 = game_chromatic_number(f.g_, &sym, tt, pruned);
+
+		if (k1 != k2) {
+			std::cout << "ERROR: results differ for " << f.name_ << "\n";
+			continue;
+		}
+
+		std::cout << std::left << std::setw(10) << f.name_ << std::right
+			<< std::setw(10) << std::setprecision(0) << std::fixed << sym.group_order()
+			<< std::setw(8) << sym.root_orbits().size() << std::setw(4) << k1
+			<< std::setw(12) << plain.nodes_ << std::setw(12) << pruned.nodes_
+			<< std::setw(10) << pruned.orbit_prunes_ << std::setw(10) << pruned.twin_prunes_ << "\n";
+	}
+}
+
+void benchmark_ordering() {
+	const std::vector<Ordering> policies = { Ordering::Natural, Ordering::Static, Ordering::History };
+
+	std::cout << "Benchmarking move ordering (nodes up to the game chromatic number, Alice/Bob policy)\n";
+	std::cout << std::left << std::setw(10) << "graph";
+	for (const auto alice : policies) {
+		for (const auto bob : policies) {
+			std::cout << std::right << std::setw(18) << to_string(alice) + "/" + to_string(bob);
+		}
+	}
+	std::cout << "\n";
+
+	transposition_table tt;
+	std::vector<std::uint64_t> total_nodes(policies.size() * policies.size(), 0);
+	std::vector<double> total_time(total_nodes.size(), 0);
+
+	for (const auto& f : get_family_cases()) {
+		const graph_symmetry sym(f.g_);
+		std::cout << std::left << std::setw(10) << f.name_ << std::right;
+
+		for (std::size_t i = 0; i < total_nodes.size(); ++i) {
+			search_options options;
+			options.alice_ordering_ = policies[i / policies.size()];
+			options.bob_ordering_ = policies[i % policies.size()];
+
+			search_counters counters;
+			const auto t1 = std::chrono::steady_clock::now();
+			game_chromatic_number(f.g_, &sym, tt, counters, options);
+			const auto t2 = std::chrono::steady_clock::now();
+
+			total_nodes[i] += counters.nodes_;
+			total_time[i] += std::chrono::duration<double>(t2 - t1).count();
+			std::cout << std::setw(18) << counters.nodes_;
+		}
+		std::cout << "\n";
+	}
+
+	std::cout << std::left << std::setw(10) << "time (s)" << std::right << std::setprecision(4) << std::fixed;
+	for (const auto t : total_time) {
+		std::cout << std::setw(18) << t;
+	}
+	std::cout << "\n";
+}
+
+void benchmark_engines() {
+	std::cout << "Benchmarking engines (nodes and ms for the last Bob win and the Alice win)\n";
+	std::cout << std::left << std::setw(10) << "graph" << std::right << std::setw(4) << "k"
+		<< std::setw(12) << "ab Bob" << std::setw(12) << "dfpn Bob" << std::setw(12) << "ab Alice" 
+		<< std::setw(12) << "dfpn Alice" << "\n";
+
+	transposition_table tt;
+	pn_table table;
+	std::array<double, 4> total_time{};
+
+	for (const auto& f : get_family_cases()) {
+		const graph_symmetry sym(f.g_);
+		search_counters ignored;
+		const int k = game_chromatic_number(f.g_, &sym, tt, ignored);
+
+		std::cout << std::left << std::setw(10) << f.name_ << std::right << std::setw(4) << k;
+
+		for (int i = 0; i < 4; ++i) {
+			const int num_cols = i < 2 ? k - 1 : k;
+			search_counters counters;
+
+			const auto t1 = std::chrono::steady_clock::now();
+			if (i % 2 == 0) {
+				solve_outcome(f.g_, num_cols, tt, &sym, &counters);
+			}
+			else {
+				solve_outcome_dfpn(f.g_, num_cols, table, &sym, &counters);
+			}
+			const auto t2 = std::chrono::steady_clock::now();
+
+			total_time[i] += std::chrono::duration<double, std::milli>(t2 - t1).count();
+			std::cout << std::setw(12) << counters.nodes_;
+		}
+		std::cout << "\n";
+	}
+
+	std::cout << std::left << std::setw(14) << "time (ms)" << std::right << std::setprecision(3) << std::fixed;
+	for (const auto t : total_time) {
+		std::cout << std::setw(12) << t;
+	}
+	std::cout << "\n";
+}
+
+void benchmark_kernels() {
+	std::cout << "Benchmarking fixed kernels vs. the generic engine (ns/node, up to the game chromatic number)\n";
+	std::cout << std::left << std::setw(10) << "graph" << std::right << std::setw(4) << "k"
+		<< std::setw(12) << "nodes" << std::setw(12) << "generic" << std::setw(12) << "fixed"
+		<< std::setw(10) << "speedup" << "\n";
+
+	transposition_table tt;
+	std::array<double, 2> total_time{};
+	std::uint64_t total_nodes = 0;
+
+	for (const auto& f : get_family_cases()) {
+		const graph_symmetry sym(f.g_);
+		std::array<double, 2> time{};
+		std::array<search_counters, 2> counters;
+		int k = 0;
+
+		for (int fixed = 0; fixed < 2; ++fixed) {
+			search_options options;
+			options.fixed_kernels_ = fixed == 1;
+
+			// The reductions leave too few nodes to time
+			options.safe_reductions_ = false;
+
+			// Both engines start from an empty table, so they search the
+			// same tree; below MIN_FIXED_COLORS both are generic
+			tt.clear();
+			const auto t1 = std::chrono::steady_clock::now();
+			for (k = MIN_FIXED_COLORS; solve_outcome(f.g_, k, tt, &sym, &counters[fixed], options) == Victory::Bob; ++k) {}
+			const auto t2 = std::chrono::steady_clock::now();
+
+			time[fixed] = std::chrono::duration<double>(t2 - t1).count();
+		}
+
+		if (counters[0].nodes_ != counters[1].nodes_) {
+			std::cout << "ERROR: node counts differ for " << f.name_ << "\n";
+			continue;
+		}
+
+		const std::uint64_t nodes = counters[0].nodes_;
+		total_nodes += nodes;
+		total_time[0] += time[0];
+		total_time[1] += time[1];
+
+		std::cout << std::left << std::setw(10) << f.name_ << std::right << std::setw(4) << k
+			<< std::setw(12) << nodes << std::fixed << std::setprecision(1)
+			<< std::setw(12) << time[0] * 1e9 / nodes << std::setw(12) << time[1] * 1e9 / nodes
+			<< std::setw(9) << std::setprecision(2) << time[0] / time[1] << "x\n";
+	}
+
+	std::cout << std::left << std::setw(14) << "total" << std::right << std::setw(12) << total_nodes
+		<< std::fixed << std::setprecision(1) << std::setw(12) << total_time[0] * 1e9 / total_nodes
+		<< std::setw(12) << total_time[1] * 1e9 / total_nodes
+		<< std::setw(9) << std::setprecision(2) << total_time[0] / total_time[1] << "x\n";
+}
+
+void benchmark_reductions() {
+	std::cout << "Benchmarking reductions (nodes and ms up to the game chromatic number: none, safe vertices, and Bob's threats too)\n";
+	std::cout << std::left << std::setw(10) << "graph" << std::right << std::setw(4) << "k"
+		<< std::setw(10) << "plain" << std::setw(10) << "safe" << std::setw(10) << "threats"
+		<< std::setw(10) << "plain ms" << std::setw(10) << "safe ms" << std::setw(10) << "ms"
+		<< std::setw(10) << "by safe" << std::setw(10) << "by tempo" << std::setw(10) << "by threat" << "\n";
+
+	transposition_table tt;
+	std::array<double, 3> total_time{};
+
+	for (const auto& f : get_family_cases()) {
+		const graph_symmetry sym(f.g_);
+		std::array<search_counters, 3> counters;
+		std::array<double, 3> time{};
+		int k = 0;
+
+		for (int level = 0; level < 3; ++level) {
+			search_options options;
+			options.safe_reductions_ = level >= 1;
+			options.bob_threats_ = level >= 2;
+
+			tt.clear();
+			const auto t1 = std::chrono::steady_clock::now();
+			for (k = 1; solve_outcome(f.g_, k, tt, &sym, &counters[level], options) == Victory::Bob; ++k) {}
+			const auto t2 = std::chrono::steady_clock::now();
+
+			time[level] = std::chrono::duration<double, std::milli>(t2 - t1).count();
+			total_time[level] += time[level];
+		}
+
+		const search_counters& all = counters[2];
+		std::cout << std::left << std::setw(10) << f.name_ << std::right << std::setw(4) << k
+			<< std::setw(10) << counters[0].nodes_ << std::setw(10) << counters[1].nodes_ << std::setw(10) << all.nodes_
+			<< std::fixed << std::setprecision(2) << std::setw(10) << time[0] << std::setw(10) << time[1] << std::setw(10) << time[2]
+			<< std::setw(10) << all.safe_wins_ << std::setw(10) << all.tempo_prunes_
+			<< std::setw(10) << all.threat_wins_ + all.threat_prunes_ << "\n";
+	}
+
+	std::cout << std::left << std::setw(44) << "time (ms)" << std::right << std::fixed << std::setprecision(2);
+	for (const auto t : total_time) {
+		std::cout << std::setw(10) << t;
+	}
+	std::cout << "\n";
+}
+
+void benchmark_endgame() {
+	static constexpr std::array<int, 6> CROSSOVERS{ 0, 4, 5, 6, 7, 8 };
+	static constexpr std::size_t BY_DEFAULT = 3;
+	static_assert(CROSSOVERS[BY_DEFAULT] == DEFAULT_ENDGAME_VERTICES);
+
+	std::cout << "Benchmarking the endgame solver (ms up to the game chromatic number, by crossover in uncolored vertices)\n";
+	std::cout << std::left << std::setw(10) << "graph" << std::right << std::setw(4) << "k" << std::setw(10) << "nodes";
+	for (const int vertices : CROSSOVERS) {
+		std::cout << std::setw(9) << vertices;
+	}
+	std::cout << std::setw(10) << "nodes" << std::setw(10) << "endgame" << "\n";
+
+	// The families, and random graphs big enough for the endgames to matter
+	std::vector<family_case> cases = get_family_cases();
+	std::mt19937_64 rng(2024);
+
+	for (int i = 0; i < 4; ++i) {
+		graph g(13);
+		for (int u = 0; u < 13; ++u) {
+			for (int v = u + 1; v < 13; ++v) {
+				if (rng() % 5 == 0) {
+					g.add_edge(u, v);
+				}
+			}
+		}
+		cases.push_back({ "R13-" + std::to_string(i), g });
+	}
+
+	transposition_table tt;
+	std::array<double, CROSSOVERS.size()> total_time{};
+
+	for (const auto& f : cases) {
+		const graph_symmetry sym(f.g_);
+		std::array<search_counters, CROSSOVERS.size()> counters;
+		std::array<double, CROSSOVERS.size()> time{};
+		int k = 0;
+
+		for (std::size_t i = 0; i < CROSSOVERS.size(); ++i) {
+			search_options options;
+			options.endgame_vertices_ = CROSSOVERS[i];
+
+			tt.clear();
+			const auto t1 = std::chrono::steady_clock::now();
+			for (k = 1; solve_outcome(f.g_, k, tt, &sym, &counters[i], options) == Victory::Bob; ++k) {}
+			const auto t2 = std::chrono::steady_clock::now();
+
+			time[i] = std::chrono::duration<double, std::milli>(t2 - t1).count();
+			total_time[i] += time[i];
+		}
+
+		std::cout << std::left << std::setw(10) << f.name_ << std::right << std::setw(4) << k
+			<< std::setw(10) << counters[0].nodes_ << std::fixed << std::setprecision(2);
+		for (const double t : time) {
+			std::cout << std::setw(9) << t;
+		}
+		std::cout << std::setw(10) << counters[BY_DEFAULT].nodes_ << std::setw(10) << counters[BY_DEFAULT].endgame_nodes_ << "\n";
+	}
+
+	std::cout << std::left << std::setw(24) << "time (ms)" << std::right << std::fixed << std::setprecision(2);
+	for (const double t : total_time) {
+		std::cout << std::setw(9) << t;
+	}
+	std::cout << std::setw(9) << std::setprecision(2) << total_time[0] / total_time[BY_DEFAULT] << "x\n";
+}
+
+void benchmark_tablebase() {
+	const int hardware = std::max<int>(std::thread::hardware_concurrency(), 1);
+
+	std::cout << "Benchmarking tablebases (ms; " << hardware << " threads)\n";
+	std::cout << std::left << std::setw(10) << "graph" << std::right << std::setw(4) << "k" << std::setw(10) << "MiB"
+		<< std::setw(12) << "states" << std::setw(12) << "alphabeta" << std::setw(12) << "1 thread"
+		<< std::setw(12) << "threads" << std::setw(12) << "ns/state" << "\n";
+
+	std::mt19937_64 rng(18);
+	std::vector<family_case> cases{ { "C10", get_cycle(10) }, { "W9", get_wheel(10) } };
+
+	for (int i = 0; i < 2; ++i) {
+		graph g(10);
+		for (int u = 0; u < 10; ++u) {
+			for (int v = u + 1; v < 10; ++v) {
+				if (rng() % 3 == 0) {
+					g.add_edge(u, v);
+				}
+			}
+		}
+		cases.push_back({ "R10-" + std::to_string(i), g });
+	}
+
+	transposition_table tt;
+
+	for (const auto& f : cases) {
+		for (const int k : { 3, 4 }) {
+			search_options options;
+			options.tablebase_megabytes_ = 0;
+
+			tt.clear();
+			const auto t1 = std::chrono::steady_clock::now();
+			solve_outcome(f.g_, k, tt, nullptr, nullptr, options);
+			const auto t2 = std::chrono::steady_clock::now();
+
+			search_counters counters;
+			solve_outcome_tablebase(f.g_, k, &counters);
+			const auto t3 = std::chrono::steady_clock::now();
+
+			options.threads_ = hardware;
+			solve_outcome_tablebase(f.g_, k, nullptr, options);
+			const auto t4 = std::chrono::steady_clock::now();
+
+			const double serial = std::chrono::duration<double, std::milli>(t3 - t2).count();
+
+			std::cout << std::left << std::setw(10) << f.name_ << std::right << std::setw(4) << k << std::fixed
+				<< std::setprecision(2) << std::setw(10) << tablebase_bytes(f.g_.num_vertices(), k) / 1048576.0
+				<< std::setw(12) << counters.tablebase_states_
+				<< std::setw(12) << std::chrono::duration<double, std::milli>(t2 - t1).count()
+				<< std::setw(12) << serial
+				<< std::setw(12) << std::chrono::duration<double, std::milli>(t4 - t3).count()
+				<< std::setw(12) << std::setprecision(1) << serial * 1e6 / counters.tablebase_states_ << "\n";
+		}
+	}
+}
+
+void benchmark_cliques() {
+	std::cout << "Benchmarking cliques (ns per graph)\n";
+	std::cout << std::left << std::setw(14) << "graphs" << std::right << std::setw(14) << "triangle"
+		<< std::setw(14) << "K4" << std::setw(14) << "clique number" << "\n";
+
+	std::mt19937_64 rng(20);
+
+	for (const auto& [name, n, density] : { std::tuple{ "n=10", 10, 3 }, std::tuple{ "n=10 dense", 10, 8 },
+		std::tuple{ "n=16", 16, 3 }, std::tuple{ "n=16 dense", 16, 8 }, std::tuple{ "n=32", 32, 3 },
+		std::tuple{ "n=100", 100, 3 } }) {
+		// About density edges per vertex
+		std::vector<graph> graphs;
+		for (int i = 0; i < 2000; ++i) {
+			graph g(n);
+			for (int u = 0; u < n; ++u) {
+				for (int v = u + 1; v < n; ++v) {
+					if (static_cast<int>(rng() % (n - 1)) < density) {
+						g.add_edge(u, v);
+					}
+				}
+			}
+			graphs.push_back(std::move(g));
+		}
+
+		std::array<double, 3> times{};
+		int checksum = 0;
+
+		for (int method = 0; method < 3; ++method) {
+			const auto t1 = std::chrono::steady_clock::now();
+			for (const auto& g : graphs) {
+				checksum += method == 0 ? has_triangle(g) : (method == 1 ? has_k_four(g) : clique_number(g));
+			}
+			const auto t2 = std::chrono::steady_clock::now();
+
+			times[method] = std::chrono::duration<double, std::nano>(t2 - t1).count() / graphs.size();
+		}
+
+		std::cout << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(0)
+			<< std::setw(14) << times[0] << std::setw(14) << times[1] << std::setw(14) << times[2]
+			<< "    (" << checksum << ")\n";
+	}
+}
+
+void benchmark_graph6() {
+	static constexpr std::size_t NUM_LINES = 200000;
+	static constexpr std::size_t CHUNK = 1024;
+
+	std::cout << "Benchmarking graph6 decoding (million graphs/s)\n";
+	std::cout << std::left << std::setw(14) << "lines" << std::right << std::setw(14) << "read_graph6"
+		<< std::setw(14) << "decode" << std::setw(14) << "batch" << "\n";
+
+	std::mt19937_64 rng(12345);
+
+	for (const auto& [name, n, digraph] : { std::tuple{ "n=11", 11, false }, std::tuple{ "n=11 &", 11, true },
+		std::tuple{ "n=32", 32, false }, std::tuple{ "n=64", 64, false } }) {
+		// Random graphs with about three edges per vertex, as in the families
+		std::vector<std::string> lines;
+		for (std::size_t i = 0; i < NUM_LINES / (n > 11 ? 8 : 1); ++i) {
+			graph g(n);
+			for (int u = 0; u < n; ++u) {
+				for (int v = u + 1; v < n; ++v) {
+					if (rng() % (n - 1) < 6) {
+						g.add_edge(u, v);
+					}
+				}
+			}
+			lines.push_back(to_graph6(g, digraph));
+		}
+
+		const std::vector<std::string_view> views(lines.cbegin(), lines.cend());
+		std::array<double, 3> rates{};
+		index_t checksum[3] = {};
+
+		for (int method = 0; method < 3; ++method) {
+			graph6_batch batch;
+			index_t rows[MAX_GRAPH6_VERTICES];
+
+			const auto t1 = std::chrono::steady_clock::now();
+			if (method == 0) {
+				for (const auto& line : views) {
+					checksum[0] += read_graph6(line).get_neighbors(1);
+				}
+			}
+			else if (method == 1) {
+				for (const auto& line : views) {
+					decode_graph6(line, rows);
+					checksum[1] += rows[1];
+				}
+			}
+			else {
+				for (std::size_t i = 0; i < views.size(); i += CHUNK) {
+					const std::size_t count = std::min(CHUNK, views.size() - i);
+					batch.decode(views.data() + i, count);
+
+					for (std::size_t j = 0; j < count; ++j) {
+						checksum[2] += batch.rows(j)[1];
+					}
+				}
+			}
+			const auto t2 = std::chrono::steady_clock::now();
+
+			rates[method] = views.size() / std::chrono::duration<double>(t2 - t1).count() / 1e6;
+		}
+
+		if (checksum[0] != checksum[1] || checksum[1] != checksum[2]) {
+			std::cout << "ERROR: decoders differ for " << name << "\n";
+			continue;
+		}
+
+		std::cout << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(2);
+		for (const double rate : rates) {
+			std::cout << std::setw(14) << rate;
+		}
+		std::cout << "\n";
+	}
+}
+
+void benchmark_primitives() {
+	perf_counters perf;
+
+	std::cout << "Benchmarking primitives (per operation)\n";
+	if (!perf.available()) {
+		std::cout << "Hardware counters unavailable, timing only (" << perf.error() << ")\n";
+	}
+	else if (!perf.error().empty()) {
+		std::cout << "Some hardware counters unavailable (" << perf.error() << ")\n";
+	}
+
+	std::cout << std::left << std::setw(40) << "operation" << std::setw(10) << "graph" << std::right << std::setw(10)
+		<< "ns" << std::setw(8) << "IPC" << std::setw(12) << "instrs" << std::setw(12) << "br-misses" << std::setw(12)
+		<< "c-misses" << "\n";
+
+	std::mt19937_64 rng(21);
+	std::uint64_t checksum = 0;
+
+	for (const auto& [name, n, num_cols] : { std::tuple{ "n=9", 9, 3 }, std::tuple{ "n=32", 32, 4 },
+		std::tuple{ "n=64", 64, 5 } }) {
+		// H?AADrq, and random graphs with about three edges per vertex
+		graph g = n == 9 ? read_graph6("H?AADrq") : graph(n);
+		for (int u = 0; n != 9 && u < n; ++u) {
+			for (int v = u + 1; v < n; ++v) {
+				if (rng() % (n - 1) < 3) {
+					g.add_edge(u, v);
+				}
+			}
+		}
+
+		benchmark_coloring_primitives<vertex_coloring>("vertex_coloring::", name, g, num_cols, perf, checksum);
+		benchmark_coloring_primitives<bitboard_coloring>("bitboard_coloring::", name, g, num_cols, perf, checksum);
+
+		const std::string line = to_graph6(g);
+		print_op("read_graph6", name, time_op(perf, checksum, [&](std::uint64_t) {
+			return read_graph6(line).num_edges();
+		}));
+
+		print_op("has_k_four", name, time_op(perf, checksum, [&](std::uint64_t) {
+			return has_k_four(g);
+		}));
+	}
+
+	std::cout << "(" << checksum << ")\n";
+}
\ No newline at end of file
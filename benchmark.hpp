@@ -0,0 +1,31 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+void benchmark_all();
+
+void benchmark_colorings();
+
+void benchmark_symmetry();
+
+void benchmark_ordering();
+
+void benchmark_engines();
+
+void benchmark_kernels();
+
+void benchmark_reductions();
+
+void benchmark_endgame();
+
+void benchmark_tablebase();
+
+void benchmark_cliques();
+
+void benchmark_graph6();
+
+// Time per operation of the primitives of the search, with the IPC,
+// instructions, branch misses and cache misses per operation where the
+// hardware counters can be read
+void benchmark_primitives();
+
+#endif
\ No newline at end of file
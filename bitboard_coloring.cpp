@@ -0,0 +1,217 @@
+#include "bitboard_coloring.hpp"
+
+#include "reductions.hpp"
+#include "zobrist.hpp"
+
+#include <bitset>
+#include <iostream>
+
+void bitboard_coloring::color_vertex(index_t u, index_t c) {
+	assert(u < g_.num_vertices());
+	assert(c < static_cast<index_t>(num_cols_));
+	assert(!is_colored(u));
+
+	undo_[colored_vertices_++] = attack_[c];
+	attack_[c] |= g_.get_neighbors(u);
+	class_[c] |= 1ULL << u;
+	uncolored_ &= ~(1ULL << u);
+	hash_ ^= zobrist_key(u, c);
+
+	assert(is_colored(u, c));
+}
+
+void bitboard_coloring::uncolor_vertex(index_t u, index_t c) {
+	assert(u < g_.num_vertices());
+	assert(c < static_cast<index_t>(num_cols_));
+	assert(is_colored(u, c));
+	assert(colored_vertices_ > 0);
+
+	attack_[c] = undo_[--colored_vertices_];
+	class_[c] &= ~(1ULL << u);
+	uncolored_ |= 1ULL << u;
+	hash_ ^= zobrist_key(u, c);
+
+	assert(!is_colored(u));
+}
+
+index_t bitboard_coloring::get_color(index_t u) const {
+	assert(is_colored(u));
+
+	for (int c = 0; c < num_cols_; ++c) {
+		if ((class_[c] >> u) & 1ULL) {
+			return c;
+		}
+	}
+
+	return num_cols_;
+}
+
+index_t bitboard_coloring::get_allowed_colors(index_t u) const {
+	assert(u < g_.num_vertices());
+
+	// Gather bit u of every attack mask
+	index_t allowed = 0;
+	for (int c = 0; c < num_cols_; ++c) {
+		allowed |= ((~attack_[c] >> u) & 1ULL) << c;
+	}
+
+	return allowed;
+}
+
+bool bitboard_coloring::has_free_color(index_t u) const {
+	return get_allowed_colors(u) != 0;
+}
+
+int bitboard_coloring::num_colored_vertices() const {
+	return colored_vertices_;
+}
+
+int bitboard_coloring::num_vertices() const {
+	return g_.num_vertices();
+}
+
+int bitboard_coloring::num_colors() const {
+	return num_cols_;
+}
+
+bool bitboard_coloring::is_colored() const {
+	return uncolored_ == 0;
+}
+
+bool bitboard_coloring::is_colored(index_t u, index_t c) const {
+	return (class_[c] >> u) & 1ULL;
+}
+
+bool bitboard_coloring::is_colored(index_t u) const {
+	return !((uncolored_ >> u) & 1ULL);
+}
+
+bool bitboard_coloring::is_allowed(index_t u, index_t c) const {
+	return !((attack_[c] >> u) & 1ULL);
+}
+
+bool bitboard_coloring::is_deadend() const {
+	// An uncolored vertex attacked in every color
+	index_t dead = uncolored_;
+	for (int c = 0; c < num_cols_ && dead != 0; ++c) {
+		dead &= attack_[c];
+	}
+
+	return dead != 0;
+}
+
+bool bitboard_coloring::has_conflict() const {
+	for (int c = 0; c < num_cols_; ++c) {
+		if (class_[c] & attack_[c]) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool bitboard_coloring::neighbor_has_color(index_t u, index_t c) const {
+	return (attack_[c] >> u) & 1ULL;
+}
+
+index_t bitboard_coloring::representative_colors() const {
+	// Colored vertices never change again, so the rest of the game only
+	// depends on which uncolored vertices each color is blocked at. Colors
+	// blocked at the same uncolored vertices (e.g., all unused colors) are
+	// interchangeable for both players, and only the lowest one is kept.
+	index_t reps = 0;
+	std::array<index_t, BIT_LEN> seen;
+	int num_seen = 0;
+
+	for (int c = 0; c < num_cols_; ++c) {
+		const index_t blocked = attack_[c] & uncolored_;
+		bool equivalent = false;
+
+		for (int i = 0; i < num_seen && !equivalent; ++i) {
+			equivalent = seen[i] == blocked;
+		}
+
+		if (!equivalent) {
+			seen[num_seen++] = blocked;
+			reps |= 1ULL << c;
+		}
+	}
+
+	return reps;
+}
+
+index_t bitboard_coloring::safe_vertices() const {
+	const auto rows = [this](int u) { return row(u); };
+	const auto allowed = [this](int u) { return get_allowed_colors(u); };
+
+	return ::safe_vertices(row_set(uncolored_), rows, allowed).words_[0];
+}
+
+index_t bitboard_coloring::tempo_vertices(index_t safe) const {
+	const auto rows = [this](int u) { return row(u); };
+	return ::tempo_vertices(row_set(uncolored_), row_set(safe), rows).words_[0];
+}
+
+bool bitboard_coloring::has_bob_threat() const {
+	const auto rows = [this](int u) { return row(u); };
+	const auto attacked = [this](int c) { return row_set(attack_[c]); };
+
+	return ::has_bob_threat(row_set(uncolored_), num_cols_, rows, attacked);
+}
+
+index_t bitboard_coloring::threat_defusers() const {
+	const auto rows = [this](int u) { return row(u); };
+	const auto attacked = [this](int c) { return row_set(attack_[c]); };
+
+	return ::threat_defusers(row_set(uncolored_), num_cols_, rows, attacked).words_[0];
+}
+
+endgame bitboard_coloring::get_endgame() const {
+	const auto rows = [this](int u) { return row(u); };
+	const auto allowed = [this](int u) { return get_allowed_colors(u); };
+
+	return make_endgame(row_set(uncolored_), rows, allowed);
+}
+
+wide_bitset<1> bitboard_coloring::row_set(index_t mask) {
+	return wide_bitset<1>::from_words(&mask);
+}
+
+wide_bitset<1> bitboard_coloring::row(int u) const {
+	return row_set(g_.get_neighbors(u));
+}
+
+const graph& bitboard_coloring::get_graph() const {
+	return g_;
+}
+
+index_t bitboard_coloring::uncolored() const {
+	return uncolored_;
+}
+
+index_t bitboard_coloring::attacked(index_t c) const {
+	assert(c < static_cast<index_t>(num_cols_));
+	return attack_[c];
+}
+
+index_t bitboard_coloring::color_class(index_t c) const {
+	assert(c < static_cast<index_t>(num_cols_));
+	return class_[c];
+}
+
+std::size_t bitboard_coloring::zobrist_hash() const {
+	return hash_;
+}
+
+void bitboard_coloring::print() const {
+	for (index_t i = 0; i < g_.num_vertices(); ++i) {
+		if (!is_colored(i))
+			std::cout << "c(" << i << ") = UNASSIGNED\n";
+		else
+			std::cout << "c(" << i << ") = " << get_color(i) << "\n";
+	}
+
+	for (int c = 0; c < num_cols_; ++c) {
+		std::cout << "attack_[" << c << "] = " << std::bitset<BIT_LEN>(attack_[c]) << "\n";
+	}
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#ifndef BITBOARD_COLORING_HPP
+#define BITBOARD_COLORING_HPP
+
+#include "common.hpp"
+#include "endgame.hpp"
+#include "graph.hpp"
+
+#include <array>
+#include <cassert>
+
+// A vertex coloring kept as bitboards: one mask of vertices per color, one
+// mask of vertices that have a neighbor of that color, and the uncolored
+// vertices. Terminal tests are a few word operations per color.
+//
+// Unlike vertex_coloring, uncolor_vertex() must undo the most recent
+// color_vertex() that has not been undone yet, as during a search.
+class bitboard_coloring {
+  public:
+    bitboard_coloring(const graph& g, int num_cols)
+        : g_(g),
+        num_cols_(num_cols),
+        uncolored_(ALL_ONES >> (BIT_LEN - g.num_vertices()))
+    {
+        assert(num_cols_ > 0 && num_cols_ < static_cast<int>(BIT_LEN));
+        assert(g.num_vertices() > 0 && g.num_vertices() <= BIT_LEN);
+
+        attack_.fill(0);
+        class_.fill(0);
+    }
+
+    bitboard_coloring(const bitboard_coloring&) = delete;
+    bitboard_coloring& operator=(const bitboard_coloring&) = delete;
+
+    void color_vertex(index_t u, index_t c);
+    void uncolor_vertex(index_t u, index_t c);
+
+    index_t get_color(index_t u) const;
+    index_t get_allowed_colors(index_t u) const;
+    bool has_free_color(index_t u) const;
+
+    int num_colored_vertices() const;
+    int num_vertices() const;
+    int num_colors() const;
+
+    bool is_colored() const;
+    bool is_colored(index_t u, index_t c) const;
+    bool is_colored(index_t u) const;
+
+    bool is_allowed(index_t u, index_t c) const;
+    bool is_deadend() const;
+    bool has_conflict() const;
+    bool neighbor_has_color(index_t u, index_t c) const;
+
+    index_t representative_colors() const;
+
+    // The safe and the tempo vertices, see reductions.hpp
+    index_t safe_vertices() const;
+    index_t tempo_vertices(index_t safe) const;
+
+    // Bob's threats, see reductions.hpp
+    bool has_bob_threat() const;
+    index_t threat_defusers() const;
+
+    // The rest of the game, for the endgame solver
+    endgame get_endgame() const;
+
+    const graph& get_graph() const;
+
+    index_t uncolored() const;
+    index_t attacked(index_t c) const;
+    index_t color_class(index_t c) const;
+
+    std::size_t zobrist_hash() const;
+
+    void print() const;
+
+  private:
+    static wide_bitset<1> row_set(index_t mask);
+    wide_bitset<1> row(int u) const;
+
+    const graph& g_;
+    const int num_cols_;
+    int colored_vertices_{ 0 };
+    index_t uncolored_;
+    index_t hash_{ 0 };
+
+    // attack_[c] holds the vertices with a neighbor colored c
+    std::array<index_t, BIT_LEN> attack_;
+    std::array<index_t, BIT_LEN> class_;
+
+    // attack_[c] before each color_vertex(u, c), in move order
+    std::array<index_t, BIT_LEN> undo_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,138 @@
+#ifndef BITSET_HPP
+#define BITSET_HPP
+
+#include "common.hpp"
+
+#include <array>
+#include <bit>
+#include <cassert>
+
+// Largest graph the engine handles: 8 words of vertices
+static constexpr int MAX_VERTICES = 512;
+
+// Words per bitset of n vertices: 1, 2, 4 or 8
+constexpr int words_for(int n) {
+	return n <= 64 ? 1 : (n <= 128 ? 2 : (n <= 256 ? 4 : 8));
+}
+
+// A set of vertices in a fixed number of 64-bit words. All loops run over
+// the compile-time word count, so the compiler unrolls them. Graphs of up
+// to 64 vertices use plain index_t masks instead.
+template <int Words>
+struct wide_bitset {
+	std::array<index_t, Words> words_{};
+
+	// The first n bits
+	static wide_bitset below(int n) {
+		assert(n >= 0 && n <= 64 * Words);
+
+		wide_bitset b;
+		for (int i = 0; i < Words; ++i) {
+			const int bits = n - 64 * i;
+			b.words_[i] = bits >= 64 ? ALL_ONES : (bits <= 0 ? 0 : ALL_ONES >> (64 - bits));
+		}
+
+		return b;
+	}
+
+	// From the words of a graph row
+	static wide_bitset from_words(const index_t* words) {
+		wide_bitset b;
+		for (int i = 0; i < Words; ++i) {
+			b.words_[i] = words[i];
+		}
+
+		return b;
+	}
+
+	bool test(int u) const {
+		return (words_[u >> 6] >> (u & 63)) & 1ULL;
+	}
+
+	void set(int u) {
+		words_[u >> 6] |= 1ULL << (u & 63);
+	}
+
+	void reset(int u) {
+		words_[u >> 6] &= ~(1ULL << (u & 63));
+	}
+
+	bool any() const {
+		index_t x = 0;
+		for (int i = 0; i < Words; ++i) {
+			x |= words_[i];
+		}
+
+		return x != 0;
+	}
+
+	bool none() const {
+		return !any();
+	}
+
+	int count() const {
+		int c = 0;
+		for (int i = 0; i < Words; ++i) {
+			c += std::popcount(words_[i]);
+		}
+
+		return c;
+	}
+
+	// The smallest element; the set must not be empty
+	int lowest() const {
+		for (int i = 0; i < Words - 1; ++i) {
+			if (words_[i] != 0) {
+				return 64 * i + std::countr_zero(words_[i]);
+			}
+		}
+
+		return 64 * (Words - 1) + std::countr_zero(words_[Words - 1]);
+	}
+
+	// Calls f(u) for every element u in increasing order
+	template <typename F>
+	void for_each(F&& f) const {
+		for (int i = 0; i < Words; ++i) {
+			for (index_t rest = words_[i]; rest != 0; rest &= rest - 1) {
+				f(64 * i + std::countr_zero(rest));
+			}
+		}
+	}
+
+	wide_bitset& operator&=(const wide_bitset& o) {
+		for (int i = 0; i < Words; ++i) {
+			words_[i] &= o.words_[i];
+		}
+		return *this;
+	}
+
+	wide_bitset& operator|=(const wide_bitset& o) {
+		for (int i = 0; i < Words; ++i) {
+			words_[i] |= o.words_[i];
+		}
+		return *this;
+	}
+
+	wide_bitset operator&(const wide_bitset& o) const {
+		wide_bitset b = *this;
+		return b &= o;
+	}
+
+	wide_bitset operator|(const wide_bitset& o) const {
+		wide_bitset b = *this;
+		return b |= o;
+	}
+
+	wide_bitset operator~() const {
+		wide_bitset b;
+		for (int i = 0; i < Words; ++i) {
+			b.words_[i] = ~words_[i];
+		}
+		return b;
+	}
+
+	bool operator==(const wide_bitset& o) const = default;
+};
+
+#endif
\ No newline at end of file
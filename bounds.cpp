@@ -0,0 +1,249 @@
+#include "bounds.hpp"
+
+#include "graph.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace {
+	template <typename F>
+	void for_each_neighbor(const graph& g, int u, F&& f) {
+		const index_t* row = g.row(u);
+
+		for (int i = 0; i < g.num_words(); ++i) {
+			for (index_t rest = row[i]; rest != 0; rest &= rest - 1) {
+				f(64 * i + std::countr_zero(rest));
+			}
+		}
+	}
+
+	// Breadth-first search from every unvisited vertex, giving each vertex
+	// the parity of its distance from the root. Returns the number of
+	// components, and sets bipartite to whether an edge joins equal parities.
+	int search_components(const graph& g, bool& bipartite) {
+		const int n = static_cast<int>(g.num_vertices());
+		std::vector<std::int8_t> side(n, -1);
+		std::vector<int> queue;
+		queue.reserve(n);
+
+		int components = 0;
+		bipartite = true;
+
+		for (int root = 0; root < n; ++root) {
+			if (side[root] != -1) {
+				continue;
+			}
+
+			++components;
+			side[root] = 0;
+			queue.assign(1, root);
+
+			for (std::size_t i = 0; i < queue.size(); ++i) {
+				const int u = queue[i];
+
+				for_each_neighbor(g, u, [&](int v) {
+					if (side[v] == -1) {
+						side[v] = side[u] ^ 1;
+						queue.push_back(v);
+					}
+					else if (side[v] == side[u]) {
+						bipartite = false;
+					}
+				});
+			}
+		}
+
+		return components;
+	}
+
+	int max_degree(const graph& g) {
+		int degree = 0;
+		for (index_t u = 0; u < g.num_vertices(); ++u) {
+			degree = std::max(degree, static_cast<int>(g.get_degree(u)));
+		}
+		return degree;
+	}
+}
+
+game_bounds get_game_bounds(const graph& g) {
+	const int n = static_cast<int>(g.num_vertices());
+	const int delta = max_degree(g);
+	game_bounds b;
+
+	// Alice colors properly as long as every vertex has a free color
+	b.upper_ = delta + 1;
+
+	if (n == 0) {
+		return b;
+	}
+
+	b.lower_ = clique_number(g);
+
+	if (b.lower_ == 2) {
+		bool bipartite = true;
+		search_components(g, bipartite);
+		b.lower_ = bipartite ? 2 : 3;
+	}
+
+	if (delta == 2 && is_cycle(g)) {
+		b.lower_ = b.upper_ = 3;
+	}
+
+	if (b.upper_ > 4 && is_forest(g)) {
+		b.upper_ = 4;
+	}
+
+	if (b.upper_ > 7 && is_outerplanar(g)) {
+		b.upper_ = 7;
+	}
+
+	return b;
+}
+
+bool is_bipartite(const graph& g) {
+	bool bipartite = true;
+	search_components(g, bipartite);
+	return bipartite;
+}
+
+bool is_forest(const graph& g) {
+	bool bipartite = true;
+	const int components = search_components(g, bipartite);
+	return g.num_edges() + components == g.num_vertices();
+}
+
+bool is_cycle(const graph& g) {
+	const int n = static_cast<int>(g.num_vertices());
+
+	if (n < 3 || g.num_edges() != static_cast<index_t>(n)) {
+		return false;
+	}
+
+	for (int u = 0; u < n; ++u) {
+		if (g.get_degree(u) != 2) {
+			return false;
+		}
+	}
+
+	bool bipartite = true;
+	return search_components(g, bipartite) == 1;
+}
+
+// Removes vertices of degree at most 2 until none are left. A vertex of
+// degree 2 is replaced by an edge between its neighbors that stands for
+// the path through it, which must then lie on the outer face. Such a path
+// may join an edge that is a chord, but two of them close a cycle, which
+// must then not lie on any other cycle. Every outerplanar graph has a
+// vertex of degree at most 2, and the reductions keep outerplanarity, so
+// g is outerplanar if and only if it is reduced to nothing.
+bool is_outerplanar(const graph& g) {
+	const int n = static_cast<int>(g.num_vertices());
+
+	if (n >= 2 && g.num_edges() > static_cast<index_t>(2 * n - 3)) {
+		return false;
+	}
+
+	enum : std::uint8_t { NONE, CHORD, PATH, CYCLE };
+
+	std::vector<std::uint8_t> edges(n * n, NONE);
+	std::vector<int> degree(n);
+	std::vector<int> stack;
+
+	for (int u = 0; u < n; ++u) {
+		for_each_neighbor(g, u, [&](int v) { edges[u * n + v] = CHORD; });
+		degree[u] = static_cast<int>(g.get_degree(u));
+
+		if (degree[u] <= 2) {
+			stack.push_back(u);
+		}
+	}
+
+	std::vector<bool> removed(n);
+	int left = n;
+
+	while (!stack.empty()) {
+		const int v = stack.back();
+		stack.pop_back();
+
+		if (removed[v] || degree[v] > 2) {
+			continue;
+		}
+
+		removed[v] = true;
+		--left;
+
+		int nbrs[2];
+		int num_nbrs = 0;
+		bool closed = false;
+
+		for (int u = 0; u < n && num_nbrs < degree[v]; ++u) {
+			if (edges[v * n + u] != NONE) {
+				closed |= edges[v * n + u] == CYCLE;
+				edges[v * n + u] = edges[u * n + v] = NONE;
+				nbrs[num_nbrs++] = u;
+			}
+		}
+
+		if (num_nbrs == 2) {
+			const int a = nbrs[0];
+			const int b = nbrs[1];
+			std::uint8_t path = closed ? CYCLE : PATH;
+			const std::uint8_t old = edges[a * n + b];
+
+			if (old != NONE) {
+				if (old == CYCLE || path == CYCLE) {
+					return false;
+				}
+
+				path = old == CHORD ? PATH : CYCLE;
+			}
+			else {
+				// The edge takes the place of v in both degrees
+				++degree[a];
+				++degree[b];
+			}
+
+			edges[a * n + b] = edges[b * n + a] = path;
+		}
+
+		for (int i = 0; i < num_nbrs; ++i) {
+			if (--degree[nbrs[i]] <= 2) {
+				stack.push_back(nbrs[i]);
+			}
+		}
+	}
+
+	return left == 0;
+}
+
+int degeneracy(const graph& g) {
+	const int n = static_cast<int>(g.num_vertices());
+	std::vector<int> degree(n);
+	std::vector<bool> removed(n, false);
+
+	for (int u = 0; u < n; ++u) {
+		degree[u] = static_cast<int>(g.get_degree(u));
+	}
+
+	int result = 0;
+
+	for (int i = 0; i < n; ++i) {
+		int u = -1;
+		for (int v = 0; v < n; ++v) {
+			if (!removed[v] && (u == -1 || degree[v] < degree[u])) {
+				u = v;
+			}
+		}
+
+		result = std::max(result, degree[u]);
+		removed[u] = true;
+
+		for_each_neighbor(g, u, [&](int v) {
+			--degree[v];
+		});
+	}
+
+	return result;
+}
\ No newline at end of file
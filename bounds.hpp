@@ -0,0 +1,35 @@
+#ifndef BOUNDS_HPP
+#define BOUNDS_HPP
+
+class graph;
+
+// An interval holding the game chromatic number of a graph, from its
+// structure alone
+struct game_bounds {
+	// Bob wins with fewer colors
+	int lower_{ 1 };
+
+	// Alice wins with this many colors, and with any more
+	int upper_{ 1 };
+};
+
+// Below from the clique number and odd cycles, above from Delta + 1 and the
+// known results for cycles (3), forests (4, Faigle et al.) and outerplanar
+// graphs (7, Guan and Zhu)
+game_bounds get_game_bounds(const graph& g);
+
+// Whether g has no odd cycle
+bool is_bipartite(const graph& g);
+
+bool is_forest(const graph& g);
+
+// Whether g is a single cycle through all of its vertices
+bool is_cycle(const graph& g);
+
+bool is_outerplanar(const graph& g);
+
+// The largest minimum degree of a subgraph, found by removing a vertex of
+// least degree until none is left
+int degeneracy(const graph& g);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,340 @@
+#include "dfpn.hpp"
+
+#include "bitboard_coloring.hpp"
+#include "symmetry.hpp"
+#include "wide_search.hpp"
+#include "zobrist.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <utility>
+
+namespace {
+	// Only solved nodes reach PN_INFINITY. Sums of unsolved numbers stop
+	// below it, as positions reached by several move orders are counted
+	// more than once.
+	std::uint32_t saturating_add(std::uint32_t a, std::uint32_t b) {
+		if (a >= PN_INFINITY || b >= PN_INFINITY) {
+			return PN_INFINITY;
+		}
+
+		return std::min(a + b, PN_INFINITY - 1);
+	}
+
+	// Numbers seen from the player to move: phi is the cost of proving that
+	// they win and delta the cost of proving that they lose. At Alice's nodes
+	// phi is the proof number, at Bob's the disproof number.
+	struct child {
+		move move_;
+		index_t key_;
+		std::uint32_t phi_;
+		std::uint32_t delta_;
+	};
+
+	class dfpn_search {
+	  public:
+		dfpn_search(game_state& node, pn_table& table)
+			: node_(node), table_(table), children_(node.col_.num_vertices() + 1) { }
+
+		// Searches below the current, non-terminal node until its phi reaches
+		// phi_th or its delta reaches delta_th, and returns both
+		std::pair<std::uint32_t, std::uint32_t> mid(std::uint32_t phi_th, std::uint32_t delta_th) {
+			node_.counters_.count_node();
+
+			bitboard_coloring& col = node_.col_;
+			const int ply = col.num_colored_vertices();
+			node_.counters_.record_node(ply);
+			const index_t key = col.zobrist_hash();
+			auto& kids = children_[ply];
+
+			expand(kids, key, ply + 1);
+
+			std::uint32_t phi = PN_INFINITY;
+			std::uint32_t delta = 0;
+
+			for (;;) {
+				// The child that is cheapest to prove lost, and the runner-up
+				std::size_t best = 0;
+				std::uint32_t second = PN_INFINITY;
+				phi = PN_INFINITY;
+				delta = 0;
+
+				for (std::size_t i = 0; i < kids.size(); ++i) {
+					if (kids[i].delta_ < phi) {
+						second = phi;
+						phi = kids[i].delta_;
+						best = i;
+					}
+					else if (kids[i].delta_ < second) {
+						second = kids[i].delta_;
+					}
+
+					delta = saturating_add(delta, kids[i].phi_);
+				}
+
+				if (phi >= phi_th || delta >= delta_th) {
+					break;
+				}
+
+				// The 1 + epsilon trick (Pawlewicz and Lew): stay with the best
+				// child until it is a quarter worse than the runner-up, rather
+				// than just worse, which avoids switching back and forth
+				child& c = kids[best];
+				const std::uint32_t child_phi_th = delta_th - delta + c.phi_;
+				const std::uint32_t child_delta_th = std::min<std::uint64_t>(phi_th, second + second / 4 + 1);
+
+				col.color_vertex(c.move_.vertex_, c.move_.color_);
+				node_.remove(c.move_.vertex_);
+
+				std::tie(c.phi_, c.delta_) = mid(child_phi_th, child_delta_th);
+
+				col.uncolor_vertex(c.move_.vertex_, c.move_.color_);
+				node_.add(c.move_.vertex_);
+			}
+
+			store(key, ply, phi, delta);
+			return { phi, delta };
+		}
+
+	  private:
+		// The children of the current node with their numbers: exact for
+		// terminal children and small endgames, from the table if present,
+		// and otherwise growing with the rank given by the move ordering
+		void expand(std::vector<child>& kids, index_t key, int child_ply) {
+			bitboard_coloring& col = node_.col_;
+			const bool alice_child = child_ply % 2 == 0;
+			index_t defusers = ALL_ONES;
+			kids.clear();
+
+			// A node lost to a threat is never expanded, so Alice has some
+			// defusers here
+			if (!alice_child) {
+				node_.is_threat_win(defusers);
+			}
+
+			for (const move m : node_.generate_moves(move(), defusers)) {
+				child c{ m, key ^ zobrist_key(m.vertex_, m.color_), 1, 1 };
+
+				col.color_vertex(m.vertex_, m.color_);
+
+				const bool deadend = col.is_deadend();
+				const bool alice_won = !deadend && (col.is_colored() || node_.is_safe_win());
+				index_t ignored = ALL_ONES;
+
+				if (alice_won || deadend || node_.is_threat_win(ignored)) {
+					if (deadend || col.is_colored()) {
+						node_.counters_.record_terminal();
+					}
+
+					// Alice wins exactly when the coloring is, or will be,
+					// complete
+					const bool mover_wins = alice_won == alice_child;
+					c.phi_ = mover_wins ? 0 : PN_INFINITY;
+					c.delta_ = mover_wins ? PN_INFINITY : 0;
+				}
+				else if (std::popcount(col.uncolored()) <= DFPN_LEAF_VERTICES) {
+					node_.remove(m.vertex_);
+					const bool mover_wins = alice_wins(node_) == alice_child;
+					node_.add(m.vertex_);
+
+					c.phi_ = mover_wins ? 0 : PN_INFINITY;
+					c.delta_ = mover_wins ? PN_INFINITY : 0;
+				}
+				else {
+					std::uint32_t pn = 0;
+					std::uint32_t dn = 0;
+
+					const bool hit = table_.probe(c.key_, pn, dn);
+					node_.counters_.record_probe(hit);
+
+					if (hit) {
+						c.phi_ = alice_child ? pn : dn;
+						c.delta_ = alice_child ? dn : pn;
+					}
+					else {
+						c.delta_ = 1 + static_cast<std::uint32_t>(kids.size()) * DFPN_RANK_WEIGHT;
+					}
+				}
+
+				col.uncolor_vertex(m.vertex_, m.color_);
+				kids.push_back(c);
+
+				// A child lost for the player to move there needs no siblings
+				if (c.delta_ == 0) {
+					node_.counters_.record_cutoff();
+					kids.front() = c;
+					kids.resize(1);
+					break;
+				}
+			}
+		}
+
+		void store(index_t key, int ply, std::uint32_t phi, std::uint32_t delta) {
+			const bool alice = ply % 2 == 0;
+			table_.store(key, alice ? phi : delta, alice ? delta : phi);
+		}
+
+		game_state& node_;
+		pn_table& table_;
+
+		// Per ply, so the children of a node survive the search below it
+		std::vector<std::vector<child>> children_;
+	};
+}
+
+pn_table::pn_table(std::size_t megabytes) {
+	const std::size_t bytes = std::max<std::size_t>(megabytes, 1) << 20;
+	const std::size_t num_buckets = std::bit_floor(bytes / sizeof(pn_bucket));
+
+	buckets_.resize(num_buckets);
+	mask_ = num_buckets - 1;
+	new_search();
+}
+
+void pn_table::new_search() {
+	index_t state = ++searches_;
+	salt_ = splitmix64(state);
+	++age_;
+}
+
+void pn_table::clear() {
+	std::fill(buckets_.begin(), buckets_.end(), pn_bucket());
+}
+
+bool pn_table::probe(index_t key, std::uint32_t& pn, std::uint32_t& dn) const {
+	key ^= salt_;
+
+	for (const auto& entry : bucket(key).entries_) {
+		if ((entry.pn_ | entry.dn_) != 0 && entry.key_ == key) {
+			pn = entry.pn_;
+			dn = entry.dn_;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void pn_table::store(index_t key, std::uint32_t pn, std::uint32_t dn) {
+	assert((pn | dn) != 0);
+	key ^= salt_;
+
+	// Replace the same position if present, then an empty slot or an entry
+	// of an earlier search, then the unsolved entry with the smallest
+	// numbers, and a solved entry last
+	auto& b = bucket(key);
+	std::size_t victim = PN_BUCKET_SIZE;
+
+	for (std::size_t i = 0; i < PN_BUCKET_SIZE; ++i) {
+		if ((b.entries_[i].pn_ | b.entries_[i].dn_) != 0 && b.entries_[i].key_ == key) {
+			victim = i;
+			break;
+		}
+	}
+
+	if (victim == PN_BUCKET_SIZE) {
+		std::uint64_t victim_score = std::numeric_limits<std::uint64_t>::max();
+
+		for (std::size_t i = 0; i < PN_BUCKET_SIZE; ++i) {
+			const pn_entry& entry = b.entries_[i];
+			const bool stale = (entry.pn_ | entry.dn_) == 0 || b.ages_[i] != age_;
+			const bool solved = entry.pn_ == 0 || entry.dn_ == 0;
+			const std::uint64_t score = stale ? 0 :
+				(solved ? 2ULL * PN_INFINITY + 1 : std::uint64_t(entry.pn_) + entry.dn_);
+
+			if (score < victim_score) {
+				victim_score = score;
+				victim = i;
+			}
+		}
+	}
+
+	b.entries_[victim] = { key, pn, dn };
+	b.ages_[victim] = age_;
+}
+
+std::size_t pn_table::num_entries() const {
+	return buckets_.size() * PN_BUCKET_SIZE;
+}
+
+pn_bucket& pn_table::bucket(index_t key) {
+	return buckets_[key & mask_];
+}
+
+const pn_bucket& pn_table::bucket(index_t key) const {
+	return buckets_[key & mask_];
+}
+
+bool dfpn_alice_wins(game_state& node, pn_table& table) {
+	if (node.col_.is_colored() && !node.col_.has_conflict()) {
+		node.counters_.count_node();
+		node.counters_.record_node(node.col_.num_colored_vertices());
+		node.counters_.record_terminal();
+		return true;
+	}
+
+	if (node.col_.is_deadend() || node.col_.has_conflict()) {
+		node.counters_.count_node();
+		node.counters_.record_node(node.col_.num_colored_vertices());
+		node.counters_.record_terminal();
+		return false;
+	}
+
+	if (node.is_safe_win()) {
+		node.counters_.count_node();
+		node.counters_.record_node(node.col_.num_colored_vertices());
+		return true;
+	}
+
+	index_t defusers = ALL_ONES;
+
+	if (node.is_threat_win(defusers)) {
+		node.counters_.count_node();
+		node.counters_.record_node(node.col_.num_colored_vertices());
+		return false;
+	}
+
+	// With infinite thresholds, the search returns once the root is solved
+	dfpn_search search(node, table);
+	const auto [phi, delta] = search.mid(PN_INFINITY, PN_INFINITY);
+	assert(phi == 0 || delta == 0);
+
+	const bool alice = node.col_.num_colored_vertices() % 2 == 0;
+	return (phi == 0) == alice;
+}
+
+Victory solve_outcome_dfpn(const graph& g, int num_cols, pn_table& table,
+	const graph_symmetry* sym, search_counters* counters, const search_options& options) {
+	// Wider graphs are left to alpha-beta, with a table of the same size
+	if (g.num_vertices() > BIT_LEN) {
+		transposition_table tt(std::max<std::size_t>(table.num_entries() * sizeof(pn_entry) >> 20, 1));
+		return solve_outcome_wide(g, num_cols, tt, counters, options);
+	}
+
+	if (sym == nullptr) {
+		const graph_symmetry own(g);
+		return solve_outcome_dfpn(g, num_cols, table, &own, counters, options);
+	}
+
+	bitboard_coloring col(g, num_cols);
+
+	table.new_search();
+	game_state root(col, nullptr, sym);
+	root.ordering_.set_policy(true, options.alice_ordering_);
+	root.ordering_.set_policy(false, options.bob_ordering_);
+	root.safe_reductions_ = options.safe_reductions_;
+	root.bob_threats_ = options.bob_threats_;
+	root.endgame_vertices_ = options.endgame_vertices_;
+	root.counters_.live_nodes_ = counters != nullptr ? counters->live_nodes_ : nullptr;
+
+	endgame_table endgames;
+	root.endgames_ = &endgames;
+	const bool win = dfpn_alice_wins(root, table);
+
+	if (counters != nullptr) {
+		*counters += root.counters_;
+	}
+
+	return win ? Victory::Alice : Victory::Bob;
+}
\ No newline at end of file
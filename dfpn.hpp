@@ -0,0 +1,85 @@
+#ifndef DFPN_HPP
+#define DFPN_HPP
+
+#include "common.hpp"
+#include "game_state.hpp"
+#include "minimax.hpp"
+#include "transposition_table.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+class graph;
+class graph_symmetry;
+
+// Proof and disproof numbers saturate here; a proven node has pn = 0 and
+// dn = PN_INFINITY, a disproven one the other way around
+static constexpr std::uint32_t PN_INFINITY = 1U << 30;
+
+// Children with at most this many uncolored vertices are solved outright by
+// alice_wins(), which is much cheaper there than expanding them
+static constexpr int DFPN_LEAF_VERTICES = 5;
+
+// An unexpanded child of rank i in the move ordering starts with delta
+// 1 + i * DFPN_RANK_WEIGHT, so the search follows the ordering until the
+// numbers say otherwise (df-pn+ style initialization)
+static constexpr std::uint32_t DFPN_RANK_WEIGHT = 32;
+
+// 16 bytes; an entry with pn = dn = 0 is empty
+struct pn_entry {
+	index_t key_{ 0 };
+	std::uint32_t pn_{ 0 };
+	std::uint32_t dn_{ 0 };
+};
+
+static constexpr std::size_t PN_BUCKET_SIZE = 3;
+
+// The search that stored each entry is kept next to the entries, so that a 
+// bucket still fills one cache line
+struct alignas(64) pn_bucket {
+	std::array<pn_entry, PN_BUCKET_SIZE> entries_;
+	std::array<std::uint8_t, PN_BUCKET_SIZE> ages_{};
+};
+
+// Proof and disproof numbers of the positions met by df-pn, bucketed and
+// salted per search like transposition_table. Solved positions are kept
+// over unsolved ones, and among those the cheapest to recompute goes first.
+class pn_table {
+  public:
+	explicit pn_table(std::size_t megabytes = DEFAULT_TT_MEGABYTES);
+	pn_table(const pn_table&) = delete;
+	pn_table& operator=(const pn_table&) = delete;
+
+	void new_search();
+	void clear();
+
+	bool probe(index_t key, std::uint32_t& pn, std::uint32_t& dn) const;
+	void store(index_t key, std::uint32_t pn, std::uint32_t dn);
+
+	std::size_t num_entries() const;
+
+  private:
+	pn_bucket& bucket(index_t key);
+	const pn_bucket& bucket(index_t key) const;
+
+	std::vector<pn_bucket> buckets_;
+	index_t mask_{ 0 };
+	index_t salt_{ 0 };
+	index_t searches_{ 0 };
+	std::uint8_t age_{ 0 };
+};
+
+// Depth-first proof-number search (Nagai) for whether Alice wins from node.
+// Alice's nodes are OR nodes and Bob's are AND nodes; a proof shows that
+// Alice wins. Children are expanded most-proving first with thresholds, so
+// the narrow forcing lines by which Bob usually wins are followed before
+// wide ones. node.tt_ is not used.
+bool dfpn_alice_wins(game_state& node, pn_table& table);
+
+// As solve_outcome(), with df-pn in place of alpha-beta
+Victory solve_outcome_dfpn(const graph& g, int num_cols, pn_table& table,
+	const graph_symmetry* sym = nullptr, search_counters* counters = nullptr,
+	const search_options& options = search_options());
+
+#endif
\ No newline at end of file
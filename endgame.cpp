@@ -0,0 +1,283 @@
+#include "endgame.hpp"
+
+#include <algorithm>
+
+namespace {
+	// Byte lanes of a word: lane i of a vertex word belongs to local vertex
+	// i, lane c of a color word to color c
+	static constexpr std::uint64_t LOW_BITS = 0x0101010101010101ULL;
+	static constexpr std::uint64_t HIGH_BITS = 0x8080808080808080ULL;
+	static constexpr std::uint64_t LOW_SEVEN = 0x7F7F7F7F7F7F7F7FULL;
+	static constexpr std::uint64_t GATHER = 0x0102040810204080ULL;
+
+	// The lanes of high that have their top bit set, as a byte
+	inline std::uint32_t lane_mask(std::uint64_t high) {
+		return static_cast<std::uint32_t>(((high >> 7) & LOW_BITS) * GATHER >> 56);
+	}
+
+	// Bit i of every lane, as a byte
+	inline std::uint32_t column(std::uint64_t x, int i) {
+		return static_cast<std::uint32_t>(((x >> i) & LOW_BITS) * GATHER >> 56);
+	}
+
+	// The top bit of every nonzero lane
+	inline std::uint64_t nonzero_lanes(std::uint64_t x) {
+		return (((x & LOW_SEVEN) + LOW_SEVEN) | x) & HIGH_BITS;
+	}
+
+	// The lanes i with bit i of mask set, as 0x01
+	inline std::uint64_t spread(std::uint32_t mask) {
+		return nonzero_lanes((mask * LOW_BITS) & 0x8040201008040201ULL) >> 7;
+	}
+
+	// The number of ones in every lane
+	inline std::uint64_t lane_counts(std::uint64_t x) {
+		x -= (x >> 1) & 0x5555555555555555ULL;
+		x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+		return (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	}
+
+	// The 8 x 8 bit matrix with lanes as rows, transposed
+	inline std::uint64_t transpose(std::uint64_t x) {
+		std::uint64_t t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+		x ^= t ^ (t << 7);
+		t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+		x ^= t ^ (t << 14);
+		t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+		return x ^ t ^ (t << 28);
+	}
+
+	// The lanes where a > b, for lanes of at most 8
+	inline std::uint32_t greater_lanes(std::uint64_t a, std::uint64_t b) {
+		return lane_mask(((a | HIGH_BITS) - b - LOW_BITS) & HIGH_BITS);
+	}
+
+	inline std::uint32_t lowest(std::uint32_t mask) {
+		return mask & (~mask + 1);
+	}
+
+	// Lane c of free_ holds the uncolored vertices where color c is free,
+	// so coloring a vertex is two masks and a position fits in two words
+	struct endgame_state {
+		std::uint64_t free_;
+		std::uint32_t uncols_;
+	};
+
+	class endgame_solver {
+	  public:
+		endgame_solver(const endgame& e, std::uint64_t& nodes, endgame_table* table)
+			: nodes_(nodes), table_(table) {
+			for (int i = 0; i < MAX_ENDGAME_VERTICES; ++i) {
+				adj_[i] = e.adj_[i];
+				rows_ |= static_cast<std::uint64_t>(e.adj_[i]) << (8 * i);
+			}
+		}
+
+		bool alice_wins(const endgame_state& s, bool alice) {
+			++nodes_;
+
+			if (s.uncols_ == 0) {
+				return true;
+			}
+
+			// Free colors and uncolored neighbors of every vertex
+			const std::uint64_t num_free = lane_counts(transpose(s.free_));
+			const std::uint64_t degrees = lane_counts(rows_ & (s.uncols_ * LOW_BITS));
+
+			if ((s.uncols_ & ~lane_mask(nonzero_lanes(num_free))) != 0) {
+				return false;
+			}
+
+			const std::uint32_t safe = s.uncols_ & greater_lanes(num_free, degrees);
+
+			if (safe == s.uncols_) {
+				return true;
+			}
+
+			// Only the edges between uncolored vertices
+			const std::uint64_t rows = rows_ & (s.uncols_ * LOW_BITS) & (spread(s.uncols_) * 0xFF);
+			bool win = false;
+
+			if (table_ != nullptr && table_->probe(s.free_, rows, alice, win)) {
+				return win;
+			}
+
+			win = search(s, alice, num_free, safe);
+
+			if (table_ != nullptr) {
+				table_->store(s.free_, rows, alice, win);
+			}
+
+			return win;
+		}
+
+	  private:
+		// alice_wins() past the terminal tests
+		bool search(const endgame_state& s, bool alice, std::uint64_t num_free, std::uint32_t safe) {
+			// Bob's threats on the vertices with one free color: with Alice
+			// to move, the vertices where she may stop all of them
+			std::uint32_t defusers = s.uncols_;
+
+			for (std::uint32_t rest = s.uncols_ & ~greater_lanes(num_free, LOW_BITS); rest != 0; rest &= rest - 1) {
+				const int v = std::countr_zero(rest);
+				const int c = std::countr_zero(column(s.free_, v));
+				const std::uint32_t killers = adj_[v] & static_cast<std::uint32_t>(s.free_ >> (8 * c) & 0xFF);
+
+				if (killers != 0) {
+					if (!alice) {
+						return false;
+					}
+
+					std::uint32_t region = s.uncols_;
+					for (std::uint32_t k = killers; k != 0; k &= k - 1) {
+						const int w = std::countr_zero(k);
+						region &= adj_[w] | (1U << w);
+					}
+
+					defusers &= region | (1U << v);
+				}
+			}
+
+			if (defusers == 0) {
+				return false;
+			}
+
+			// The lowest tempo vertex stands for all of them, in one color
+			const std::uint32_t tempo = tempo_vertices(s.uncols_, safe);
+			const std::uint32_t vertices = defusers & ((s.uncols_ & ~tempo) | lowest(tempo));
+
+			// Alice first colors the vertices with the fewest free colors, and
+			// Bob the neighbors of those
+			std::array<int, MAX_ENDGAME_VERTICES> order;
+			int num_moves = 0;
+
+			for (std::uint32_t rest = vertices; rest != 0; rest &= rest - 1) {
+				const int i = std::countr_zero(rest);
+				const std::uint64_t nearby = alice ? spread(1U << i) : spread(adj_[i] & s.uncols_);
+				const int key = static_cast<int>(min_lane(num_free | ~(nearby * 0xFF)));
+
+				int j = num_moves++;
+				for (; j > 0 && (order[j - 1] >> 3) > key; --j) {
+					order[j] = order[j - 1];
+				}
+				order[j] = key << 3 | i;
+			}
+
+			// Colors free at the same uncolored vertices are interchangeable
+			const std::uint32_t colors = representative_colors(s.free_);
+
+			for (int m = 0; m < num_moves; ++m) {
+				const int i = order[m] & 7;
+				const std::uint32_t nbrs = adj_[i] & s.uncols_;
+				const std::uint32_t free = column(s.free_, i);
+
+				// Colors free at no uncolored neighbor are interchangeable
+				const std::uint32_t taken = lane_mask(nonzero_lanes(s.free_ & (nbrs * LOW_BITS)));
+				std::uint32_t tried = (tempo >> i & 1) != 0 ? lowest(free) : (free & taken & colors) | lowest(free & ~taken);
+
+				for (; tried != 0; tried &= tried - 1) {
+					const int c = std::countr_zero(tried);
+					const endgame_state child{
+						s.free_ & ~(LOW_BITS << i) & ~(static_cast<std::uint64_t>(nbrs) << (8 * c)),
+						s.uncols_ & ~(1U << i)
+					};
+
+					if (alice_wins(child, !alice) == alice) {
+						return alice;
+					}
+				}
+			}
+
+			return !alice;
+		}
+
+		// As tempo_vertices() in reductions.hpp
+		std::uint32_t tempo_vertices(std::uint32_t uncols, std::uint32_t safe) const {
+			std::uint32_t reached = uncols & ~safe;
+			std::uint32_t frontier = reached;
+
+			while (frontier != 0) {
+				std::uint32_t next = 0;
+				for (; frontier != 0; frontier &= frontier - 1) {
+					next |= adj_[std::countr_zero(frontier)];
+				}
+
+				frontier = next & uncols & ~reached;
+				reached |= frontier;
+			}
+
+			return uncols & ~reached;
+		}
+
+		// The lowest color of every class of colors with equal lanes
+		static std::uint32_t representative_colors(std::uint64_t free) {
+			std::uint64_t repeated = 0;
+
+			for (int shift = 8; shift < 64; shift += 8) {
+				const std::uint64_t diff = free ^ (free << shift);
+				repeated |= ~nonzero_lanes(diff) & (HIGH_BITS << shift);
+			}
+
+			return ~lane_mask(repeated) & 0xFF;
+		}
+
+		// The smallest lane of x
+		static std::uint64_t min_lane(std::uint64_t x) {
+			std::uint64_t low = 0xFF;
+			for (int shift = 0; shift < 64; shift += 8) {
+				low = std::min(low, x >> shift & 0xFF);
+			}
+			return low;
+		}
+
+		std::array<std::uint32_t, MAX_ENDGAME_VERTICES> adj_{};
+		std::uint64_t rows_{ 0 };
+		std::uint64_t& nodes_;
+		endgame_table* table_;
+	};
+}
+
+endgame_table::endgame_table()
+	: entries_(std::size_t(1) << ENDGAME_TABLE_BITS) { }
+
+bool endgame_table::probe(std::uint64_t free, std::uint64_t rows, bool alice, bool& win) const {
+	const entry& e = entries_[index(free, rows)];
+	const int side = alice ? 0 : 1;
+
+	if (e.free_ != free || e.rows_ != rows || (e.results_ >> side & 1) == 0) {
+		return false;
+	}
+
+	win = (e.results_ >> (side + 2) & 1) != 0;
+	return true;
+}
+
+void endgame_table::store(std::uint64_t free, std::uint64_t rows, bool alice, bool win) {
+	entry& e = entries_[index(free, rows)];
+	const int side = alice ? 0 : 1;
+
+	if (e.free_ != free || e.rows_ != rows) {
+		e = entry{ free, rows, 0 };
+	}
+
+	e.results_ |= (1 | static_cast<int>(win) << 2) << side;
+}
+
+std::size_t endgame_table::index(std::uint64_t free, std::uint64_t rows) const {
+	return ((free * 0x9E3779B97F4A7C15ULL) ^ (rows * 0xC2B2AE3D27D4EB4FULL)) >> (64 - ENDGAME_TABLE_BITS);
+}
+
+bool solve_endgame(const endgame& e, bool alice, std::uint64_t& nodes, endgame_table* table) {
+	assert(e.size_ >= 0 && e.size_ <= MAX_ENDGAME_VERTICES);
+
+	std::uint64_t free = 0;
+	for (int i = 0; i < e.size_; ++i) {
+		assert(e.free_[i] < 1ULL << MAX_ENDGAME_COLORS);
+		free |= static_cast<std::uint64_t>(e.free_[i]) << (8 * i);
+	}
+
+	const endgame_state root{ transpose(free), (1U << e.size_) - 1 };
+	endgame_solver solver(e, nodes, table);
+
+	return solver.alice_wins(root, alice);
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#ifndef ENDGAME_HPP
+#define ENDGAME_HPP
+
+#include "common.hpp"
+#include "bitset.hpp"
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+// Largest number of uncolored vertices the endgame solver takes
+static constexpr int MAX_ENDGAME_VERTICES = 8;
+
+// Largest number of colors it takes
+static constexpr int MAX_ENDGAME_COLORS = 8;
+
+// Uncolored vertices at which the engines hand over to it by default
+static constexpr int DEFAULT_ENDGAME_VERTICES = 6;
+
+// Entries of an endgame table, as a power of two
+static constexpr int ENDGAME_TABLE_BITS = 12;
+
+// The rest of a game once few vertices are uncolored. Colored vertices
+// never change again, so all that matters is the graph induced on the
+// uncolored vertices and their free colors. Vertices are renumbered from
+// 0 to size_ - 1, and colors must be below MAX_ENDGAME_COLORS.
+struct endgame {
+	int size_{ 0 };
+	std::array<std::uint8_t, MAX_ENDGAME_VERTICES> adj_{};
+	std::array<index_t, MAX_ENDGAME_VERTICES> free_{};
+};
+
+// Endgames solved before. A position is keyed by its free colors and the
+// graph induced on its uncolored vertices alone, so results carry over
+// between colorings and even graphs. Direct-mapped, for a single thread.
+class endgame_table {
+  public:
+	endgame_table();
+
+	// Whether the result of the position is known; if so, win gets it
+	bool probe(std::uint64_t free, std::uint64_t rows, bool alice, bool& win) const;
+
+	void store(std::uint64_t free, std::uint64_t rows, bool alice, bool win);
+
+  private:
+	struct entry {
+		std::uint64_t free_;
+		std::uint64_t rows_;
+		// Bits 0 and 1: known with Alice and Bob to move; bits 2 and 3:
+		// Alice wins then
+		std::uint8_t results_;
+	};
+
+	std::size_t index(std::uint64_t free, std::uint64_t rows) const;
+
+	std::vector<entry> entries_;
+};
+
+// Whether Alice wins the endgame with the given player to move, using
+// table if given. Every position searched is added to nodes.
+//
+// A position is two words, and the tests on it are a few word operations
+// on all vertices or colors at once, with no move lists. Besides alpha-beta
+// cutoffs, the solver stops at dead, safe and threatened positions and
+// tries one tempo vertex (see reductions.hpp), one color of every class of
+// interchangeable colors, and one color among those that take nothing from
+// an uncolored neighbor.
+bool solve_endgame(const endgame& e, bool alice, std::uint64_t& nodes, endgame_table* table = nullptr);
+
+// The endgame of a coloring with the given uncolored vertices, at most
+// MAX_ENDGAME_VERTICES. rows(u) is the adjacency row of u and allowed(u)
+// its mask of free colors.
+template <int Words, typename Rows, typename Allowed>
+endgame make_endgame(const wide_bitset<Words>& uncols, Rows&& rows, Allowed&& allowed) {
+	std::array<int, MAX_ENDGAME_VERTICES> vertices;
+	endgame e;
+
+	uncols.for_each([&](int u) {
+		assert(e.size_ < MAX_ENDGAME_VERTICES);
+		vertices[e.size_++] = u;
+	});
+
+	for (int i = 0; i < e.size_; ++i) {
+		const auto& row = rows(vertices[i]);
+		e.free_[i] = allowed(vertices[i]);
+
+		for (int j = 0; j < e.size_; ++j) {
+			e.adj_[i] |= static_cast<std::uint8_t>(row.test(vertices[j])) << j;
+		}
+	}
+
+	return e;
+}
+
+#endif
\ No newline at end of file
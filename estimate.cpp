@@ -0,0 +1,131 @@
+#include "estimate.hpp"
+
+#include "bitboard_coloring.hpp"
+#include "bounds.hpp"
+#include "game_state.hpp"
+#include "graph.hpp"
+#include "symmetry.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+	// Coefficients of the model of predict_solve_nodes() for the natural
+	// logarithm of the nodes
+	static constexpr double MODEL_INTERCEPT = 4.24;
+	static constexpr double MODEL_TREE_SIZE = 0.237;
+	static constexpr double MODEL_EDGES = 0.145;
+	static constexpr double MODEL_DEGENERACY = 0.005;
+	static constexpr double MODEL_LOWER = -0.124;
+	static constexpr double MODEL_UPPER = -0.207;
+}
+
+double estimate_tree_size(const graph& g, int num_cols, const graph_symmetry* sym, int probes, std::mt19937_64& rng,
+	const search_options& options) {
+	if (g.num_vertices() > BIT_LEN) {
+		return UNKNOWN_ESTIMATE;
+	}
+
+	bitboard_coloring col(g, num_cols);
+	game_state node(col, nullptr, sym);
+
+	// The order of the moves does not change the estimate
+	node.ordering_.set_policy(true, Ordering::Natural);
+	node.ordering_.set_policy(false, Ordering::Natural);
+	node.safe_reductions_ = options.safe_reductions_;
+	node.bob_threats_ = options.bob_threats_;
+	node.endgame_vertices_ = options.endgame_vertices_;
+
+	std::vector<move> path;
+	double total = 0;
+
+	for (int probe = 0; probe < probes; ++probe) {
+		// Nodes at the ply of the path, were every node on it like the one
+		// on the path
+		double width = 1;
+
+		for (;;) {
+			total += width;
+
+			if (col.is_colored() || col.is_deadend() || col.has_conflict() || node.is_safe_win()) {
+				break;
+			}
+
+			index_t defusers = ALL_ONES;
+
+			if (node.is_threat_win(defusers) || node.is_endgame()) {
+				break;
+			}
+
+			const std::vector<move>& moves = node.generate_moves(move(), defusers);
+
+			if (moves.empty()) {
+				break;
+			}
+
+			width *= static_cast<double>(moves.size());
+
+			const move m = moves[rng() % moves.size()];
+			col.color_vertex(m.vertex_, m.color_);
+			node.remove(m.vertex_);
+			path.push_back(m);
+		}
+
+		for (auto it = path.rbegin(); it != path.rend(); ++it) {
+			col.uncolor_vertex(it->vertex_, it->color_);
+			node.add(it->vertex_);
+		}
+		path.clear();
+	}
+
+	return probes > 0 ? total / probes : 0;
+}
+
+graph_features get_graph_features(const graph& g, int probes, std::mt19937_64& rng) {
+	const game_bounds bounds = get_game_bounds(g);
+
+	if (bounds.lower_ >= bounds.upper_ || g.num_vertices() > BIT_LEN) {
+		return get_graph_features(g, bounds, nullptr, probes, rng);
+	}
+
+	const graph_symmetry sym(g);
+	return get_graph_features(g, bounds, &sym, probes, rng);
+}
+
+graph_features get_graph_features(const graph& g, const game_bounds& bounds, const graph_symmetry* sym, int probes,
+	std::mt19937_64& rng) {
+	graph_features f;
+	f.vertices_ = static_cast<int>(g.num_vertices());
+	f.edges_ = static_cast<int>(g.num_edges());
+	f.degeneracy_ = degeneracy(g);
+	f.lower_ = bounds.lower_;
+	f.upper_ = bounds.upper_;
+
+	if (f.lower_ >= f.upper_) {
+		return f;
+	}
+
+	if (g.num_vertices() > BIT_LEN) {
+		f.tree_size_ = UNKNOWN_ESTIMATE;
+		return f;
+	}
+
+	for (int num_cols = f.lower_; num_cols < f.upper_; ++num_cols) {
+		f.tree_size_ += estimate_tree_size(g, num_cols, sym, probes, rng);
+	}
+
+	return f;
+}
+
+double predict_solve_nodes(const graph_features& f) {
+	if (f.lower_ >= f.upper_) {
+		return 0;
+	}
+
+	if (f.tree_size_ == UNKNOWN_ESTIMATE) {
+		return UNKNOWN_ESTIMATE;
+	}
+
+	return std::exp(MODEL_INTERCEPT + MODEL_TREE_SIZE * std::log(f.tree_size_ + 1) + MODEL_EDGES * f.edges_
+		+ MODEL_DEGENERACY * f.degeneracy_ + MODEL_LOWER * f.lower_ + MODEL_UPPER * f.upper_);
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef ESTIMATE_HPP
+#define ESTIMATE_HPP
+
+#include "minimax.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <random>
+
+class graph;
+class graph_symmetry;
+struct game_bounds;
+
+// Random paths per number of colors in get_graph_features()
+static constexpr int DEFAULT_ESTIMATE_PROBES = 4;
+
+// The estimate of graphs the probes cannot go through, i.e., of more than
+// 64 vertices, which are thus taken for the heaviest
+static constexpr double UNKNOWN_ESTIMATE = std::numeric_limits<double>::infinity();
+
+// Knuth's estimate of the size of the tree alice_wins() searches on g with
+// num_cols colors, were nothing cut off: the mean over random paths from
+// the root, through the moves of game_state::generate_moves() and down to a
+// node it would not expand, of the sum over the plies of the product of the
+// numbers of moves above. Safe wins, threat wins and endgames end a path as
+// they end the search. UNKNOWN_ESTIMATE for more than 64 vertices.
+double estimate_tree_size(const graph& g, int num_cols, const graph_symmetry* sym, int probes, std::mt19937_64& rng,
+	const search_options& options = search_options());
+
+// What the cost of a graph is predicted from
+struct graph_features {
+	int vertices_{ 0 };
+	int edges_{ 0 };
+	int degeneracy_{ 0 };
+
+	// See get_game_bounds()
+	int lower_{ 0 };
+	int upper_{ 0 };
+
+	// The sum of estimate_tree_size() over the numbers of colors
+	// game_chromatic_number() may try, 0 if the bounds meet
+	double tree_size_{ 0 };
+};
+
+graph_features get_graph_features(const graph& g, int probes, std::mt19937_64& rng);
+
+// The same from the bounds of g and, if they do not meet, its symmetries,
+// which a batch worker then keeps for the solve
+graph_features get_graph_features(const graph& g, const game_bounds& bounds, const graph_symmetry* sym, int probes,
+	std::mt19937_64& rng);
+
+// The nodes game_chromatic_number() is predicted to search, endgame
+// positions included: 0 if the bounds meet, UNKNOWN_ESTIMATE if the tree
+// size is, and otherwise a log-linear model of the tree size, the edges,
+// the degeneracy and the bounds. Alpha-beta cuts off most of the tree, and
+// the tree size alone does not tell apart graphs of the same order, hence
+// the other terms. The model was fitted to the nodes of random graphs of
+// 11 vertices and a mix of families of 5 to 64 vertices; the estimate log
+// of run_g6_batch() has what is needed to fit it again.
+double predict_solve_nodes(const graph_features& features);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,111 @@
+#ifndef FIXED_COLORING_HPP
+#define FIXED_COLORING_HPP
+
+#include "common.hpp"
+#include "bitset.hpp"
+#include "zobrist.hpp"
+
+#include <array>
+#include <cassert>
+#include <type_traits>
+#include <utility>
+
+// Numbers of colors with a compiled kernel, see fixed_search.hpp
+static constexpr int MIN_FIXED_COLORS = 3;
+static constexpr int MAX_FIXED_COLORS = 8;
+
+// The masks of bitboard_coloring for K colors and graphs of up to 64 * Words
+// vertices, as a plain value: the color loops have a compile-time trip
+// count and are written out by the compiler, and a child is made by copying
+// its parent and coloring one vertex, so there is nothing to undo. The
+// adjacency rows are kept by the search.
+template <int Words, int K>
+struct fixed_coloring {
+	typedef wide_bitset<Words> bitset;
+
+	// attack_[c] holds the vertices with a neighbor colored c
+	std::array<bitset, K> attack_;
+	std::array<bitset, K> class_;
+	bitset uncolored_;
+	index_t hash_;
+	int colored_vertices_;
+
+	static fixed_coloring empty(int n) {
+		fixed_coloring col{};
+		col.uncolored_ = bitset::below(n);
+		return col;
+	}
+
+	void color_vertex(const bitset& row, int u, int c) {
+		assert(c >= 0 && c < K && uncolored_.test(u) && !attack_[c].test(u));
+
+		attack_[c] |= row;
+		class_[c].set(u);
+		uncolored_.reset(u);
+		++colored_vertices_;
+
+		if constexpr (Words == 1) {
+			hash_ ^= zobrist_key(u, c);
+		}
+		else {
+			hash_ ^= wide_zobrist_key(u, c);
+		}
+	}
+
+	index_t get_allowed_colors(int u) const {
+		return for_colors([&](auto... c) {
+			return ((static_cast<index_t>(!attack_[c].test(u)) << c) | ...);
+		});
+	}
+
+	bool is_colored() const {
+		return uncolored_.none();
+	}
+
+	bool is_deadend() const {
+		// An uncolored vertex attacked in every color
+		return for_colors([&](auto... c) {
+			return (uncolored_ & ... & attack_[c]).any();
+		});
+	}
+
+	// As bitboard_coloring::representative_colors()
+	index_t representative_colors() const {
+		std::array<bitset, K> blocked;
+		index_t reps = 0;
+
+		for_colors([&](auto... c) {
+			((blocked[c] = attack_[c] & uncolored_), ...);
+		});
+
+		for_colors([&](auto... c) {
+			((reps |= static_cast<index_t>(is_first_blocked(blocked, c)) << c), ...);
+		});
+
+		return reps;
+	}
+
+  private:
+	// f(0, 1, ..., K - 1), with the colors as constants
+	template <typename F>
+	static decltype(auto) for_colors(F&& f) {
+		return [&]<std::size_t... C>(std::index_sequence<C...>) {
+			return f(std::integral_constant<int, C>()...);
+		}(std::make_index_sequence<K>());
+	}
+
+	static bool is_first_blocked(const std::array<bitset, K>& blocked, int c) {
+		for (int d = 0; d < c; ++d) {
+			if (blocked[d] == blocked[c]) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+};
+
+static_assert(std::is_trivially_copyable_v<fixed_coloring<1, MAX_FIXED_COLORS>>);
+static_assert(std::is_standard_layout_v<fixed_coloring<1, MAX_FIXED_COLORS>>);
+
+#endif
\ No newline at end of file
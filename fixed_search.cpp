@@ -0,0 +1,491 @@
+#include "fixed_search.hpp"
+
+#include "endgame.hpp"
+#include "fixed_coloring.hpp"
+#include "graph.hpp"
+#include "reductions.hpp"
+#include "symmetry.hpp"
+#include "transposition_table.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace {
+	// Table depths are 8 bits
+	static constexpr int MAX_TT_DEPTH = 255;
+
+	static constexpr int NUM_FIXED_COLORS = MAX_FIXED_COLORS - MIN_FIXED_COLORS + 1;
+
+	// Every kernel hands its endgames over
+	static_assert(MAX_FIXED_COLORS <= MAX_ENDGAME_COLORS);
+
+	template <int Words, int K>
+	class fixed_search {
+	  public:
+		typedef fixed_coloring<Words, K> coloring;
+		typedef wide_bitset<Words> bitset;
+
+		fixed_search(const graph& g, transposition_table& tt, const graph_symmetry* sym, const search_options& options, int rotation = 0)
+			: n_(g.num_vertices()),
+			tt_(tt),
+			sym_(sym),
+			options_(options),
+			rotation_(rotation),
+			endgame_vertices_(std::min(options.endgame_vertices_, MAX_ENDGAME_VERTICES)),
+			rows_(n_),
+			twins_below_(n_),
+			states_(n_ + 1),
+			lists_(n_ + 1)
+		{
+			assert(g.num_words() == Words);
+
+			for (int u = 0; u < n_; ++u) {
+				rows_[u] = bitset::from_words(g.row(u));
+			}
+
+			for (int v = 0; v < n_; ++v) {
+				for (int u = 0; u < v; ++u) {
+					bitset nu = rows_[u];
+					bitset nv = rows_[v];
+					nu.reset(v);
+					nv.reset(u);
+
+					if (nu == nv) {
+						twins_below_[v].set(u);
+						has_twin_below_.set(v);
+					}
+				}
+			}
+
+			states_[0] = coloring::empty(n_);
+		}
+
+		// alice_wins() from the coloring of the given ply
+		bool alice_wins(int ply) {
+			counters_.count_node();
+			counters_.record_node(ply);
+
+			if (stopped()) {
+				return false;
+			}
+
+			const coloring& col = states_[ply];
+
+			if (col.is_colored()) {
+				counters_.record_terminal();
+				return true;
+			}
+
+			if (col.is_deadend()) {
+				counters_.record_terminal();
+				return false;
+			}
+
+			const bitset safe = safe_vertices(col);
+
+			if (options_.safe_reductions_ && safe == col.uncolored_) {
+				++counters_.safe_wins_;
+				return true;
+			}
+
+			const bool alice = ply % 2 == 0;
+			bitset defusers = col.uncolored_;
+
+			if (options_.bob_threats_ && is_threat_win(col, alice, defusers)) {
+				++counters_.threat_wins_;
+				return false;
+			}
+
+			if (col.uncolored_.count() <= endgame_vertices_) {
+				return solve_endgame(col, alice);
+			}
+
+			tt_entry e;
+			const bool hit = tt_.probe(col.hash_, e);
+			counters_.record_probe(hit);
+
+			if (hit) {
+				return e.value_ > 0;
+			}
+
+			bool result = !alice;
+			move best;
+
+			for (const move m : generate_moves(ply, safe, defusers)) {
+				play(ply, m);
+				const bool child = alice_wins(ply + 1);
+
+				if (stopped()) {
+					return false;
+				}
+
+				if (child == alice) {
+					counters_.record_cutoff();
+					result = child;
+					best = m;
+					break;
+				}
+			}
+
+			// Vertices past 127 do not fit an entry
+			tt_.store(col.hash_, result ? 1 : -1, Bound::Exact, std::min(n_ - ply, MAX_TT_DEPTH), Words <= 2 ? best : move());
+
+			return result;
+		}
+
+		// A move that keeps the player to move winning, or the first legal
+		// move if there is none
+		move line_move(int ply) {
+			const bool alice = ply % 2 == 0;
+			const std::vector<move>& moves = generate_moves(ply, safe_vertices(states_[ply]), states_[ply].uncolored_);
+
+			for (const move m : moves) {
+				play(ply, m);
+
+				if (alice_wins(ply + 1) == alice) {
+					return m;
+				}
+			}
+
+			return moves.front();
+		}
+
+		// The coloring of the next ply: this one with m played
+		void play(int ply, move m) {
+			states_[ply + 1] = states_[ply];
+			states_[ply + 1].color_vertex(rows_[m.vertex_], m.vertex_, m.color_);
+		}
+
+		const coloring& state(int ply) const {
+			return states_[ply];
+		}
+
+		bool stopped() const {
+			return (stop_ != nullptr && stop_->load(std::memory_order_relaxed))
+				|| (options_.node_limit_ != 0 && counters_.nodes_ > options_.node_limit_);
+		}
+
+		search_counters counters_;
+		const std::atomic<bool>* stop_{ nullptr };
+
+	  private:
+		// As game_state::generate_moves() with move_orderer, given the safe
+		// vertices and the defusers of Bob's threats
+		const std::vector<move>& generate_moves(int ply, const bitset& safe, const bitset& defusers) {
+			const coloring& col = states_[ply];
+			const bool alice = ply % 2 == 0;
+			const Ordering policy = alice ? options_.alice_ordering_ : options_.bob_ordering_;
+			const index_t colors = col.representative_colors();
+
+			bitset vertices = candidate_vertices(col);
+			int one_color = -1;
+
+			if (options_.safe_reductions_ && safe.any()) {
+				const bitset tempo = tempo_vertices(col.uncolored_, safe, [this](int u) -> const bitset& { return rows_[u]; });
+
+				if (tempo.any()) {
+					one_color = tempo.lowest();
+					counters_.tempo_prunes_ += tempo.count() - 1;
+					vertices &= ~tempo;
+					vertices.set(one_color);
+				}
+			}
+
+			counters_.threat_prunes_ += (vertices & ~defusers).count();
+			vertices &= defusers;
+
+			auto& list = lists_[ply];
+			list.clear();
+
+			vertices.for_each([&](int v) {
+				index_t allowed = col.get_allowed_colors(v) & colors;
+				if (v == one_color) {
+					allowed &= ~allowed + 1;
+				}
+
+				for (; allowed != 0; allowed &= allowed - 1) {
+					list.emplace_back(v, std::countr_zero(allowed));
+				}
+			});
+
+			if (policy != Ordering::Natural) {
+				order(col, list, alice);
+			}
+
+			if (rotation_ != 0 && ply < ROTATED_PLIES && list.size() > 1) {
+				std::rotate(list.begin(), list.begin() + rotation_ % list.size(), list.end());
+			}
+
+			return list;
+		}
+
+		bitset safe_vertices(const coloring& col) const {
+			if (!options_.safe_reductions_) {
+				return bitset();
+			}
+
+			return ::safe_vertices(col.uncolored_, [this](int u) -> const bitset& { return rows_[u]; },
+				[&col](int u) { return col.get_allowed_colors(u); });
+		}
+
+		// As game_state::solve_endgame()
+		bool solve_endgame(const coloring& col, bool alice) {
+			const auto rows = [this](int u) -> const bitset& { return rows_[u]; };
+			const auto allowed = [&col](int u) { return col.get_allowed_colors(u); };
+
+			++counters_.endgame_solves_;
+			return ::solve_endgame(make_endgame(col.uncolored_, rows, allowed), alice, counters_.endgame_nodes_, &endgames_);
+		}
+
+		// As game_state::is_threat_win()
+		bool is_threat_win(const coloring& col, bool alice, bitset& defusers) const {
+			const auto rows = [this](int u) -> const bitset& { return rows_[u]; };
+			const auto attacked = [&col](int c) -> const bitset& { return col.attack_[c]; };
+
+			if (!alice) {
+				return has_bob_threat(col.uncolored_, K, rows, attacked);
+			}
+
+			defusers = threat_defusers(col.uncolored_, K, rows, attacked);
+			return defusers.none();
+		}
+
+		// As graph_symmetry::candidate_vertices()
+		bitset candidate_vertices(const coloring& col) {
+			const bitset& uncols = col.uncolored_;
+
+			if constexpr (Words == 1) {
+				if (sym_ != nullptr && col.colored_vertices_ < sym_->orbit_plies()) {
+					std::array<index_t, K> classes;
+					for (int c = 0; c < K; ++c) {
+						classes[c] = col.class_[c].words_[0];
+					}
+
+					bitset cand;
+					cand.words_[0] = sym_->candidate_vertices(uncols.words_[0], classes.data(), K, col.colored_vertices_, counters_);
+					return cand;
+				}
+			}
+
+			bitset cand = uncols;
+			(uncols & has_twin_below_).for_each([&](int v) {
+				if ((twins_below_[v] & uncols).any()) {
+					cand.reset(v);
+				}
+			});
+
+			counters_.twin_prunes_ += uncols.count() - cand.count();
+			return cand;
+		}
+
+		// move_orderer's static scores and stable sort
+		void order(const coloring& col, std::vector<move>& list, bool alice) {
+			const bitset& uncols = col.uncolored_;
+
+			uncols.for_each([&](int v) {
+				free_count_[v] = std::popcount(col.get_allowed_colors(v));
+			});
+
+			keys_.resize(list.size());
+
+			for (std::size_t i = 0; i < list.size(); ++i) {
+				const move m = list[i];
+				const bitset nbrs = rows_[m.vertex_] & uncols;
+				std::uint64_t key = 0;
+
+				if (alice) {
+					key = static_cast<std::uint64_t>(free_count_[m.vertex_]) * MAX_VERTICES + nbrs.count();
+				}
+				else {
+					const bitset hit = nbrs & ~col.attack_[m.color_];
+					int fewest = K;
+					hit.for_each([&](int u) { fewest = std::min(fewest, free_count_[u]); });
+
+					key = hit.any() ? static_cast<std::uint64_t>(K + 1 - fewest) * MAX_VERTICES + hit.count() : 0;
+				}
+
+				keys_[i] = key;
+			}
+
+			for (std::size_t i = 1; i < list.size(); ++i) {
+				const move m = list[i];
+				const std::uint64_t key = keys_[i];
+				std::size_t j = i;
+
+				for (; j > 0 && keys_[j - 1] < key; --j) {
+					list[j] = list[j - 1];
+					keys_[j] = keys_[j - 1];
+				}
+
+				list[j] = m;
+				keys_[j] = key;
+			}
+		}
+
+		const int n_;
+		transposition_table& tt_;
+		const graph_symmetry* sym_;
+		const search_options options_;
+		const int rotation_;
+		const int endgame_vertices_;
+		endgame_table endgames_;
+
+		std::vector<bitset> rows_;
+		std::vector<bitset> twins_below_;
+		bitset has_twin_below_;
+
+		// The coloring after each ply of the current line
+		std::vector<coloring> states_;
+
+		std::vector<std::vector<move>> lists_;
+		std::vector<std::uint64_t> keys_;
+		std::array<int, 64 * Words> free_count_{};
+	};
+
+	template <int Words, int K>
+	std::optional<Victory> solve_outcome_kernel(const graph& g, transposition_table& tt, const graph_symmetry* sym,
+		search_counters* counters, const search_options& options) {
+		tt.new_search();
+
+		// Lazy SMP as in solve_outcome()
+		std::atomic<bool> stop{ false };
+		std::atomic<bool> win{ false };
+		std::vector<search_counters> thread_counters(std::max(options.threads_, 1));
+
+		const auto search = [&](int id) {
+			auto root = std::make_unique<fixed_search<Words, K>>(g, tt, sym, options, id);
+			root->counters_.live_nodes_ = counters != nullptr ? counters->live_nodes_ : nullptr;
+
+			if (thread_counters.size() > 1) {
+				root->stop_ = &stop;
+			}
+
+			const bool result = root->alice_wins(0);
+
+			if (!root->stopped()) {
+				win.store(result, std::memory_order_relaxed);
+				stop.store(true, std::memory_order_relaxed);
+			}
+
+			thread_counters[id] = root->counters_;
+		};
+
+		std::vector<std::thread> helpers;
+		for (int id = 1; id < static_cast<int>(thread_counters.size()); ++id) {
+			helpers.emplace_back(search, id);
+		}
+
+		search(0);
+
+		for (auto& helper : helpers) {
+			helper.join();
+		}
+
+		if (counters != nullptr) {
+			for (const auto& c : thread_counters) {
+				*counters += c;
+			}
+		}
+
+		// Only a thread that completed its search raises stop
+		if (!stop.load()) {
+			return std::nullopt;
+		}
+
+		return win.load() ? Victory::Alice : Victory::Bob;
+	}
+
+	template <int Words, int K>
+	std::pair<Victory, std::queue<move>> principal_line_kernel(const graph& g, transposition_table& tt, const graph_symmetry* sym) {
+		fixed_search<Words, K> root(g, tt, sym, search_options());
+		std::queue<move> moves;
+		int ply = 0;
+
+		for (; !root.state(ply).is_colored() && !root.state(ply).is_deadend(); ++ply) {
+			const move next = root.line_move(ply);
+
+			moves.emplace(next);
+			root.play(ply, next);
+		}
+
+		return std::make_pair(root.state(ply).is_colored() ? Victory::Alice : Victory::Bob, moves);
+	}
+
+	typedef std::optional<Victory> (*solve_kernel)(const graph&, transposition_table&, const graph_symmetry*, search_counters*, const search_options&);
+	typedef std::pair<Victory, std::queue<move>> (*line_kernel)(const graph&, transposition_table&, const graph_symmetry*);
+
+	// One row of instantiations per number of words, one column per number
+	// of colors
+	template <int Words, std::size_t... I>
+	constexpr std::array<solve_kernel, NUM_FIXED_COLORS> solve_kernels(std::index_sequence<I...>) {
+		return { &solve_outcome_kernel<Words, MIN_FIXED_COLORS + static_cast<int>(I)>... };
+	}
+
+	template <int Words, std::size_t... I>
+	constexpr std::array<line_kernel, NUM_FIXED_COLORS> line_kernels(std::index_sequence<I...>) {
+		return { &principal_line_kernel<Words, MIN_FIXED_COLORS + static_cast<int>(I)>... };
+	}
+
+	static constexpr auto COLOR_RANGE = std::make_index_sequence<NUM_FIXED_COLORS>();
+
+	static constexpr std::array<std::array<solve_kernel, NUM_FIXED_COLORS>, 4> SOLVE_KERNELS = {
+		solve_kernels<1>(COLOR_RANGE), solve_kernels<2>(COLOR_RANGE), solve_kernels<4>(COLOR_RANGE), solve_kernels<8>(COLOR_RANGE)
+	};
+
+	static constexpr std::array<std::array<line_kernel, NUM_FIXED_COLORS>, 4> LINE_KERNELS = {
+		line_kernels<1>(COLOR_RANGE), line_kernels<2>(COLOR_RANGE), line_kernels<4>(COLOR_RANGE), line_kernels<8>(COLOR_RANGE)
+	};
+
+	// The row of g: 1, 2, 4 and 8 words are rows 0 to 3
+	int kernel_row(const graph& g) {
+		return std::countr_zero(static_cast<unsigned>(g.num_words()));
+	}
+}
+
+bool has_fixed_kernel(const graph& g, int num_cols) {
+	return num_cols >= MIN_FIXED_COLORS && num_cols <= MAX_FIXED_COLORS && g.num_vertices() > 0;
+}
+
+bool use_fixed_kernel(const graph& g, int num_cols, const search_options& options) {
+	return options.fixed_kernels_ && has_fixed_kernel(g, num_cols) &&
+		options.alice_ordering_ != Ordering::History && options.bob_ordering_ != Ordering::History;
+}
+
+Victory solve_outcome_fixed(const graph& g, int num_cols, transposition_table& tt, const graph_symmetry* sym,
+	search_counters* counters, const search_options& options) {
+	search_options unlimited = options;
+	unlimited.node_limit_ = 0;
+
+	return *try_solve_outcome_fixed(g, num_cols, tt, sym, counters, unlimited);
+}
+
+std::optional<Victory> try_solve_outcome_fixed(const graph& g, int num_cols, transposition_table& tt,
+	const graph_symmetry* sym, search_counters* counters, const search_options& options) {
+	assert(has_fixed_kernel(g, num_cols));
+	assert(options.alice_ordering_ != Ordering::History && options.bob_ordering_ != Ordering::History);
+
+	if (sym == nullptr && g.num_vertices() <= BIT_LEN) {
+		const graph_symmetry own(g);
+		return try_solve_outcome_fixed(g, num_cols, tt, &own, counters, options);
+	}
+
+	return SOLVE_KERNELS[kernel_row(g)][num_cols - MIN_FIXED_COLORS](g, tt, sym, counters, options);
+}
+
+std::pair<Victory, std::queue<move>> principal_line_fixed(const graph& g, int num_cols, transposition_table& tt, const graph_symmetry* sym) {
+	assert(has_fixed_kernel(g, num_cols));
+
+	if (sym == nullptr && g.num_vertices() <= BIT_LEN) {
+		const graph_symmetry own(g);
+		return principal_line_fixed(g, num_cols, tt, &own);
+	}
+
+	return LINE_KERNELS[kernel_row(g)][num_cols - MIN_FIXED_COLORS](g, tt, sym);
+}
\ No newline at end of file
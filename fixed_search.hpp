@@ -0,0 +1,42 @@
+#ifndef FIXED_SEARCH_HPP
+#define FIXED_SEARCH_HPP
+
+#include "game_state.hpp"
+#include "minimax.hpp"
+#include "move.hpp"
+
+#include <optional>
+#include <queue>
+#include <utility>
+
+class graph;
+class transposition_table;
+class graph_symmetry;
+
+// alice_wins() compiled once for every number of words of a graph (1, 2, 4
+// or 8) and number of colors from MIN_FIXED_COLORS to MAX_FIXED_COLORS, on
+// fixed_coloring. It searches the same tree as the generic engine, with the
+// static and natural move orderings: automorphism orbits from sym (graphs of
+// at most 64 vertices), twin pruning and color symmetry.
+
+// Whether there is a kernel for g and num_cols
+bool has_fixed_kernel(const graph& g, int num_cols);
+
+// Whether solve_outcome() with options hands g and num_cols to a kernel
+bool use_fixed_kernel(const graph& g, int num_cols, const search_options& options);
+
+// As solve_outcome(), on the kernel for g and num_cols, which must exist.
+// options.threads_ threads share tt; the history ordering is not supported,
+// and options.node_limit_ is ignored.
+Victory solve_outcome_fixed(const graph& g, int num_cols, transposition_table& tt, const graph_symmetry* sym = nullptr,
+	search_counters* counters = nullptr, const search_options& options = search_options());
+
+// As try_solve_outcome(), on the kernel for g and num_cols
+std::optional<Victory> try_solve_outcome_fixed(const graph& g, int num_cols, transposition_table& tt,
+	const graph_symmetry* sym = nullptr, search_counters* counters = nullptr, const search_options& options = search_options());
+
+// As principal_line(), on the kernel for g and num_cols
+std::pair<Victory, std::queue<move>> principal_line_fixed(const graph& g, int num_cols, transposition_table& tt,
+	const graph_symmetry* sym = nullptr);
+
+#endif
\ No newline at end of file
@@ -1,10 +1,42 @@
 #include "game_state.hpp"
 
-#include "vertex_coloring.hpp"
+#include "bitboard_coloring.hpp"
+#include "symmetry.hpp"
 
-game_state::game_state(vertex_coloring& col)
+#include <algorithm>
+#include <bit>
+
+search_counters& search_counters::operator+=(const search_counters& other) {
+	nodes_ += other.nodes_;
+	orbit_prunes_ += other.orbit_prunes_;
+	twin_prunes_ += other.twin_prunes_;
+	safe_wins_ += other.safe_wins_;
+	tempo_prunes_ += other.tempo_prunes_;
+	threat_wins_ += other.threat_wins_;
+	threat_prunes_ += other.threat_prunes_;
+	endgame_solves_ += other.endgame_solves_;
+	endgame_nodes_ += other.endgame_nodes_;
+	tablebase_solves_ += other.tablebase_solves_;
+	tablebase_states_ += other.tablebase_states_;
+
+	for (int i = 0; i < MAX_STATS_PLIES; ++i) {
+		ply_nodes_[i] += other.ply_nodes_[i];
+	}
+
+	cutoffs_ += other.cutoffs_;
+	tt_probes_ += other.tt_probes_;
+	tt_hits_ += other.tt_hits_;
+	terminals_ += other.terminals_;
+	max_ply_ = std::max(max_ply_, other.max_ply_);
+	return *this;
+}
+
+game_state::game_state(bitboard_coloring& col, transposition_table* tt, const graph_symmetry* sym)
 	: col_(col), 
-	uncols_(ALL_ONES >> (BIT_LEN - col.num_vertices())) { }
+	uncols_(ALL_ONES >> (BIT_LEN - col.num_vertices())),
+	tt_(tt),
+	sym_(sym),
+	ordering_(col.get_graph()) { }
 
 
 void game_state::remove(index_t u) {
@@ -13,4 +45,96 @@ void game_state::remove(index_t u) {
 
 void game_state::add(index_t u) {
 	uncols_ |= 1ULL << u;
+}
+
+bool game_state::stopped() const {
+	return (stop_ != nullptr && stop_->load(std::memory_order_relaxed))
+		|| (node_limit_ != 0 && counters_.nodes_ > node_limit_);
+}
+
+const std::vector<move>& game_state::generate_moves(move hint, index_t defusers) {
+	index_t vertices = sym_ != nullptr ? sym_->candidate_vertices(col_, counters_) : uncols_;
+	const index_t colors = break_color_symmetry_ ? col_.representative_colors() : ALL_ONES;
+	index_t one_color = 0;
+
+	if (safe_reductions_) {
+		// The lowest tempo vertex stands for all of them, in one color
+		const index_t tempo = col_.tempo_vertices(col_.safe_vertices());
+
+		if (tempo != 0) {
+			one_color = tempo & (~tempo + 1);
+			counters_.tempo_prunes_ += std::popcount(tempo) - 1;
+			vertices = (vertices & ~tempo) | one_color;
+		}
+	}
+
+	counters_.threat_prunes_ += std::popcount(vertices & ~defusers);
+	vertices &= defusers;
+
+	return ordering_.order_moves(col_, vertices, colors, hint, one_color);
+}
+
+bool game_state::is_safe_win() {
+	if (!safe_reductions_ || col_.safe_vertices() != col_.uncolored()) {
+		return false;
+	}
+
+	++counters_.safe_wins_;
+	return true;
+}
+
+bool game_state::is_threat_win(index_t& defusers) {
+	defusers = ALL_ONES;
+
+	if (!bob_threats_) {
+		return false;
+	}
+
+	const bool alice = col_.num_colored_vertices() % 2 == 0;
+	if (alice ? (defusers = col_.threat_defusers()) != 0 : !col_.has_bob_threat()) {
+		return false;
+	}
+
+	++counters_.threat_wins_;
+	return true;
+}
+
+bool game_state::is_endgame() const {
+	return col_.num_colors() <= MAX_ENDGAME_COLORS
+		&& std::popcount(col_.uncolored()) <= std::min(endgame_vertices_, MAX_ENDGAME_VERTICES);
+}
+
+bool game_state::solve_endgame() {
+	const bool alice = col_.num_colored_vertices() % 2 == 0;
+
+	++counters_.endgame_solves_;
+	return ::solve_endgame(col_.get_endgame(), alice, counters_.endgame_nodes_, endgames_);
+}
+
+bool parse_engine(const std::string& name, Engine& engine) {
+	if (name == "alphabeta") {
+		engine = Engine::AlphaBeta;
+	}
+	else if (name == "dfpn") {
+		engine = Engine::ProofNumber;
+	}
+	else if (name == "tablebase") {
+		engine = Engine::Tablebase;
+	}
+	else {
+		return false;
+	}
+
+	return true;
+}
+
+std::string to_string(Engine engine) {
+	switch (engine) {
+	case Engine::AlphaBeta:
+		return "alphabeta";
+	case Engine::ProofNumber:
+		return "dfpn";
+	default:
+		return "tablebase";
+	}
 }
\ No newline at end of file
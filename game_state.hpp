@@ -2,21 +2,219 @@
 #define GAME_STATE_HPP
 
 #include "common.hpp"
+#include "endgame.hpp"
+#include "move.hpp"
+#include "move_ordering.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <limits>
+#include <string>
+#include <vector>
 
-class vertex_coloring;
+#include <cstdint>
+
+class bitboard_coloring;
+class transposition_table;
+class graph_symmetry;
+
+// The statistics of search_counters below are kept unless
+// VCG_NO_SEARCH_STATS is defined, which compiles them out of the engines
+#ifdef VCG_NO_SEARCH_STATS
+static constexpr bool SEARCH_STATS = false;
+#else
+static constexpr bool SEARCH_STATS = true;
+#endif
+
+// Plies with a node count of their own; deeper ones share the last
+static constexpr int MAX_STATS_PLIES = 64;
+
+// Nodes between two additions to search_counters::live_nodes_, a power of 2
+static constexpr std::uint64_t LIVE_NODES_INTERVAL = 4096;
+
+struct search_counters {
+	std::uint64_t nodes_{ 0 };
+	std::uint64_t orbit_prunes_{ 0 };
+	std::uint64_t twin_prunes_{ 0 };
+
+	// Nodes won for Alice as every uncolored vertex is safe
+	std::uint64_t safe_wins_{ 0 };
+
+	// Tempo vertices left out as equivalent to another one
+	std::uint64_t tempo_prunes_{ 0 };
+
+	// Nodes won for Bob by a threat, and vertices left out of Alice's moves
+	// as they lose to a threat
+	std::uint64_t threat_wins_{ 0 };
+	std::uint64_t threat_prunes_{ 0 };
+
+	// Nodes handed to the endgame solver, and the positions it searched
+	std::uint64_t endgame_solves_{ 0 };
+	std::uint64_t endgame_nodes_{ 0 };
+
+	// Games solved by a tablebase, and the colorings it decided
+	std::uint64_t tablebase_solves_{ 0 };
+	std::uint64_t tablebase_states_{ 0 };
+
+	// Statistics, left at 0 without SEARCH_STATS. Nodes by ply, i.e., by
+	// colored vertices; moves that refuted their node; table probes and
+	// those that decided the node; nodes with a full coloring or a dead
+	// vertex; and the deepest ply searched.
+	std::array<std::uint64_t, MAX_STATS_PLIES> ply_nodes_{};
+	std::uint64_t cutoffs_{ 0 };
+	std::uint64_t tt_probes_{ 0 };
+	std::uint64_t tt_hits_{ 0 };
+	std::uint64_t terminals_{ 0 };
+	int max_ply_{ 0 };
+
+	void record_node(int ply) {
+		if constexpr (SEARCH_STATS) {
+			++ply_nodes_[std::min(ply, MAX_STATS_PLIES - 1)];
+			max_ply_ = std::max(max_ply_, ply);
+		}
+	}
+
+	void record_probe(bool hit) {
+		if constexpr (SEARCH_STATS) {
+			++tt_probes_;
+			tt_hits_ += hit;
+		}
+	}
+
+	void record_cutoff() {
+		if constexpr (SEARCH_STATS) {
+			++cutoffs_;
+		}
+	}
+
+	void record_terminal() {
+		if constexpr (SEARCH_STATS) {
+			++terminals_;
+		}
+	}
+
+	// For watching a game while it is searched: if set, count_node() adds
+	// to it every LIVE_NODES_INTERVAL nodes. The engines hand it on to the
+	// counters of their threads, which all add to it; operator+= leaves it
+	// alone.
+	std::atomic<std::uint64_t>* live_nodes_{ nullptr };
+
+	void count_node() {
+		if ((++nodes_ & (LIVE_NODES_INTERVAL - 1)) == 0 && live_nodes_ != nullptr) {
+			live_nodes_->fetch_add(LIVE_NODES_INTERVAL, std::memory_order_relaxed);
+		}
+	}
+
+	search_counters& operator+=(const search_counters& other);
+};
+
+enum class Engine {
+	// Boolean alpha-beta with a transposition table, see alice_wins()
+	AlphaBeta = 0,
+	// Depth-first proof-number search, see dfpn_alice_wins()
+	ProofNumber = 1,
+	// Retrograde analysis over every coloring, see solve_outcome_tablebase()
+	Tablebase = 2
+};
+
+bool parse_engine(const std::string& name, Engine& engine);
+
+std::string to_string(Engine engine);
+
+// Tablebases solve_outcome() builds by default, in megabytes: enough for
+// 11 vertices in 5 colors
+static constexpr std::size_t DEFAULT_TABLEBASE_MEGABYTES = 64;
+
+struct search_options {
+	Engine engine_{ Engine::AlphaBeta };
+	Ordering alice_ordering_{ Ordering::Static };
+	Ordering bob_ordering_{ Ordering::Static };
+
+	// Threads searching each graph (alpha-beta only)
+	int threads_{ 1 };
+
+	// Search on the kernel compiled for the number of words and colors, if
+	// there is one (alpha-beta without the history ordering only)
+	bool fixed_kernels_{ true };
+
+	// Stop at safe colorings and try one tempo move, see reductions.hpp
+	bool safe_reductions_{ true };
+
+	// Stop where Bob wins by a threat and leave out Alice's moves that lose
+	// to one
+	bool bob_threats_{ true };
+
+	// Hand nodes with at most this many uncolored vertices to the endgame
+	// solver (boolean searches only); 0 turns it off
+	int endgame_vertices_{ DEFAULT_ENDGAME_VERTICES };
+
+	// Give up an alpha-beta search once a thread has searched this many
+	// nodes; 0 for no limit. See try_solve_outcome().
+	std::uint64_t node_limit_{ 0 };
+
+	// Largest tablebase solve_outcome() may build; 0 for none
+	std::size_t tablebase_megabytes_{ DEFAULT_TABLEBASE_MEGABYTES };
+};
 
 struct game_state {
 	game_state() = delete;
-	game_state(vertex_coloring& col);
+	game_state(bitboard_coloring& col, transposition_table* tt = nullptr, const graph_symmetry* sym = nullptr);
 
 	void remove(index_t u);
 
 	void add(index_t u);
 
-	vertex_coloring& col_;
+	// The moves of the node, best first. Symmetric vertices and 
+	// interchangeable colors are left out, and so are vertices outside
+	// defusers. The list stays valid until the next call at the same ply.
+	const std::vector<move>& generate_moves(move hint = move(), index_t defusers = ALL_ONES);
+
+	// Whether every uncolored vertex is safe, i.e., Alice has won. Always
+	// false without safe_reductions_.
+	bool is_safe_win();
+
+	// Whether Bob has won by a threat, see reductions.hpp. Otherwise, with
+	// Alice to move, defusers gets the vertices she may still play. Always
+	// false without bob_threats_.
+	bool is_threat_win(index_t& defusers);
+
+	// Whether the node has at most endgame_vertices_ uncolored vertices
+	bool is_endgame() const;
+
+	// Whether Alice wins the node, from the endgame solver
+	bool solve_endgame();
+
+	bitboard_coloring& col_;
 	index_t uncols_;
+	transposition_table* tt_;
+	const graph_symmetry* sym_;
+	move_orderer ordering_;
+	search_counters counters_;
+
+	// Try one color from each class of interchangeable colors
+	bool break_color_symmetry_{ true };
+
+	// Stop at safe colorings and try one move among the tempo vertices
+	bool safe_reductions_{ true };
+
+	// Stop where Bob wins by a threat, see is_threat_win()
+	bool bob_threats_{ true };
+
+	// See search_options::endgame_vertices_, and the table of the endgame
+	// solver, if any
+	int endgame_vertices_{ DEFAULT_ENDGAME_VERTICES };
+	endgame_table* endgames_{ nullptr };
+
+	// See search_options::node_limit_
+	std::uint64_t node_limit_{ 0 };
+
+	// If set, the search gives up once it is raised, or past node_limit_
+	// nodes. The result of a search given up is meaningless, and nothing is
+	// stored for it.
+	const std::atomic<bool>* stop_{ nullptr };
+
+	bool stopped() const;
 };
 
 #endif
\ No newline at end of file
@@ -1,62 +1,108 @@
 #include "graph.hpp"
+#include "graph6.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <bit>
 #include <numeric>
 
 namespace {
-	static constexpr int BIAS6 = 63;
-	static constexpr int SMALLN = 62;
-	static constexpr int SMALLISHN = 258047;
-	static constexpr int TOPBIT6 = 32;
-
-	int get_graph_size(const std::string& s)
-	{
-		auto p = (s[0] == ':' || s[0] == '&') ? s.cbegin() + 1 : s.cbegin();
-		int n = *p++ - BIAS6;
-
-		if (n > SMALLN)
-		{
-			n = *p++ - BIAS6;
-			if (n > SMALLN)
-			{
-				n = *p++ - BIAS6;
-				n = (n << 6) | (*p++ - BIAS6);
-				n = (n << 6) | (*p++ - BIAS6);
-				n = (n << 6) | (*p++ - BIAS6);
-				n = (n << 6) | (*p++ - BIAS6);
-				n = (n << 6) | (*p++ - BIAS6);
-			}
-			else
-			{
-				n = (n << 6) | (*p++ - BIAS6);
-				n = (n << 6) | (*p++ - BIAS6);
+	// Branch and bound over the cliques of g on rows of Words words, until
+	// one of target vertices is found
+	template <int Words>
+	class clique_search {
+	  public:
+		clique_search(const graph& g, int target)
+			: g_(g), target_(target) { }
+
+		// The largest clique found, of at least target vertices if there is one
+		int run() {
+			expand(0, wide_bitset<Words>::below(static_cast<int>(g_.num_vertices())));
+			return best_;
+		}
+
+	  private:
+		wide_bitset<Words> row(int u) const {
+			return wide_bitset<Words>::from_words(g_.row(u));
+		}
+
+		// Extends a clique of size vertices by those of candidates, which are
+		// adjacent to all of it. Each candidate is tried with the later ones
+		// only, so every clique is met once.
+		void expand(int size, wide_bitset<Words> candidates) {
+			while (candidates.any() && size + candidates.count() > best_ && best_ < target_) {
+				const int v = candidates.lowest();
+				candidates.reset(v);
+
+				const wide_bitset<Words> next = candidates & row(v);
+
+				if (next.none()) {
+					best_ = std::max(best_, size + 1);
+				}
+				else {
+					expand(size + 1, next);
+				}
 			}
 		}
 
-		return n;
+		const graph& g_;
+		const int target_;
+		int best_{ 0 };
+	};
+
+	int find_clique(const graph& g, int target) {
+		switch (g.num_words()) {
+		case 1:
+			return clique_search<1>(g, target).run();
+		case 2:
+			return clique_search<2>(g, target).run();
+		case 4:
+			return clique_search<4>(g, target).run();
+		default:
+			return clique_search<8>(g, target).run();
+		}
+	}
+}
+
+graph::graph(int n, const index_t* rows)
+	: adj_(rows, rows + n * words_for(n)),
+	n_(n),
+	words_(words_for(n))
+{
+	assert(n >= 0 && n <= MAX_VERTICES);
+
+	for (const index_t row : adj_) {
+		m_ += std::popcount(row);
 	}
+
+	m_ /= 2;
 }
 
 void graph::add_edge(index_t u, index_t v) {
 	assert(u >= 0 &&
 		v >= 0 &&
 		u != v &&
-		u < adj_.size() &&
-		v < adj_.size());
+		u < static_cast<index_t>(n_) &&
+		v < static_cast<index_t>(n_));
 
-	adj_[u] |= (1ULL << v);
-	adj_[v] |= (1ULL << u);
+	adj_[u * words_ + v / BIT_LEN] |= 1ULL << (v % BIT_LEN);
+	adj_[v * words_ + u / BIT_LEN] |= 1ULL << (u % BIT_LEN);
 	++m_;
 }
 
 index_t graph::get_degree(index_t u) const {
 	assert(u >= 0 && u < num_vertices());
-	return std::popcount(adj_[u]);
+
+	index_t degree = 0;
+	for (int i = 0; i < words_; ++i) {
+		degree += std::popcount(adj_[u * words_ + i]);
+	}
+
+	return degree;
 }
 
 index_t graph::num_vertices() const {
-	return adj_.size();
+	return n_;
 }
 
 index_t graph::num_edges() const {
@@ -65,118 +111,62 @@ index_t graph::num_edges() const {
 
 index_t graph::get_neighbors(index_t u) const {
 	assert(u >= 0 && u < num_vertices());
+	assert(words_ == 1);
 	return adj_[u];
 }
 
+const index_t* graph::row(index_t u) const {
+	assert(u >= 0 && u < num_vertices());
+	return adj_.data() + u * words_;
+}
+
+int graph::num_words() const {
+	return words_;
+}
+
 bool graph::has_edge(index_t u, index_t v) const {
 	assert(u >= 0 &&
 		v >= 0 &&
 		u != v &&
-		u < adj_.size() &&
-		v < adj_.size());
+		u < static_cast<index_t>(n_) &&
+		v < static_cast<index_t>(n_));
 
-	return (adj_[u] >> v) & 1ULL;
+	return (adj_[u * words_ + v / BIT_LEN] >> (v % BIT_LEN)) & 1ULL;
 }
 
-bool has_triangle(const graph& g) {
-	if (g.num_vertices() < 3 || g.num_edges() < 3) {
-		return false;
-	}
-
-	std::vector<index_t> idx = { 0, 1, 2 };
+int clique_number(const graph& g) {
+	return find_clique(g, static_cast<int>(g.num_vertices()));
+}
 
-	do {
-		if (g.has_edge(idx[0], idx[1]) && g.has_edge(idx[0], idx[2]) && g.has_edge(idx[1], idx[2])) {
-			return true;
-		}
-	} while (next_combination(idx.data(), g.num_vertices(), 3));
+bool has_clique(const graph& g, int size) {
+	return find_clique(g, size) >= size;
+}
 
-	return false;
+bool has_triangle(const graph& g) {
+	return g.num_edges() >= 3 && has_clique(g, 3);
 }
 
 bool has_k_four(const graph& g) {
-	if (g.num_vertices() < 4 || g.num_edges() < 6) {
-		return false;
-	}
-
-	std::vector<index_t> idx = { 0, 1, 2, 3 };
-
-	do {
-		if (
-			g.has_edge(idx[0], idx[1]) && 
-			g.has_edge(idx[0], idx[2]) && 
-			g.has_edge(idx[0], idx[3]) &&
-			g.has_edge(idx[1], idx[2]) &&
-			g.has_edge(idx[1], idx[3]) &&
-			g.has_edge(idx[2], idx[3]))
-		{
-			return true;
-		}
-	} while (next_combination(idx.data(), g.num_vertices(), 4));
-
-	return false;
+	return g.num_edges() >= 6 && has_clique(g, 4);
 }
 
-graph read_graph6(const std::string& s) {
-	const int n = get_graph_size(s);
-	graph g(n);
-
-	#define SIZELEN(n) ((n)<=SMALLN?1:((n)<=SMALLISHN?4:8))
-	auto p = s.cbegin() + (s[0] == ':' || s[0] == '&') + SIZELEN(n);
-
-	int k = 0;
-	int v = 0;
-	int x = 0;
-
-	if (s[0] != ':' && s[0] != '&') /* graph6 format */
-	{
-		k = 1;
-
-		for (int j = 1; j < n; ++j)
-		{
-			for (int i = 0; i < j; ++i)
-			{
-				if (--k == 0)
-				{
-					k = 6;
-					x = *(p++) - BIAS6;
-				}
+graph read_graph6(std::string_view s) {
+	index_t rows[MAX_GRAPH6_VERTICES];
 
-				if ((x & TOPBIT6))
-				{
-					g.add_edge(j, i);
-				}
-				x <<= 1;
-			}
-		}
+	const int n = decode_graph6(s, rows);
+	if (n != NOT_GRAPH6) {
+		return graph(n, rows);
 	}
-	else if (s[0] == '&')
-	{
-		k = 1;
-		for (int i = 0; i < n; ++i)
-		{
-			for (int j = 0; j < n; ++j)
-			{
-				if (--k == 0)
-				{
-					k = 6;
-					x = *(p++) - BIAS6;
-				}
 
-				if ((x & TOPBIT6))
-				{
-					g.add_edge(j, i);
-				}
-				x <<= 1;
-			}
-		}
-	}
+	std::vector<index_t> wide_rows;
+	const int wide_n = decode_graph6(s, wide_rows);
+	assert(wide_n != NOT_GRAPH6 && "Malformed graph6 line");
 
-	return g;
+	return graph(wide_n, wide_rows.data());
 }
 
 graph get_complete_graph(int n) {
-	assert(n > 0 && n <= 64);
+	assert(n > 0 && n <= MAX_VERTICES);
 
 	graph g(n);
 
@@ -190,7 +180,7 @@ graph get_complete_graph(int n) {
 }
 
 graph get_cycle(int n) {
-	assert(n >= 4 && n <= 64);
+	assert(n >= 4 && n <= MAX_VERTICES);
 
 	graph g(n);
 	const int last_vertex = n - 1;
@@ -211,5 +201,18 @@ graph get_star(int n) {
 		g.add_edge(0, i);
 	}
 
+	return g;
+}
+
+graph get_wheel(int n) {
+	assert(n >= 5 && n <= MAX_VERTICES);
+
+	// A hub (vertex 0) joined to every vertex of a cycle on 1, ..., n - 1
+	graph g(n);
+	for (int i = 1; i < n; ++i) {
+		g.add_edge(0, i);
+		g.add_edge(i, i == n - 1 ? 1 : i + 1);
+	}
+
 	return g;
 }
\ No newline at end of file
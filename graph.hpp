@@ -2,14 +2,24 @@
 #define GRAPH_HPP
 
 #include "common.hpp"
+#include "bitset.hpp"
+#include <string_view>
 #include <vector>
 #include <cassert>
 
 #include <iostream>
 
+// Adjacency rows of num_words() words per vertex, up to MAX_VERTICES
+// vertices. With at most 64 vertices a row is a single index_t mask.
 class graph {
   public:
-	graph(int n) : adj_(n), m_(0) { }
+	graph(int n) : adj_(n * words_for(n)), n_(n), words_(words_for(n)), m_(0) {
+		assert(n >= 0 && n <= MAX_VERTICES);
+	}
+
+	// From adjacency rows of num_words() words each, e.g., those of
+	// decode_graph6()
+	graph(int n, const index_t* rows);
 	graph& operator=(const graph&) = delete;
 
 	void add_edge(index_t u, index_t v);
@@ -20,20 +30,35 @@ class graph {
 
 	index_t num_edges() const;
 
+	// Only for graphs of at most 64 vertices
 	index_t get_neighbors(index_t u) const;
 
+	// The num_words() words of the neighbors of u
+	const index_t* row(index_t u) const;
+
+	int num_words() const;
+
 	bool has_edge(index_t u, index_t v) const;
 
   private:
 	std::vector<index_t> adj_;
+	int n_;
+	int words_;
 	int m_{ 0 };
 };
 
+// The number of vertices of a largest clique of g, by a branch and bound
+// over bitsets of candidates, pruned by their count
+int clique_number(const graph& g);
+
+// Whether g has a clique of the given size; the search stops at the first
+bool has_clique(const graph& g, int size);
+
 bool has_triangle(const graph& g);
 
 bool has_k_four(const graph& g);
 
-graph read_graph6(const std::string& s);
+graph read_graph6(std::string_view s);
 
 graph get_complete_graph(int n);
 
@@ -41,4 +66,6 @@ graph get_cycle(int n);
 
 graph get_star(int n);
 
+graph get_wheel(int n);
+
 #endif
\ No newline at end of file
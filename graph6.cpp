@@ -0,0 +1,351 @@
+#include "graph6.hpp"
+#include "graph.hpp"
+#include "bitset.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+	static constexpr int BIAS6 = 63;
+	static constexpr int SMALLN = 62;
+
+	// Characters unpacked per step, into 12 bytes of bits
+	static constexpr std::size_t BLOCK_CHARS = 16;
+	static constexpr std::size_t BLOCK_BYTES = 12;
+
+	// Enough blocks for the 64 * 64 bits of the largest digraph, with room
+	// for the overlapping stores and loads past the end
+	static constexpr std::size_t MAX_BLOCKS = (MAX_GRAPH6_VERTICES * MAX_GRAPH6_VERTICES / 6 + BLOCK_CHARS) / BLOCK_CHARS;
+	static constexpr std::size_t BUFFER_BYTES = MAX_BLOCKS * BLOCK_BYTES + 32;
+
+	// Unpacks 16 characters into 96 bits of the bit string, lowest bit first.
+	// Sets bad if some character is outside the graph6 range.
+	void unpack_block(const char* p, unsigned char* out, bool& bad) {
+#ifdef HAS_SSE2
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		const __m128i x = _mm_sub_epi8(bytes, _mm_set1_epi8(BIAS6));
+		const __m128i invalid = _mm_or_si128(_mm_cmplt_epi8(x, _mm_setzero_si128()), _mm_cmpgt_epi8(x, _mm_set1_epi8(63)));
+		bad |= _mm_movemask_epi8(invalid) != 0;
+
+		// Reverse the bits of every byte, then drop the two unused ones
+		const __m128i m1 = _mm_set1_epi8(0x55);
+		const __m128i m2 = _mm_set1_epi8(0x33);
+		const __m128i m4 = _mm_set1_epi8(0x0F);
+		__m128i r = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(x, 1), m1), _mm_slli_epi16(_mm_and_si128(x, m1), 1));
+		r = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(r, 2), m2), _mm_slli_epi16(_mm_and_si128(r, m2), 2));
+		r = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(r, 4), m4), _mm_slli_epi16(_mm_and_si128(r, m4), 4));
+		r = _mm_and_si128(_mm_srli_epi16(r, 2), _mm_set1_epi8(0x3F));
+
+		// 6 bits per byte to 12 per 16-bit lane, 24 per 32-bit lane, 48 per 64-bit lane
+		r = _mm_or_si128(_mm_and_si128(r, _mm_set1_epi16(0x00FF)), _mm_slli_epi16(_mm_srli_epi16(r, 8), 6));
+		r = _mm_madd_epi16(r, _mm_set1_epi32(1 | (1 << 28)));
+		r = _mm_or_si128(_mm_and_si128(r, _mm_set1_epi64x(0xFFFFFFFF)), _mm_slli_epi64(_mm_srli_epi64(r, 32), 24));
+
+		std::uint64_t lanes[2];
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), r);
+		const std::uint64_t lo = lanes[0];
+		const std::uint64_t hi = lanes[1];
+#else
+		// The 6 bits of every value in reverse order
+		static constexpr auto table = []() {
+			std::array<unsigned char, 64> t{};
+			for (unsigned i = 0; i < 64; ++i) {
+				for (unsigned b = 0; b < 6; ++b) {
+					t[i] |= ((i >> b) & 1) << (5 - b);
+				}
+			}
+			return t;
+		}();
+
+		std::uint64_t lo = 0;
+		std::uint64_t hi = 0;
+		for (std::size_t i = 0; i < BLOCK_CHARS; ++i) {
+			const int x = static_cast<unsigned char>(p[i]) - BIAS6;
+			bad |= x < 0 || x > 63;
+
+			const std::uint64_t bits = table[x & 63];
+			(i < 8 ? lo : hi) |= bits << (6 * (i % 8));
+		}
+#endif
+
+		// Bytes 6 and 7 of the first store are overwritten by the second
+		std::memcpy(out, &lo, sizeof(lo));
+		std::memcpy(out + 6, &hi, sizeof(hi));
+	}
+
+	// The 64 bits of the bit string starting at bit t
+	std::uint64_t bits_at(const unsigned char* bits, std::size_t t) {
+		const std::size_t r = t & 7;
+		std::uint64_t w = 0;
+		std::memcpy(&w, bits + (t >> 3), sizeof(w));
+
+		w >>= r;
+		if (r != 0) {
+			w |= static_cast<std::uint64_t>(bits[(t >> 3) + 8]) << (64 - r);
+		}
+
+		return w;
+	}
+
+	index_t low_mask(int n) {
+		return n >= 64 ? ALL_ONES : (1ULL << n) - 1;
+	}
+
+	void append_size(std::string& s, int n) {
+		if (n <= SMALLN) {
+			s += static_cast<char>(BIAS6 + n);
+		}
+		else {
+			s += '~';
+			s += static_cast<char>(BIAS6 + ((n >> 12) & 63));
+			s += static_cast<char>(BIAS6 + ((n >> 6) & 63));
+			s += static_cast<char>(BIAS6 + (n & 63));
+		}
+	}
+
+	// Reads the digraph flag and the vertex count, in 1 or 4 characters (the
+	// 8-character form is too large), and checks the length of the line.
+	// Returns the offset of the first data character, or 0 if the line is
+	// malformed or has more than max_n vertices.
+	std::size_t parse_header(std::string_view line, int max_n, bool& digraph, int& n, std::size_t& num_chars) {
+		digraph = !line.empty() && line[0] == '&';
+		std::size_t p = digraph;
+
+		if (p >= line.size()) {
+			return 0;
+		}
+
+		n = line[p++] - BIAS6;
+		if (n < 0 || n > SMALLN + 1) {
+			return 0;
+		}
+
+		if (n > SMALLN) {
+			if (p + 3 > line.size() || line[p] == '~') {
+				return 0;
+			}
+
+			n = 0;
+			for (std::size_t end = p + 3; p < end; ++p) {
+				const int x = line[p] - BIAS6;
+				if (x < 0 || x > 63) {
+					return 0;
+				}
+				n = (n << 6) | x;
+			}
+		}
+
+		if (n > max_n) {
+			return 0;
+		}
+
+		const std::size_t num_bits = digraph ? std::size_t(n) * n : std::size_t(n) * (n - 1) / 2;
+		num_chars = (num_bits + 5) / 6;
+
+		return line.size() == p + num_chars ? p : 0;
+	}
+
+	// Room needed by unpack()
+	std::size_t unpacked_bytes(std::size_t num_chars) {
+		return (num_chars + BLOCK_CHARS - 1) / BLOCK_CHARS * BLOCK_BYTES + 16;
+	}
+
+	// Unpacks the characters into bits; false if some character is outside
+	// the graph6 range
+	bool unpack(const char* chars, std::size_t num_chars, unsigned char* bits) {
+		const std::size_t num_blocks = (num_chars + BLOCK_CHARS - 1) / BLOCK_CHARS;
+		bool bad = false;
+
+		for (std::size_t b = 0; b < num_chars / BLOCK_CHARS; ++b) {
+			unpack_block(chars + b * BLOCK_CHARS, bits + b * BLOCK_BYTES, bad);
+		}
+
+		// The last characters are padded with zero bits, so nothing is read
+		// past the end of the line
+		if (num_chars % BLOCK_CHARS != 0) {
+			char tail[BLOCK_CHARS];
+			std::memset(tail, BIAS6, sizeof(tail));
+			std::memcpy(tail, chars + (num_blocks - 1) * BLOCK_CHARS, num_chars % BLOCK_CHARS);
+			unpack_block(tail, bits + (num_blocks - 1) * BLOCK_BYTES, bad);
+		}
+
+		std::memset(bits + num_blocks * BLOCK_BYTES, 0, 16);
+		return !bad;
+	}
+}
+
+int decode_graph6(std::string_view line, index_t* rows) {
+	bool digraph = false;
+	int n = 0;
+	std::size_t num_chars = 0;
+	const std::size_t p = parse_header(line, MAX_GRAPH6_VERTICES, digraph, n, num_chars);
+
+	unsigned char bits[BUFFER_BYTES];
+
+	if (p == 0 || !unpack(line.data() + p, num_chars, bits)) {
+		return NOT_GRAPH6;
+	}
+
+	std::fill(rows, rows + n, 0);
+
+	if (!digraph) {
+		// Column j of the upper triangle holds the neighbors of j below it
+		for (int j = 1; j < n; ++j) {
+			const index_t lower = bits_at(bits, BINOMIAL[j]) & low_mask(j);
+			rows[j] |= lower;
+
+			for (index_t rest = lower; rest != 0; rest &= rest - 1) {
+				rows[std::countr_zero(rest)] |= 1ULL << j;
+			}
+		}
+	}
+	else {
+		// Row i of the matrix holds the heads of the arcs from i
+		for (int i = 0; i < n; ++i) {
+			const index_t out = bits_at(bits, static_cast<std::size_t>(i) * n) & low_mask(n);
+			rows[i] |= out;
+
+			for (index_t rest = out; rest != 0; rest &= rest - 1) {
+				rows[std::countr_zero(rest)] |= 1ULL << i;
+			}
+		}
+
+		for (int i = 0; i < n; ++i) {
+			rows[i] &= ~(1ULL << i);
+		}
+	}
+
+	return n;
+}
+
+int decode_graph6(std::string_view line, std::vector<index_t>& rows) {
+	bool digraph = false;
+	int n = 0;
+	std::size_t num_chars = 0;
+	const std::size_t p = parse_header(line, MAX_VERTICES, digraph, n, num_chars);
+
+	if (p == 0) {
+		return NOT_GRAPH6;
+	}
+
+	std::vector<unsigned char> bits(unpacked_bytes(num_chars));
+
+	if (!unpack(line.data() + p, num_chars, bits.data())) {
+		return NOT_GRAPH6;
+	}
+
+	const int words = words_for(n);
+	rows.assign(std::size_t(n) * words, 0);
+
+	// Sets bit t of row u, and bit u of row t
+	const auto add = [&rows, words](int u, int t) {
+		rows[u * words + t / 64] |= 1ULL << (t % 64);
+		rows[t * words + u / 64] |= 1ULL << (u % 64);
+	};
+
+	// Columns of the upper triangle or rows of the matrix, a word at a time
+	for (int a = 0; a < n; ++a) {
+		const int length = digraph ? n : a;
+		const std::size_t first = digraph ? std::size_t(a) * n : std::size_t(a) * (a - 1) / 2;
+
+		for (int w = 0; 64 * w < length; ++w) {
+			const index_t word = bits_at(bits.data(), first + 64 * w) & low_mask(length - 64 * w);
+
+			for (index_t rest = word; rest != 0; rest &= rest - 1) {
+				const int b = 64 * w + std::countr_zero(rest);
+				if (b != a) {
+					add(a, b);
+				}
+			}
+		}
+	}
+
+	return n;
+}
+
+std::string to_graph6(const graph& g, bool digraph) {
+	const int n = static_cast<int>(g.num_vertices());
+
+	std::string s = digraph ? "&" : "";
+	append_size(s, n);
+
+	int x = 0;
+	int k = 0;
+	const auto put = [&](bool bit) {
+		x = (x << 1) | bit;
+		if (++k == 6) {
+			s += static_cast<char>(BIAS6 + x);
+			x = k = 0;
+		}
+	};
+
+	if (!digraph) {
+		for (int j = 1; j < n; ++j) {
+			for (int i = 0; i < j; ++i) {
+				put(g.has_edge(i, j));
+			}
+		}
+	}
+	else {
+		for (int i = 0; i < n; ++i) {
+			for (int j = 0; j < n; ++j) {
+				put(i != j && g.has_edge(i, j));
+			}
+		}
+	}
+
+	if (k > 0) {
+		s += static_cast<char>(BIAS6 + (x << (6 - k)));
+	}
+
+	return s;
+}
+
+bool graph6_batch::decode(const std::string_view* lines, std::size_t count) {
+	offsets_.resize(count);
+	sizes_.resize(count);
+
+	std::size_t offset = 0;
+	bool ok = true;
+
+	for (std::size_t i = 0; i < count; ++i) {
+		// Room for the largest graph; only its rows are kept
+		if (rows_.size() < offset + MAX_GRAPH6_VERTICES) {
+			rows_.resize(2 * (offset + MAX_GRAPH6_VERTICES));
+		}
+
+		const int n = decode_graph6(lines[i], rows_.data() + offset);
+
+		offsets_[i] = static_cast<std::uint32_t>(offset);
+		sizes_[i] = static_cast<std::int8_t>(n);
+
+		if (n == NOT_GRAPH6) {
+			ok = false;
+		}
+		else {
+			offset += n;
+		}
+	}
+
+	return ok;
+}
+
+std::size_t graph6_batch::size() const {
+	return offsets_.size();
+}
+
+int graph6_batch::num_vertices(std::size_t i) const {
+	return sizes_[i];
+}
+
+const index_t* graph6_batch::rows(std::size_t i) const {
+	return rows_.data() + offsets_[i];
+}
\ No newline at end of file
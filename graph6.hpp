@@ -0,0 +1,58 @@
+#ifndef GRAPH6_HPP
+#define GRAPH6_HPP
+
+#include "common.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class graph;
+
+// Largest graph that fits the rows of a bitboard
+static constexpr int MAX_GRAPH6_VERTICES = 64;
+
+// Returned for lines that are not valid graph6 or digraph6, or have more than
+// MAX_GRAPH6_VERTICES vertices
+static constexpr int NOT_GRAPH6 = -1;
+
+// Decodes a graph6 line, or a digraph6 line ('&'), into the adjacency rows of
+// the graph: bit v of rows[u] is set if u and v are adjacent. Arcs of a
+// digraph are taken as undirected edges and loops are dropped. rows needs
+// room for MAX_GRAPH6_VERTICES rows. Returns the number of vertices, or
+// NOT_GRAPH6.
+//
+// The characters are unbiased and unpacked into a bit string 16 at a time
+// with SSE2, where available; every row is then a single shifted load from
+// the bit string.
+int decode_graph6(std::string_view line, index_t* rows);
+
+// The same for graphs of up to MAX_VERTICES vertices, with words_for(n)
+// words per row, e.g., for a graph of more than 64 vertices
+int decode_graph6(std::string_view line, std::vector<index_t>& rows);
+
+// The graph6 line of g, or its digraph6 line with both arcs of every edge
+std::string to_graph6(const graph& g, bool digraph = false);
+
+// Many graph6 lines decoded into one flat array of adjacency rows. The
+// storage is kept from batch to batch.
+class graph6_batch {
+  public:
+	// Replaces the graphs with those of the lines. False if some line is
+	// malformed; its graph has NOT_GRAPH6 vertices and no rows.
+	bool decode(const std::string_view* lines, std::size_t count);
+
+	std::size_t size() const;
+
+	int num_vertices(std::size_t i) const;
+
+	const index_t* rows(std::size_t i) const;
+
+  private:
+	std::vector<index_t> rows_;
+	std::vector<std::uint32_t> offsets_;
+	std::vector<std::int8_t> sizes_;
+};
+
+#endif
\ No newline at end of file
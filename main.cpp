@@ -1,7 +1,16 @@
 #include "graph.hpp"
 #include "tests.hpp"
+#include "benchmark.hpp"
 #include "vertex_coloring.hpp"
 #include "minimax.hpp"
+#include "dfpn.hpp"
+#include "batch.hpp"
+#include "bench_suite.hpp"
+#include "result_store.hpp"
+#include "mapped_file.hpp"
+#include "transposition_table.hpp"
+#include "symmetry.hpp"
+#include "game_state.hpp"
 #include "common.hpp"
 
 #include <iostream>
@@ -10,11 +19,17 @@
 #include <queue>
 #include <chrono>
 #include <fstream>
+#include <functional>
 #include <string>
+#include <memory>
+#include <thread>
 #include <unordered_set>
+#include <vector>
 #include <random>
+#include <sstream>
 
-void verify_g6_batch(const std::string& file, const std::string& out, bool verbose = true);
+bool verify_g6_batch(const std::string& file, const std::string& out, const solver_factory& make_solver,
+	batch_options options, shard_spec shard);
 
 const std::unordered_map<std::string, std::pair<int, int>> allowed_types = {
 	{"planar", {4, 11}},
@@ -29,9 +44,11 @@ const std::string OUTPUT_DESTINATION = "C:\\Dropbox\\code\\vertex-col-game\\resu
 
 int find_k_from_args(const std::unordered_set<std::string>& args);
 
-std::pair<std::string, std::pair<int, int>> find_type_from_args(const std::unordered_set<std::string>& args);
+int find_int_option_from_args(const std::unordered_set<std::string>& args, const std::string& name, int fallback);
+
+std::string find_option_from_args(const std::unordered_set<std::string>& args, const std::string& name, const std::string& fallback);
 
-bool contains_result(const std::string& file, const std::string& g);
+std::pair<std::string, std::pair<int, int>> find_type_from_args(const std::unordered_set<std::string>& args);
 
 std::string get_graph6_file(const std::string& family, int k);
 
@@ -41,11 +58,88 @@ int main(int argc, char** argv)
 {
 	//test_all();
 
-	if (argc < 2 || argc > 4) {
-		std::cout << "Usage: ./vertex-col-game <k> <type> [<all>] [<tests>]\n"
+	if (argc >= 4 && std::string(argv[1]) == "merge") {
+		const std::vector<std::string> inputs(argv + 3, argv + argc);
+		const merge_report report = merge_results(inputs, argv[2]);
+		if (report.failed_ > 0) {
+			std::cout << "ERROR: " << report.failed_ << " files could not be read or written, "
+				<< argv[2] << " was left unchanged\n";
+			return EXIT_FAILURE;
+		}
+
+		std::cout << "Merged " << report.results_ << " results into " << argv[2] << " (" 
+			<< report.duplicates_ << " duplicates, " << report.conflicts_ << " conflicts, "
+			<< report.dropped_ << " malformed lines)\n";
+		return report.conflicts_ == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (argc >= 2 && std::string(argv[1]) == "bench-suite") {
+		const std::unordered_set<std::string> args(argv + 2, argv + argc);
+
+		suite_options suite;
+		suite.trials_ = find_int_option_from_args(args, "trials", suite.trials_);
+		suite.baseline_ = find_option_from_args(args, "baseline", "");
+		suite.save_ = find_option_from_args(args, "save", "");
+
+		const int threshold = find_int_option_from_args(args, "threshold", static_cast<int>(100 * DEFAULT_SUITE_THRESHOLD));
+		if (suite.trials_ <= 0 || threshold == NO_K) {
+			std::cout << "ERROR: trials=<n> must be positive and threshold=<percent> a number\n";
+			return EXIT_FAILURE;
+		}
+		suite.threshold_ = threshold / 100.0;
+
+		std::istringstream configs(find_option_from_args(args, "configs", ""));
+		for (std::string config; std::getline(configs, config, ','); ) {
+			suite.configs_.push_back(config);
+		}
+
+		return run_bench_suite(suite, std::cout) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (argc < 2) {
+		std::cout << "Usage: ./vertex-col-game <k> <type> [<all>] [<options>] [<tests>] [<bench>]\n"
+			<< "       ./vertex-col-game merge <output> <input>...\n"
+			<< "       ./vertex-col-game bench-suite [trials=<n>] [configs=<a,b,...>] [baseline=<file>]\n"
+			<< "           [save=<file>] [threshold=<percent>]\n"
 			<< "<k>:       the order of the family\n"
 			<< "<type>:    the type of the family (e.g., outerplanar)\n"
-			<< "<tests>:   whether to only run tests\n";
+			<< "<options>: tt=<MiB>     size of the transposition table (default " << DEFAULT_TT_MEGABYTES << ")\n"
+			<< "           alice-order=<natural|static|history>, bob-order=<...>\n"
+			<< "                        move ordering of each player (default static)\n"
+			<< "           engine=<alphabeta|dfpn|tablebase>\n"
+			<< "                        search engine (default alphabeta); tt=<MiB> sizes its table\n"
+			<< "           tablebase=<MiB>\n"
+			<< "                        largest tablebase per graph (default " << DEFAULT_TABLEBASE_MEGABYTES << ", 0 for none);\n"
+			<< "                        alphabeta hands hard graphs over to it\n"
+			<< "           threads=<n>  threads searching each graph (default 1, alphabeta and\n"
+			<< "                        tablebase only)\n"
+			<< "           workers=<n>  graphs solved in parallel, each with its own table\n"
+			<< "                        (default: number of cores)\n"
+			<< "           order=<input|completion>\n"
+			<< "                        order of the results (default input, or completion with\n"
+			<< "                        a schedule)\n"
+			<< "           schedule=<graphs>\n"
+			<< "                        graphs read ahead and solved heaviest first, by a\n"
+			<< "                        prediction from random probes of the game tree (default\n"
+			<< "                        0: in input order)\n"
+			<< "           estimate-log=<file>\n"
+			<< "                        appends the predicted and actual nodes of every graph\n"
+			<< "           stats=<none|csv|json>\n"
+			<< "                        statistics of every solve, written after each result\n"
+			<< "                        (default none)\n"
+			<< "           progress=<seconds>\n"
+			<< "                        seconds between progress lines with the throughput, an\n"
+			<< "                        ETA and the slowest graph (default " << DEFAULT_PROGRESS_SECONDS << ", 0 for\n"
+			<< "                        none); SIGUSR1 dumps the counters so far\n"
+			<< "<tests>:   whether to only run tests\n"
+			<< "<bench>:   whether to only run benchmarks; bench=primitives only times the\n"
+			<< "           primitives, with hardware counters where perf_event_open allows\n"
+			<< "merge:     combines result files (e.g., of shards) into <output>, keeping the\n"
+			<< "           first result of every graph; <output> may be one of the inputs\n"
+			<< "bench-suite: solves a corpus of graphs with known answers with every engine\n"
+			<< "           configuration (alphabeta, fixed, dfpn, tablebase) and fails on a wrong\n"
+			<< "           answer, or on a median slower than in the baseline by more than\n"
+			<< "           threshold (default " << static_cast<int>(100 * DEFAULT_SUITE_THRESHOLD) << ")\n";
 		return EXIT_FAILURE;
 	}
 	
@@ -56,6 +150,16 @@ int main(int argc, char** argv)
 		return EXIT_SUCCESS;
 	}
 
+	if (find_option_from_args(args, "bench", "") == "primitives") {
+		benchmark_primitives();
+		return EXIT_SUCCESS;
+	}
+
+	if (args.contains("bench")) {
+		benchmark_all();
+		return EXIT_SUCCESS;
+	}
+
 	const int k = find_k_from_args(args);
 	if (k == NO_K) {
 		std::cout << "ERROR: missing <k> from args\n";
@@ -77,68 +181,172 @@ int main(int argc, char** argv)
 	const auto g6 = get_graph6_file(graph_type.first, k);
 	const auto out = get_graph6_output(graph_type.first, k);
 
-	verify_g6_batch(g6, out);
-}
+	const int tt_megabytes = find_int_option_from_args(args, "tt", DEFAULT_TT_MEGABYTES);
+	if (tt_megabytes <= 0) {
+		std::cout << "ERROR: tt=<MiB> must be positive\n";
+		return EXIT_FAILURE;
+	}
 
-bool contains_result(const std::string& file, const std::string& g) {
-	std::ifstream ifs(file);
-	std::string line;
+	search_options options;
+	if (!parse_ordering(find_option_from_args(args, "alice-order", to_string(options.alice_ordering_)), options.alice_ordering_) ||
+		!parse_ordering(find_option_from_args(args, "bob-order", to_string(options.bob_ordering_)), options.bob_ordering_)) {
+		std::cout << "ERROR: move orderings must be one of natural, static or history\n";
+		return EXIT_FAILURE;
+	}
 
-	while (std::getline(ifs, line)) {
-		const auto cutoff = std::string(line.begin(), std::find(line.begin(), line.end(), ' '));
-		if (cutoff == g)
-			return true;
+	if (!parse_engine(find_option_from_args(args, "engine", to_string(options.engine_)), options.engine_)) {
+		std::cout << "ERROR: engine must be one of alphabeta, dfpn or tablebase\n";
+		return EXIT_FAILURE;
 	}
 
-	return false;
-}
+	const int tablebase_megabytes = find_int_option_from_args(args, "tablebase", static_cast<int>(options.tablebase_megabytes_));
+	if (tablebase_megabytes < 0) {
+		std::cout << "ERROR: tablebase=<MiB> must not be negative\n";
+		return EXIT_FAILURE;
+	}
+	options.tablebase_megabytes_ = tablebase_megabytes;
 
-void verify_g6_batch(const std::string& file, const std::string& out, bool verbose) {
-	std::ifstream ifs(file);
-	std::string line;
+	options.threads_ = find_int_option_from_args(args, "threads", options.threads_);
+	if (options.threads_ <= 0) {
+		std::cout << "ERROR: threads=<n> must be positive\n";
+		return EXIT_FAILURE;
+	}
+
+	batch_options batch;
+	batch.workers_ = find_int_option_from_args(args, "workers", std::max<int>(std::thread::hardware_concurrency(), 1));
+	if (batch.workers_ <= 0) {
+		std::cout << "ERROR: workers=<n> must be positive\n";
+		return EXIT_FAILURE;
+	}
 
-	const int num_graphs = get_line_count(file);
-	int curr_graph = 0;
+	const int schedule = find_int_option_from_args(args, "schedule", 0);
+	if (schedule == NO_K) {
+		std::cout << "ERROR: schedule=<graphs> must be a number\n";
+		return EXIT_FAILURE;
+	}
+	batch.schedule_window_ = schedule;
 
-	while (std::getline(ifs, line)) {
-		++curr_graph;
-		graph g = read_graph6(line);
+	// Scheduled results come far out of input order, and would otherwise
+	// wait for every graph read before them
+	const auto order = find_option_from_args(args, "order", schedule > 0 ? "completion" : "input");
+	if (order != "input" && order != "completion") {
+		std::cout << "ERROR: order must be one of input or completion\n";
+		return EXIT_FAILURE;
+	}
+	batch.completion_order_ = order == "completion";
 
-		if (verbose) {
-			std::cerr << "Processing graph " << curr_graph << " / " << num_graphs << " ...\n";
+	const int progress_seconds = find_int_option_from_args(args, "progress", static_cast<int>(DEFAULT_PROGRESS_SECONDS));
+	if (progress_seconds == NO_K) {
+		std::cout << "ERROR: progress=<seconds> must be a number\n";
+		return EXIT_FAILURE;
+	}
+	batch.progress_seconds_ = progress_seconds;
+
+	if (!parse_stats_format(find_option_from_args(args, "stats", "none"), batch.stats_)) {
+		std::cout << "ERROR: stats must be one of none, csv or json\n";
+		return EXIT_FAILURE;
+	}
+
+	shard_spec shard;
+	if (!parse_shard(find_option_from_args(args, "shard", "0/1"), shard)) {
+		std::cout << "ERROR: shard=<i>/<n> needs 0 <= i < n\n";
+		return EXIT_FAILURE;
+	}
+
+	const auto shard_by = find_option_from_args(args, "shard-by", "bytes");
+	if (shard_by != "bytes" && shard_by != "lines") {
+		std::cout << "ERROR: shard-by must be one of bytes or lines\n";
+		return EXIT_FAILURE;
+	}
+	shard.by_lines_ = shard_by == "lines";
+
+	// Every worker gets its own table
+	solver_factory make_solver = [tt_megabytes, options]() -> outcome_solver {
+		if (options.engine_ == Engine::ProofNumber) {
+			auto table = std::make_shared<pn_table>(tt_megabytes);
+			return [table, options](const graph& g, int num_cols, const graph_symmetry& sym, search_counters& counters) {
+				return solve_outcome_dfpn(g, num_cols, *table, &sym, &counters, options);
+			};
 		}
 
-		if (contains_result(out, line)) {
-			continue;
+		auto tt = std::make_shared<transposition_table>(tt_megabytes);
+		return [tt, options](const graph& g, int num_cols, const graph_symmetry& sym, search_counters& counters) {
+			return solve_outcome(g, num_cols, *tt, &sym, &counters, options);
+		};
+	};
+
+	// Shards write to their own files, to be combined with merge
+	const auto shard_out = shard.count_ > 1
+		? out + "." + std::to_string(shard.index_) + "-of-" + std::to_string(shard.count_)
+		: out;
+
+	// Appended to, as the results are
+	std::ofstream estimate_log;
+	const auto estimate_log_file = find_option_from_args(args, "estimate-log", "");
+	if (!estimate_log_file.empty()) {
+		estimate_log.open(estimate_log_file, std::ios::app);
+		if (!estimate_log) {
+			std::cout << "ERROR: could not open " << estimate_log_file << "\n";
+			return EXIT_FAILURE;
 		}
+		batch.estimate_log_ = &estimate_log;
+	}
 
-		int num_cols = 0;
+	if (!verify_g6_batch(g6, shard_out, make_solver, batch, shard)) {
+		return EXIT_FAILURE;
+	}
+}
 
-		// Start from 4 colors (note increment)
-		if (has_k_four(g)) {
-			num_cols = 3;
-		}
-		else {
-			// Start from 3 colors (note increment)
-			if (has_triangle(g)) {
-				num_cols = 2;
-			}
+bool verify_g6_batch(const std::string& file, const std::string& out, const solver_factory& make_solver,
+	batch_options options, shard_spec shard) {
+	// Lines are read straight from the mapping, so there is no pass over the
+	// file up front
+	const mapped_file input(file);
+	if (!input.is_open()) {
+		std::cout << "ERROR: could not read " << file << "\n";
+		return false;
+	}
+
+	shard_lines lines(input, shard);
+
+	// Results are appended to out; those already there are skipped
+	result_store store(out);
+	if (!store.is_open()) {
+		std::cout << "ERROR: could not open " << out << " for writing\n";
+		return false;
+	}
+
+	if (options.verbose_) {
+		std::cerr << "Loaded " << store.size() << " results from " << out;
+		if (store.num_dropped() > 0) {
+			std::cerr << ", dropped " << store.num_dropped() << " incomplete lines";
 		}
+		std::cerr << "\n";
+	}
+
+	options.input_fraction_ = [&lines]() {
+		const std::uint64_t size = lines.end() - lines.begin();
+		return size > 0 ? std::min(static_cast<double>(lines.position() - lines.begin()) / size, 1.0) : 1.0;
+	};
 
-		Victory win = Victory::Bob;
-		do {
-			++num_cols;
-			const auto gameplay = play_optimally(g, num_cols);
-			win = gameplay.first;
-		} while (win != Victory::Alice);
+	const batch_report report = run_g6_batch([&lines](std::string_view& line) { return lines.next(line); },
+		store.stream(), make_solver, options, [&store](std::string_view line) { return store.contains(line); });
 
-		std::cout << line << " " << num_cols << "\n";
+	if (options.verbose_) {
+		print_batch_report(report, std::cerr);
 	}
+
+	if (!store.flush()) {
+		std::cout << "ERROR: could not write every result to " << out << "\n";
+		return false;
+	}
+
+	return true;
 }
 
 int find_k_from_args(const std::unordered_set<std::string>& args) {
 	for (const auto& arg : args) {
-		if (std::all_of(arg.cbegin(), arg.cend(), std::isdigit)) {
+		if (std::all_of(arg.cbegin(), arg.cend(), [](unsigned char ch) { return std::isdigit(ch); })) {
 			return std::stoi(arg);
 		}
 	}
@@ -146,6 +354,32 @@ int find_k_from_args(const std::unordered_set<std::string>& args) {
 	return NO_K;
 }
 
+int find_int_option_from_args(const std::unordered_set<std::string>& args, const std::string& name, int fallback) {
+	const auto value = find_option_from_args(args, name, NO_TYPE);
+
+	if (value == NO_TYPE) {
+		return fallback;
+	}
+
+	if (value.empty() || !std::all_of(value.cbegin(), value.cend(), [](unsigned char ch) { return std::isdigit(ch); })) {
+		return NO_K;
+	}
+
+	return std::stoi(value);
+}
+
+std::string find_option_from_args(const std::unordered_set<std::string>& args, const std::string& name, const std::string& fallback) {
+	const std::string prefix = name + "=";
+
+	for (const auto& arg : args) {
+		if (arg.starts_with(prefix)) {
+			return arg.substr(prefix.size());
+		}
+	}
+
+	return fallback;
+}
+
 std::pair<std::string, std::pair<int, int>> find_type_from_args(const std::unordered_set<std::string>& args) {
 	for (const auto& arg : args) {
 		const auto it = allowed_types.find(arg);
@@ -0,0 +1,322 @@
+#include "mapped_file.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cctype>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+	// Bytes of a shard indexed at a time
+	static constexpr std::uint64_t LINE_BLOCK_BYTES = 1 << 16;
+
+#ifdef HAS_SSE2
+	// Bit i is set if first[i] is '\n'
+	unsigned newline_mask(const char* first) {
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+		return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n'))));
+	}
+#endif
+
+	// The offset just past the n-th '\n' (counting from 1), or size
+	std::uint64_t after_nth_newline(const char* data, std::uint64_t size, std::uint64_t n) {
+		if (n == 0) {
+			return 0;
+		}
+
+		std::uint64_t i = 0;
+
+#ifdef HAS_SSE2
+		for (; i + 16 <= size; i += 16) {
+			unsigned mask = newline_mask(data + i);
+			const auto count = static_cast<std::uint64_t>(std::popcount(mask));
+
+			if (count >= n) {
+				for (; n > 1; --n) {
+					mask &= mask - 1;
+				}
+
+				return i + std::countr_zero(mask) + 1;
+			}
+
+			n -= count;
+		}
+#endif
+
+		for (; i < size; ++i) {
+			if (data[i] == '\n' && --n == 0) {
+				return i + 1;
+			}
+		}
+
+		return size;
+	}
+
+	// The start of the first line that starts at or after offset
+	std::uint64_t line_start_from(const char* data, std::uint64_t size, std::uint64_t offset) {
+		if (offset == 0 || offset >= size) {
+			return std::min(offset, size);
+		}
+
+		const char* newline = find_newline(data + offset - 1, data + size);
+		return newline == data + size ? size : newline - data + 1;
+	}
+}
+
+mapped_file::mapped_file(const std::string& path) {
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return;
+	}
+	file_ = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size)) {
+		return;
+	}
+
+	size_ = static_cast<std::size_t>(size.QuadPart);
+	if (size_ == 0) {
+		open_ = true;
+		return;
+	}
+
+	mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping_ != nullptr) {
+		data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+		open_ = data_ != nullptr;
+	}
+#else
+	const int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return;
+	}
+
+	struct stat st;
+	if (::fstat(fd, &st) == 0) {
+		size_ = static_cast<std::size_t>(st.st_size);
+
+		if (size_ == 0) {
+			open_ = true;
+		}
+		else {
+			void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+
+			if (p != MAP_FAILED) {
+				::madvise(p, size_, MADV_SEQUENTIAL);
+				data_ = static_cast<const char*>(p);
+				open_ = true;
+			}
+		}
+	}
+
+	// The mapping outlives the descriptor
+	::close(fd);
+#endif
+}
+
+mapped_file::~mapped_file() {
+#ifdef _WIN32
+	if (data_ != nullptr) {
+		UnmapViewOfFile(data_);
+	}
+	if (mapping_ != nullptr) {
+		CloseHandle(mapping_);
+	}
+	if (file_ != nullptr) {
+		CloseHandle(file_);
+	}
+#else
+	if (data_ != nullptr) {
+		::munmap(const_cast<char*>(data_), size_);
+	}
+#endif
+}
+
+bool mapped_file::is_open() const {
+	return open_;
+}
+
+const char* mapped_file::data() const {
+	return data_;
+}
+
+std::size_t mapped_file::size() const {
+	return size_;
+}
+
+const char* find_newline(const char* first, const char* last) {
+#ifdef HAS_SSE2
+	for (; last - first >= 16; first += 16) {
+		const unsigned mask = newline_mask(first);
+
+		if (mask != 0) {
+			return first + std::countr_zero(mask);
+		}
+	}
+#endif
+
+	for (; first != last && *first != '\n'; ++first) { }
+	return first;
+}
+
+void index_newlines(const char* base, const char* first, const char* last, std::vector<std::uint64_t>& ends) {
+#ifdef HAS_SSE2
+	for (; last - first >= 16; first += 16) {
+		for (unsigned mask = newline_mask(first); mask != 0; mask &= mask - 1) {
+			ends.push_back(first - base + std::countr_zero(mask));
+		}
+	}
+#endif
+
+	for (; first != last; ++first) {
+		if (*first == '\n') {
+			ends.push_back(first - base);
+		}
+	}
+}
+
+std::uint64_t count_newlines(const char* first, const char* last) {
+	std::uint64_t count = 0;
+
+#ifdef HAS_SSE2
+	for (; last - first >= 16; first += 16) {
+		count += std::popcount(newline_mask(first));
+	}
+#endif
+
+	return count + std::count(first, last, '\n');
+}
+
+bool parse_shard(const std::string& text, shard_spec& shard) {
+	const auto slash = text.find('/');
+	const auto is_number = [](const std::string& s) {
+		return !s.empty() && s.size() < 10 && std::all_of(s.cbegin(), s.cend(), [](unsigned char ch) { return std::isdigit(ch); });
+	};
+
+	if (slash == std::string::npos || !is_number(text.substr(0, slash)) || !is_number(text.substr(slash + 1))) {
+		return false;
+	}
+
+	const int index = std::stoi(text.substr(0, slash));
+	const int count = std::stoi(text.substr(slash + 1));
+
+	if (count <= 0 || index >= count) {
+		return false;
+	}
+
+	shard.index_ = index;
+	shard.count_ = count;
+	return true;
+}
+
+shard_lines::shard_lines(const mapped_file& file, shard_spec shard)
+	: data_(file.data()),
+	size_(file.size())
+{
+	assert(shard.index_ >= 0 && shard.index_ < shard.count_);
+	const auto index = static_cast<std::uint64_t>(shard.index_);
+	const auto count = static_cast<std::uint64_t>(shard.count_);
+
+	if (shard.by_lines_) {
+		const std::uint64_t lines = count_newlines(data_, data_ + size_) + (size_ > 0 && data_[size_ - 1] != '\n');
+
+		begin_ = after_nth_newline(data_, size_, lines * index / count);
+		end_ = after_nth_newline(data_, size_, lines * (index + 1) / count);
+	}
+	else {
+		begin_ = line_start_from(data_, size_, size_ * index / count);
+		end_ = line_start_from(data_, size_, size_ * (index + 1) / count);
+	}
+
+	position_ = scanned_ = begin_;
+}
+
+bool shard_lines::next(std::string_view& line) {
+	for (;;) {
+		if (cursor_ == ends_.size()) {
+			refill();
+
+			if (cursor_ == ends_.size()) {
+				return false;
+			}
+		}
+
+		const std::uint64_t start = position_;
+		const std::uint64_t stop = ends_[cursor_++];
+		position_ = std::min(stop + 1, size_);
+
+		line = std::string_view(data_ + start, stop - start);
+		if (!line.empty() && line.back() == '\r') {
+			line.remove_suffix(1);
+		}
+
+		if (!line.empty()) {
+			return true;
+		}
+	}
+}
+
+std::uint64_t shard_lines::begin() const {
+	return begin_;
+}
+
+std::uint64_t shard_lines::end() const {
+	return end_;
+}
+
+std::uint64_t shard_lines::position() const {
+	return position_;
+}
+
+void shard_lines::refill() {
+	ends_.clear();
+	cursor_ = 0;
+
+	if (position_ >= end_) {
+		return;
+	}
+
+	while (ends_.empty() && scanned_ < size_) {
+		if (scanned_ < end_) {
+			const std::uint64_t stop = std::min(end_, scanned_ + LINE_BLOCK_BYTES);
+			index_newlines(data_, data_ + scanned_, data_ + stop, ends_);
+			scanned_ = stop;
+		}
+		else {
+			// The last line of the shard runs past its end
+			const char* newline = find_newline(data_ + scanned_, data_ + size_);
+			ends_.push_back(newline - data_);
+			scanned_ = std::min<std::uint64_t>(newline - data_ + 1, size_);
+		}
+	}
+
+	// A last line without a line break
+	if (ends_.empty()) {
+		ends_.push_back(size_);
+	}
+
+	// Only lines that start inside the shard
+	for (std::size_t i = 1; i < ends_.size(); ++i) {
+		if (ends_[i - 1] + 1 >= end_) {
+			ends_.resize(i);
+			break;
+		}
+	}
+}
\ No newline at end of file
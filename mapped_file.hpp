@@ -0,0 +1,91 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A whole file mapped read-only into memory. Pages are only read when
+// touched, so opening costs the same for any file size.
+class mapped_file {
+  public:
+	explicit mapped_file(const std::string& path);
+	~mapped_file();
+	mapped_file(const mapped_file&) = delete;
+	mapped_file& operator=(const mapped_file&) = delete;
+
+	// False if the file could not be opened or mapped
+	bool is_open() const;
+
+	const char* data() const;
+	std::size_t size() const;
+
+  private:
+	const char* data_{ nullptr };
+	std::size_t size_{ 0 };
+	bool open_{ false };
+
+#ifdef _WIN32
+	void* file_{ nullptr };
+	void* mapping_{ nullptr };
+#endif
+};
+
+// The first '\n' in [first, last), or last. Scans 16 bytes per step with
+// SSE2 where available.
+const char* find_newline(const char* first, const char* last);
+
+// Appends the offsets from base of every '\n' in [first, last) to ends
+void index_newlines(const char* base, const char* first, const char* last, std::vector<std::uint64_t>& ends);
+
+std::uint64_t count_newlines(const char* first, const char* last);
+
+// Which part of an input a run processes: shard index_ of count_, where
+// shards are equal byte ranges or, with by_lines_, equal line ranges. A
+// line belongs to the byte range in which it starts.
+struct shard_spec {
+	int index_{ 0 };
+	int count_{ 1 };
+	bool by_lines_{ false };
+};
+
+// Parses "i/N" with 0 <= i < N
+bool parse_shard(const std::string& text, shard_spec& shard);
+
+// Hands out the lines of one shard of a mapped file as views into the
+// mapping, without copying. Line ends are indexed a block at a time as the
+// lines are consumed, so pages outside the shard are not touched, except
+// for the end of its last line. Shards by lines first count the lines of
+// the whole file.
+class shard_lines {
+  public:
+	shard_lines(const mapped_file& file, shard_spec shard = shard_spec());
+
+	// The next nonempty line, without its line break
+	bool next(std::string_view& line);
+
+	// Byte range of the shard and the bytes consumed so far
+	std::uint64_t begin() const;
+	std::uint64_t end() const;
+	std::uint64_t position() const;
+
+  private:
+	void refill();
+
+	const char* data_;
+	std::uint64_t size_;
+
+	// Lines starting in [begin_, end_) belong to the shard
+	std::uint64_t begin_{ 0 };
+	std::uint64_t end_{ 0 };
+
+	// Start of the next line, and how far ends_ has been indexed
+	std::uint64_t position_{ 0 };
+	std::uint64_t scanned_{ 0 };
+
+	std::vector<std::uint64_t> ends_;
+	std::size_t cursor_{ 0 };
+};
+
+#endif
\ No newline at end of file
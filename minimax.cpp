@@ -2,73 +2,167 @@
 
 #include "move.hpp"
 #include "game_state.hpp"
-#include "vertex_coloring.hpp"
+#include "bitboard_coloring.hpp"
+#include "transposition_table.hpp"
+#include "symmetry.hpp"
+#include "wide_search.hpp"
+#include "fixed_search.hpp"
+#include "tablebase.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <iomanip>
+#include <thread>
 #include <vector>
 
+namespace {
+	// Scores encode the level at which the game ends. The table stores them
+	// relative to the node, so they stay valid at any distance from the root.
+	int score_to_tt(int score, int level) {
+		return score > 0 ? score - level : score + level;
+	}
+
+	int score_from_tt(int score, int level) {
+		return score > 0 ? score + level : score - level;
+	}
+
+	// A move that keeps the player to move winning, or the first legal move
+	// if there is none
+	move select_line_move(game_state& node) {
+		const bool alice = node.col_.num_colored_vertices() % 2 == 0;
+
+		for (const move m : node.generate_moves()) {
+			node.col_.color_vertex(m.vertex_, m.color_);
+			node.remove(m.vertex_);
+
+			const bool child = alice_wins(node);
+
+			node.col_.uncolor_vertex(m.vertex_, m.color_);
+			node.add(m.vertex_);
+
+			if (child == alice) {
+				return m;
+			}
+		}
+
+		return node.generate_moves().front();
+	}
+}
+
 std::pair<move, int> minimax(game_state& node, bool max_player, int alpha, int beta, int level) {
+	node.counters_.count_node();
+	node.counters_.record_node(node.col_.num_colored_vertices());
+
 	if (node.col_.is_colored() && !node.col_.has_conflict()) {
+		node.counters_.record_terminal();
 		return { move(), 1 + level }; // max_player wins
 	}
 
 	if (node.col_.is_deadend() || node.col_.has_conflict()) {
+		node.counters_.record_terminal();
 		return { move(), -1 - level }; // min_player wins
 	}
 
+	if (node.is_safe_win()) {
+		// The coloring ends complete, whatever the moves
+		return { node.generate_moves().front(), 1 + level + std::popcount(node.col_.uncolored()) };
+	}
+
+	const index_t key = node.col_.zobrist_hash();
+	move hint;
+
+	if (node.tt_ != nullptr) {
+		tt_entry e;
+		const bool found = node.tt_->probe(key, e);
+
+		if (found) {
+			const std::pair<move, int> hit(move(e.vertex_, e.color_), score_from_tt(e.value_, level));
+
+			if (e.bound_ == Bound::Exact ||
+				(e.bound_ == Bound::Lower && hit.second >= beta) ||
+				(e.bound_ == Bound::Upper && hit.second <= alpha)) {
+				node.counters_.record_probe(true);
+				return hit;
+			}
+
+			hint = hit.first;
+		}
+
+		node.counters_.record_probe(false);
+	}
+
+	const int alpha_orig = alpha;
+	const int beta_orig = beta;
 	const int value = max_player ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
 	std::pair<move, int> best_move(move(), value);
 
 	// For each child node
-	index_t uncols = node.uncols_;
-	for (unsigned long v; uncols != 0; uncols &= ~(1ULL << v)) {
-		_BitScanForward64(&v, uncols);
-		index_t col = node.col_.get_allowed_colors(v);
-
-		for (unsigned long j; col != 0; col &= ~(1ULL << j))
-		{
-			// Now, (v, j) is a child node to consider
-			_BitScanForward64(&j, col);
-
-			node.col_.color_vertex(v, j);
-			node.remove(v);
-
-			const std::pair<move, int> eval_score = minimax(node, !max_player, alpha, beta, level + 1);
-
-			node.col_.uncolor_vertex(v, j);
-			node.add(v);
-
-			if (max_player) {
-				if (eval_score.second > best_move.second) {
-					best_move = std::make_pair(move(v, j), eval_score.second);
-				}
-				if (eval_score.second >= beta) {
-					break;
-				}
-				alpha = std::max(alpha, eval_score.second);
+	for (const move m : node.generate_moves(hint)) {
+		node.col_.color_vertex(m.vertex_, m.color_);
+		node.remove(m.vertex_);
+
+		const std::pair<move, int> eval_score = minimax(node, !max_player, alpha, beta, level + 1);
+
+		node.col_.uncolor_vertex(m.vertex_, m.color_);
+		node.add(m.vertex_);
+
+		if (max_player) {
+			if (eval_score.second > best_move.second) {
+				best_move = std::make_pair(m, eval_score.second);
 			}
-			else {
-				if (eval_score.second < best_move.second) {
-					best_move = std::make_pair(move(v, j), eval_score.second);
-				}
-				if (eval_score.second <= alpha) {
-					break;
-				}
-				beta = std::min(beta, eval_score.second);
+			if (eval_score.second >= beta) {
+				node.ordering_.record_cutoff(node.col_, m);
+				node.counters_.record_cutoff();
+				break;
 			}
+			alpha = std::max(alpha, eval_score.second);
+		}
+		else {
+			if (eval_score.second < best_move.second) {
+				best_move = std::make_pair(m, eval_score.second);
+			}
+			if (eval_score.second <= alpha) {
+				node.ordering_.record_cutoff(node.col_, m);
+				node.counters_.record_cutoff();
+				break;
+			}
+			beta = std::min(beta, eval_score.second);
 		}
 	}
 
+	if (node.tt_ != nullptr) {
+		const Bound bound = best_move.second <= alpha_orig ? Bound::Upper :
+			(best_move.second >= beta_orig ? Bound::Lower : Bound::Exact);
+
+		node.tt_->store(key, score_to_tt(best_move.second, level), bound, 
+			node.col_.num_vertices() - node.col_.num_colored_vertices(), best_move.first);
+	}
+
 	return best_move;
 }
 
 std::pair<Victory, std::queue<move>> play_optimally(const graph& g, int num_cols) {
-	vertex_coloring col(g, num_cols);
+	transposition_table tt;
+	return play_optimally(g, num_cols, tt);
+}
+
+std::pair<Victory, std::queue<move>> play_optimally(const graph& g, int num_cols, transposition_table& tt) {
+	// minimax() runs on bitboards only
+	if (g.num_vertices() > BIT_LEN) {
+		solve_outcome_wide(g, num_cols, tt);
+		return principal_line_wide(g, num_cols, tt);
+	}
+
+	bitboard_coloring col(g, num_cols);
 	bool max_player = true;
-	game_state master(col);
+
+	// Entries stay valid between the plies below, but not across graphs
+	tt.new_search();
+	const graph_symmetry sym(g);
+	game_state master(col, &tt, &sym);
 
 	std::queue<move> moves;
-	//TranspositionTable t;
 
 	for (int i = 0; i < g.num_vertices(); ++i) {
 		const auto best_move = minimax(master, max_player);
@@ -92,6 +186,228 @@ std::pair<Victory, std::queue<move>> play_optimally(const graph& g, int num_cols
 		return std::make_pair(Victory::Bob, moves);
 }
 
+bool alice_wins(game_state& node) {
+	node.counters_.count_node();
+	node.counters_.record_node(node.col_.num_colored_vertices());
+
+	if (node.stopped()) {
+		return false;
+	}
+
+	if (node.col_.is_colored() && !node.col_.has_conflict()) {
+		node.counters_.record_terminal();
+		return true;
+	}
+
+	if (node.col_.is_deadend() || node.col_.has_conflict()) {
+		node.counters_.record_terminal();
+		return false;
+	}
+
+	if (node.is_safe_win()) {
+		return true;
+	}
+
+	index_t defusers = ALL_ONES;
+
+	if (node.is_threat_win(defusers)) {
+		return false;
+	}
+
+	if (node.is_endgame()) {
+		return node.solve_endgame();
+	}
+
+	const index_t key = node.col_.zobrist_hash();
+
+	if (node.tt_ != nullptr) {
+		tt_entry e;
+		const bool hit = node.tt_->probe(key, e);
+		node.counters_.record_probe(hit);
+
+		if (hit) {
+			return e.value_ > 0;
+		}
+	}
+
+	const bool alice = node.col_.num_colored_vertices() % 2 == 0;
+	bool result = !alice;
+	move best;
+
+	for (const move m : node.generate_moves(move(), defusers)) {
+		node.col_.color_vertex(m.vertex_, m.color_);
+		node.remove(m.vertex_);
+
+		const bool child = alice_wins(node);
+
+		node.col_.uncolor_vertex(m.vertex_, m.color_);
+		node.add(m.vertex_);
+
+		if (node.stopped()) {
+			return false;
+		}
+
+		if (child == alice) {
+			node.ordering_.record_cutoff(node.col_, m);
+			node.counters_.record_cutoff();
+			result = child;
+			best = m;
+			break;
+		}
+	}
+
+	if (node.tt_ != nullptr) {
+		node.tt_->store(key, result ? 1 : -1, Bound::Exact,
+			node.col_.num_vertices() - node.col_.num_colored_vertices(), best);
+	}
+
+	return result;
+}
+
+Victory solve_outcome(const graph& g, int num_cols) {
+	transposition_table tt;
+	return solve_outcome(g, num_cols, tt);
+}
+
+Victory solve_outcome(const graph& g, int num_cols, transposition_table& tt, 
+	const graph_symmetry* sym, search_counters* counters, const search_options& options) {
+	if (g.num_vertices() > BIT_LEN) {
+		return solve_outcome_wide(g, num_cols, tt, counters, options);
+	}
+
+	const std::size_t bytes = tablebase_bytes(g.num_vertices(), num_cols);
+
+	if (bytes > options.tablebase_megabytes_ << 20) {
+		search_options unlimited = options;
+		unlimited.node_limit_ = 0;
+		return *try_solve_outcome(g, num_cols, tt, sym, counters, unlimited);
+	}
+
+	// Alpha-beta solves most games long before a tablebase would, so it goes
+	// first, up to a node limit. Then the tablebase takes over, and games
+	// that blow up the search cost at most about twice the tablebase.
+	if (options.engine_ != Engine::Tablebase) {
+		search_options limited = options;
+		limited.node_limit_ = std::max(8 * bytes >> TABLEBASE_NODE_SHIFT, TABLEBASE_MIN_NODES);
+
+		if (const auto outcome = try_solve_outcome(g, num_cols, tt, sym, counters, limited)) {
+			return *outcome;
+		}
+	}
+
+	return solve_outcome_tablebase(g, num_cols, counters, options);
+}
+
+std::optional<Victory> try_solve_outcome(const graph& g, int num_cols, transposition_table& tt,
+	const graph_symmetry* sym, search_counters* counters, const search_options& options) {
+	if (g.num_vertices() > BIT_LEN) {
+		return solve_outcome_wide(g, num_cols, tt, counters, options);
+	}
+
+	if (sym == nullptr) {
+		const graph_symmetry own(g);
+		return try_solve_outcome(g, num_cols, tt, &own, counters, options);
+	}
+
+	if (use_fixed_kernel(g, num_cols, options)) {
+		return try_solve_outcome_fixed(g, num_cols, tt, sym, counters, options);
+	}
+
+	tt.new_search();
+
+	// Lazy SMP: every thread searches the whole game from the root, sharing
+	// the table, and the helpers take the moves near the root in a rotated 
+	// order. Positions solved by one thread are cut off by the others. Every
+	// stored value is exact, so whichever thread finishes first has the 
+	// serial result; it then stops the others.
+	std::atomic<bool> stop{ false };
+	std::atomic<bool> win{ false };
+	std::vector<search_counters> thread_counters(std::max(options.threads_, 1));
+
+	const auto search = [&](int id) {
+		bitboard_coloring col(g, num_cols);
+		game_state root(col, &tt, sym);
+		root.ordering_.set_policy(true, options.alice_ordering_);
+		root.ordering_.set_policy(false, options.bob_ordering_);
+		root.ordering_.set_rotation(id);
+		root.safe_reductions_ = options.safe_reductions_;
+		root.bob_threats_ = options.bob_threats_;
+		root.endgame_vertices_ = options.endgame_vertices_;
+		root.node_limit_ = options.node_limit_;
+		root.counters_.live_nodes_ = counters != nullptr ? counters->live_nodes_ : nullptr;
+
+		endgame_table endgames;
+		root.endgames_ = &endgames;
+
+		if (thread_counters.size() > 1) {
+			root.stop_ = &stop;
+		}
+
+		const bool result = alice_wins(root);
+
+		// A thread that was not stopped completed its search
+		if (!root.stopped()) {
+			win.store(result, std::memory_order_relaxed);
+			stop.store(true, std::memory_order_relaxed);
+		}
+
+		thread_counters[id] = root.counters_;
+	};
+
+	std::vector<std::thread> helpers;
+	for (int id = 1; id < static_cast<int>(thread_counters.size()); ++id) {
+		helpers.emplace_back(search, id);
+	}
+
+	search(0);
+
+	for (auto& helper : helpers) {
+		helper.join();
+	}
+
+	if (counters != nullptr) {
+		for (const auto& c : thread_counters) {
+			*counters += c;
+		}
+	}
+
+	// Only a thread that completed its search raises stop
+	if (!stop.load()) {
+		return std::nullopt;
+	}
+
+	return win.load() ? Victory::Alice : Victory::Bob;
+}
+
+std::pair<Victory, std::queue<move>> principal_line(const graph& g, int num_cols, transposition_table& tt) {
+	if (g.num_vertices() > BIT_LEN) {
+		return principal_line_wide(g, num_cols, tt);
+	}
+
+	const graph_symmetry sym(g);
+
+	if (has_fixed_kernel(g, num_cols)) {
+		return principal_line_fixed(g, num_cols, tt, &sym);
+	}
+
+	bitboard_coloring col(g, num_cols);
+	game_state master(col, &tt, &sym);
+	std::queue<move> moves;
+
+	endgame_table endgames;
+	master.endgames_ = &endgames;
+
+	while (!col.is_colored() && !col.is_deadend()) {
+		const move next = select_line_move(master);
+
+		moves.emplace(next);
+		master.remove(next.vertex_);
+		col.color_vertex(next.vertex_, next.color_);
+	}
+
+	return std::make_pair(col.is_colored() ? Victory::Alice : Victory::Bob, moves);
+}
+
 void print_gameplay(std::pair<Victory, std::queue<move>>& game) {
 	const std::string players[2] = { "Alice", "Bob" };
 	bool max_player = false;
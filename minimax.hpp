@@ -1,26 +1,35 @@
 #ifndef MINIMAX_HPP
 #define MINIMAX_HPP
 
+#include <optional>
 #include <utility>
 #include <queue>
 #include <unordered_map>
 #include <array>
 #include "move.hpp"
 
-#include "vertex_coloring.hpp"
+#include "bitboard_coloring.hpp"
+#include "game_state.hpp"
 
-struct game_state;
 class graph;
+class transposition_table;
+class graph_symmetry;
 
 enum class Victory {
 	Alice = 0,
 	Bob = 1
 };
 
-// See https://levelup.gitconnected.com/improving-minimax-performance-fc82bc337dfd
-// Question: should we include more info than just vertex_coloring?
+// solve_outcome() gives alpha-beta one node for every 2^TABLEBASE_NODE_SHIFT
+// entries of the tablebase before building it, which takes about as long,
+// and at least TABLEBASE_MIN_NODES
+static constexpr int TABLEBASE_NODE_SHIFT = 4;
+static constexpr std::uint64_t TABLEBASE_MIN_NODES = 1 << 16;
 
-//typedef std::array<std::unordered_map<vertex_coloring, int>, 2> TranspositionTable;
+// See https://levelup.gitconnected.com/improving-minimax-performance-fc82bc337dfd
+// The player to move follows from the number of colored vertices, so the
+// coloring alone identifies a node. If node.tt_ is set, minimax() probes and
+// stores into it.
 
 std::pair<move, int> minimax(
 	game_state& node, bool max_player, 
@@ -28,8 +37,43 @@ std::pair<move, int> minimax(
 	int beta = std::numeric_limits<int>::max(), 
 	int level = 0);
 
+// Plays a game in which both players make the moves of minimax(), which
+// ends it at the level best for them. Graphs of more than 64 vertices are
+// replayed as by principal_line() instead: the winner plays winning moves,
+// but not necessarily the ones of minimax().
 std::pair<Victory, std::queue<move>> play_optimally(const graph& g, int num_cols);
 
+std::pair<Victory, std::queue<move>> play_optimally(const graph& g, int num_cols, transposition_table& tt);
+
+// Value-only AND/OR search: whether Alice wins from node. Alice is to move 
+// when an even number of vertices is colored. Alice stops at her first 
+// winning move and Bob at his first refutation.
+bool alice_wins(game_state& node);
+
+Victory solve_outcome(const graph& g, int num_cols);
+
+// The symmetries of g are computed here unless given. Node and pruning 
+// counts are added to counters if given. With options.threads_ > 1, the 
+// threads share tt and the result is the same as with one thread.
+//
+// If a tablebase of g fits in options.tablebase_megabytes_, the engine
+// Engine::Tablebase goes straight to it, and alpha-beta hands over to it
+// past a node limit, see TABLEBASE_NODE_SHIFT. options.node_limit_ is
+// ignored.
+Victory solve_outcome(const graph& g, int num_cols, transposition_table& tt, 
+	const graph_symmetry* sym = nullptr, search_counters* counters = nullptr,
+	const search_options& options = search_options());
+
+// The alpha-beta search of solve_outcome(), with no tablebase. Nothing if
+// every thread reached options.node_limit_ first.
+std::optional<Victory> try_solve_outcome(const graph& g, int num_cols, transposition_table& tt,
+	const graph_symmetry* sym = nullptr, search_counters* counters = nullptr,
+	const search_options& options = search_options());
+
+// Replays a game in which the winner plays winning moves. Meant to be called
+// right after solve_outcome() with the same table, which makes it cheap.
+std::pair<Victory, std::queue<move>> principal_line(const graph& g, int num_cols, transposition_table& tt);
+
 void print_gameplay(std::pair<Victory, std::queue<move>>& game);
 
 #endif
\ No newline at end of file
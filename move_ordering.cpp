@@ -0,0 +1,225 @@
+#include "move_ordering.hpp"
+
+#include "bitboard_coloring.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace {
+	static constexpr std::uint64_t HINT_BONUS = 1ULL << 63;
+	static constexpr std::uint64_t KILLER_BONUS = 1ULL << 61;
+	static constexpr int HISTORY_SHIFT = 32;
+	static constexpr std::uint32_t MAX_HISTORY = 1U << 28;
+
+	bool same_move(move a, move b) {
+		return a.vertex_ == b.vertex_ && a.color_ == b.color_;
+	}
+}
+
+move_orderer::move_orderer(const graph& g, Ordering alice, Ordering bob)
+	: g_(g),
+	policy_({ alice, bob }),
+	lists_(g.num_vertices() + 1),
+	killers_(g.num_vertices() + 1)
+{
+	for (auto& list : lists_) {
+		list.reserve(BIT_LEN);
+	}
+
+	clear();
+}
+
+void move_orderer::set_policy(bool alice, Ordering policy) {
+	policy_[alice ? 0 : 1] = policy;
+}
+
+Ordering move_orderer::get_policy(bool alice) const {
+	return policy_[alice ? 0 : 1];
+}
+
+const std::vector<move>& move_orderer::order_moves(const bitboard_coloring& col, index_t vertices, index_t colors, move hint,
+	index_t one_color) {
+	const int ply = col.num_colored_vertices();
+	const bool alice = ply % 2 == 0;
+	const Ordering policy = get_policy(alice);
+
+	auto& list = lists_[ply];
+	list.clear();
+
+	for (index_t rest = vertices; rest != 0; rest &= rest - 1) {
+		const int v = std::countr_zero(rest);
+
+		index_t allowed = col.get_allowed_colors(v) & colors;
+		if ((one_color >> v) & 1ULL) {
+			allowed &= ~allowed + 1;
+		}
+
+		for (; allowed != 0; allowed &= allowed - 1) {
+			list.emplace_back(v, std::countr_zero(allowed));
+		}
+	}
+
+	if (policy == Ordering::Natural && hint.vertex_ == -1) {
+		rotate(list, ply);
+		return list;
+	}
+
+	if (policy != Ordering::Natural) {
+		for (index_t rest = col.uncolored(); rest != 0; rest &= rest - 1) {
+			const index_t v = std::countr_zero(rest);
+			free_count_[v] = std::popcount(col.get_allowed_colors(v));
+		}
+	}
+
+	keys_.resize(list.size());
+	for (std::size_t i = 0; i < list.size(); ++i) {
+		const move m = list[i];
+		std::uint64_t key = 0;
+
+		if (policy != Ordering::Natural) {
+			key = static_score(col, m, alice);
+		}
+
+		if (policy == Ordering::History) {
+			key = (key << HISTORY_SHIFT) + history_[alice ? 0 : 1][m.vertex_][m.color_];
+
+			for (std::size_t j = 0; j < NUM_KILLERS; ++j) {
+				if (same_move(killers_[ply][j], m)) {
+					key += KILLER_BONUS >> j;
+				}
+			}
+		}
+
+		if (same_move(hint, m)) {
+			key += HINT_BONUS;
+		}
+
+		keys_[i] = key;
+	}
+
+	// Stable insertion sort by decreasing key; lists are short
+	for (std::size_t i = 1; i < list.size(); ++i) {
+		const move m = list[i];
+		const std::uint64_t key = keys_[i];
+		std::size_t j = i;
+
+		for (; j > 0 && keys_[j - 1] < key; --j) {
+			list[j] = list[j - 1];
+			keys_[j] = keys_[j - 1];
+		}
+
+		list[j] = m;
+		keys_[j] = key;
+	}
+
+	rotate(list, ply);
+	return list;
+}
+
+void move_orderer::set_rotation(int rotation) {
+	assert(rotation >= 0);
+	rotation_ = rotation;
+}
+
+void move_orderer::rotate(std::vector<move>& list, int ply) const {
+	if (rotation_ != 0 && ply < ROTATED_PLIES && list.size() > 1) {
+		std::rotate(list.begin(), list.begin() + rotation_ % list.size(), list.end());
+	}
+}
+
+void move_orderer::record_cutoff(const bitboard_coloring& col, move m) {
+	const int ply = col.num_colored_vertices();
+	const bool alice = ply % 2 == 0;
+
+	if (get_policy(alice) != Ordering::History) {
+		return;
+	}
+
+	auto& killers = killers_[ply];
+	if (!same_move(killers[0], m)) {
+		for (std::size_t j = NUM_KILLERS - 1; j > 0; --j) {
+			killers[j] = killers[j - 1];
+		}
+
+		killers[0] = m;
+	}
+
+	// Cutoffs near the root prune more, so they weigh more
+	const std::uint32_t remaining = col.num_vertices() - ply;
+	auto& table = history_[alice ? 0 : 1];
+	auto& h = table[m.vertex_][m.color_];
+	h += remaining * remaining;
+
+	if (h > MAX_HISTORY) {
+		for (auto& row : table) {
+			for (auto& e : row) {
+				e >>= 1;
+			}
+		}
+	}
+}
+
+void move_orderer::clear() {
+	for (auto& killers : killers_) {
+		killers.fill(move());
+	}
+
+	for (auto& table : history_) {
+		for (auto& row : table) {
+			row.fill(0);
+		}
+	}
+}
+
+std::uint64_t move_orderer::static_score(const bitboard_coloring& col, move m, bool alice) const {
+	const index_t nbrs = g_.get_neighbors(m.vertex_) & col.uncolored();
+	const std::uint64_t k = col.num_colors();
+
+	if (alice) {
+		// Color the vertex with the most free colors and uncolored neighbors
+		// first: it is the hardest one for Bob to corner later
+		return static_cast<std::uint64_t>(free_count_[m.vertex_]) * BIT_LEN + std::popcount(nbrs);
+	}
+
+	// Take the color away from the neighbors with the fewest free colors
+	const index_t hit = nbrs & ~col.attacked(m.color_);
+	if (hit == 0) {
+		return 0;
+	}
+
+	int fewest = col.num_colors();
+	for (index_t rest = hit; rest != 0; rest &= rest - 1) {
+		fewest = std::min(fewest, free_count_[std::countr_zero(rest)]);
+	}
+
+	return (k + 1 - fewest) * BIT_LEN + std::popcount(hit);
+}
+
+bool parse_ordering(const std::string& name, Ordering& ordering) {
+	if (name == "natural") {
+		ordering = Ordering::Natural;
+	}
+	else if (name == "static") {
+		ordering = Ordering::Static;
+	}
+	else if (name == "history") {
+		ordering = Ordering::History;
+	}
+	else {
+		return false;
+	}
+
+	return true;
+}
+
+std::string to_string(Ordering ordering) {
+	switch (ordering) {
+	case Ordering::Natural:
+		return "natural";
+	case Ordering::Static:
+		return "static";
+	default:
+		return "history";
+	}
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef MOVE_ORDERING_HPP
+#define MOVE_ORDERING_HPP
+
+#include "common.hpp"
+#include "graph.hpp"
+#include "move.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class bitboard_coloring;
+
+enum class Ordering {
+	// Vertices and colors by index
+	Natural = 0,
+	// Alice colors the vertex with the most free colors and uncolored
+	// neighbors first; Bob first attacks the uncolored vertices with the 
+	// fewest free colors
+	Static = 1,
+	// Killer moves of the ply, then the static order, then history scores
+	History = 2
+};
+
+static constexpr std::size_t NUM_KILLERS = 2;
+
+// Plies at which set_rotation() applies
+static constexpr int ROTATED_PLIES = 2;
+
+// Generates and orders the moves of a node. Alice and Bob each have their
+// own policy and history table. Move lists are kept per ply (number of
+// colored vertices), so the list of a node stays valid while its children
+// are searched.
+class move_orderer {
+  public:
+	move_orderer(const graph& g, Ordering alice = Ordering::Static, Ordering bob = Ordering::Static);
+
+	void set_policy(bool alice, Ordering policy);
+	Ordering get_policy(bool alice) const;
+
+	// The moves (v, c) with v in vertices and c an allowed color in colors,
+	// best first; vertices in one_color only get the lowest such color. The
+	// hint, if legal, is tried before all others.
+	const std::vector<move>& order_moves(const bitboard_coloring& col, index_t vertices, index_t colors, move hint = move(),
+		index_t one_color = 0);
+
+	// Called when m refuted its siblings, i.e., caused a cutoff
+	void record_cutoff(const bitboard_coloring& col, move m);
+
+	// Rotates the ordered lists of the first ROTATED_PLIES plies by this many
+	// places, so that the threads of a parallel search start in different 
+	// parts of the tree
+	void set_rotation(int rotation);
+
+	void clear();
+
+  private:
+	std::uint64_t static_score(const bitboard_coloring& col, move m, bool alice) const;
+	void rotate(std::vector<move>& list, int ply) const;
+
+	const graph& g_;
+	std::array<Ordering, 2> policy_;
+	int rotation_{ 0 };
+
+	std::vector<std::vector<move>> lists_;
+	std::vector<std::uint64_t> keys_;
+	std::array<int, BIT_LEN> free_count_{};
+
+	std::vector<std::array<move, NUM_KILLERS>> killers_;
+	std::array<std::array<std::array<std::uint32_t, BIT_LEN>, BIT_LEN>, 2> history_{};
+};
+
+bool parse_ordering(const std::string& name, Ordering& ordering);
+
+std::string to_string(Ordering ordering);
+
+#endif
\ No newline at end of file
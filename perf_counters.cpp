@@ -0,0 +1,151 @@
+#include "perf_counters.hpp"
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+std::uint64_t perf_sample::get(PerfEvent e) const {
+	return counts_[static_cast<int>(e)];
+}
+
+bool perf_sample::has(PerfEvent e) const {
+	return get(e) != NO_COUNT;
+}
+
+#ifdef __linux__
+
+namespace {
+	constexpr std::array<std::uint64_t, NUM_PERF_EVENTS> HARDWARE_EVENTS = { PERF_COUNT_HW_CPU_CYCLES,
+		PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES };
+
+	int open_event(std::uint64_t config, int group_fd) {
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = config;
+		attr.disabled = group_fd == -1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+	}
+}
+
+perf_counters::perf_counters() {
+	std::string reason;
+
+	for (int i = 0; i < NUM_PERF_EVENTS; ++i) {
+		fds_[i] = open_event(HARDWARE_EVENTS[i], leader_);
+
+		if (fds_[i] == -1) {
+			error_ += std::string(error_.empty() ? "" : ", ") + name(static_cast<PerfEvent>(i));
+			if (reason.empty()) {
+				reason = std::strerror(errno);
+			}
+		}
+		else if (leader_ == -1) {
+			leader_ = fds_[i];
+		}
+	}
+
+	if (!error_.empty()) {
+		error_ += ": " + reason;
+	}
+}
+
+perf_counters::~perf_counters() {
+	for (const int fd : fds_) {
+		if (fd != -1) {
+			close(fd);
+		}
+	}
+}
+
+void perf_counters::start() {
+	if (leader_ != -1) {
+		ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	}
+}
+
+perf_sample perf_counters::stop() {
+	perf_sample sample;
+
+	if (leader_ == -1) {
+		return sample;
+	}
+
+	ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+	// The number of events, the times enabled and running, and the counts
+	// in the order the events were opened
+	std::array<std::uint64_t, 3 + NUM_PERF_EVENTS> buffer{};
+	const ssize_t size = read(leader_, buffer.data(), sizeof(buffer));
+	const std::uint64_t enabled = buffer[1];
+	const std::uint64_t running = buffer[2];
+
+	if (size < static_cast<ssize_t>(3 * sizeof(std::uint64_t)) || running == 0) {
+		return sample;
+	}
+
+	std::size_t j = 3;
+	for (int i = 0; i < NUM_PERF_EVENTS; ++i) {
+		if (fds_[i] != -1 && j < 3 + buffer[0]) {
+			const double count = static_cast<double>(buffer[j++]);
+			sample.counts_[i] = static_cast<std::uint64_t>(count * enabled / running);
+		}
+	}
+
+	return sample;
+}
+
+#else
+
+perf_counters::perf_counters() : error_("perf_event_open is only available on Linux") {
+}
+
+perf_counters::~perf_counters() {
+}
+
+void perf_counters::start() {
+}
+
+perf_sample perf_counters::stop() {
+	return perf_sample();
+}
+
+#endif
+
+bool perf_counters::available() const {
+	return leader_ != -1;
+}
+
+bool perf_counters::has(PerfEvent e) const {
+	return fds_[static_cast<int>(e)] != -1;
+}
+
+const std::string& perf_counters::error() const {
+	return error_;
+}
+
+const char* perf_counters::name(PerfEvent e) {
+	switch (e) {
+	case PerfEvent::Cycles:
+		return "cycles";
+	case PerfEvent::Instructions:
+		return "instructions";
+	case PerfEvent::BranchMisses:
+		return "branch-misses";
+	case PerfEvent::CacheMisses:
+		return "cache-misses";
+	}
+
+	return "";
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+enum class PerfEvent { Cycles, Instructions, BranchMisses, CacheMisses };
+
+static constexpr int NUM_PERF_EVENTS = 4;
+
+// A count an event could not be measured with
+static constexpr std::uint64_t NO_COUNT = UINT64_MAX;
+
+struct perf_sample {
+	std::array<std::uint64_t, NUM_PERF_EVENTS> counts_{ NO_COUNT, NO_COUNT, NO_COUNT, NO_COUNT };
+
+	std::uint64_t get(PerfEvent e) const;
+	bool has(PerfEvent e) const;
+};
+
+// Hardware counters of the calling thread, through perf_event_open on
+// Linux. The events are opened as one group, so they count over the same
+// instructions; an event the CPU or the kernel does not offer (e.g., in a
+// virtual machine, or with a high perf_event_paranoid) is left out, and
+// without any events, or elsewhere than on Linux, every count is NO_COUNT.
+// Counts are scaled up if the kernel multiplexed the group.
+class perf_counters {
+  public:
+	perf_counters();
+	~perf_counters();
+	perf_counters(const perf_counters&) = delete;
+	perf_counters& operator=(const perf_counters&) = delete;
+
+	// Whether any event could be opened
+	bool available() const;
+	bool has(PerfEvent e) const;
+
+	// Why no event, or not every event, could be opened; empty if all were
+	const std::string& error() const;
+
+	// Resets and starts the counters
+	void start();
+
+	// Stops the counters and reads them
+	perf_sample stop();
+
+	static const char* name(PerfEvent e);
+
+  private:
+	std::array<int, NUM_PERF_EVENTS> fds_{ -1, -1, -1, -1 };
+	int leader_{ -1 };
+	std::string error_;
+};
+
+#endif
\ No newline at end of file
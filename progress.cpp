@@ -0,0 +1,262 @@
+#include "progress.hpp"
+
+#include <algorithm>
+#include <csignal>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace {
+	// Ticks of the reporter, which looks for a dump request on every one
+	static constexpr auto REPORTER_TICK = std::chrono::milliseconds(100);
+
+	// Weight of the latest interval in the smoothed rates
+	static constexpr double RATE_SMOOTHING = 0.3;
+
+	// Graph6 lines are cut to this many characters in progress lines
+	static constexpr std::size_t MAX_SHOWN_LINE = 40;
+
+	std::atomic<bool> dump_requested{ false };
+
+	extern "C" void request_dump(int) {
+		dump_requested.store(true, std::memory_order_relaxed);
+	}
+
+	std::string shorten(const std::string& line) {
+		return line.size() <= MAX_SHOWN_LINE ? line : line.substr(0, MAX_SHOWN_LINE - 3) + "...";
+	}
+
+	double smooth(double rate, double latest, bool first) {
+		return first ? latest : RATE_SMOOTHING * latest + (1 - RATE_SMOOTHING) * rate;
+	}
+}
+
+batch_progress::batch_progress(int workers, std::ostream& os, double interval, bool report)
+	: slots_(std::make_unique<worker_slot[]>(std::max(workers, 1))),
+	num_slots_(std::max(workers, 1)),
+	os_(os),
+	interval_(interval),
+	start_(std::chrono::steady_clock::now()),
+	last_time_(start_) {
+	if (report) {
+#ifdef SIGUSR1
+		dump_requested.store(false);
+		previous_handler_ = std::signal(SIGUSR1, request_dump);
+#endif
+		thread_ = std::thread([this]() { run(); });
+	}
+}
+
+batch_progress::~batch_progress() {
+	if (thread_.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			done_ = true;
+		}
+
+		wake_.notify_one();
+		thread_.join();
+
+#ifdef SIGUSR1
+		std::signal(SIGUSR1, previous_handler_ == SIG_ERR ? SIG_DFL : previous_handler_);
+#endif
+	}
+}
+
+void batch_progress::begin_graph(int worker, const std::string& line) {
+	worker_slot& s = slots_[worker];
+	std::lock_guard<std::mutex> lock(s.mutex_);
+
+	s.busy_ = true;
+	s.line_ = line;
+	s.num_cols_ = 0;
+	s.started_ = std::chrono::steady_clock::now();
+	s.nodes_ = 0;
+}
+
+void batch_progress::begin_solve(int worker, int num_cols, search_counters& counters) {
+	worker_slot& s = slots_[worker];
+	std::lock_guard<std::mutex> lock(s.mutex_);
+
+	s.num_cols_ = num_cols;
+	s.live_nodes_.store(0, std::memory_order_relaxed);
+	counters.live_nodes_ = &s.live_nodes_;
+}
+
+void batch_progress::end_solve(int worker, search_counters& counters) {
+	worker_slot& s = slots_[worker];
+	std::lock_guard<std::mutex> lock(s.mutex_);
+
+	s.nodes_ += counters.nodes_;
+	s.live_nodes_.store(0, std::memory_order_relaxed);
+	counters.live_nodes_ = nullptr;
+}
+
+void batch_progress::end_graph(int worker, const worker_report& report, const search_counters& counters) {
+	worker_slot& s = slots_[worker];
+	std::lock_guard<std::mutex> lock(s.mutex_);
+
+	s.busy_ = false;
+	s.report_ = report;
+	s.counters_ = counters;
+}
+
+void batch_progress::read(std::uint64_t queued, std::uint64_t skipped, std::uint64_t malformed, double fraction) {
+	queued_.store(queued, std::memory_order_relaxed);
+	skipped_.store(skipped, std::memory_order_relaxed);
+	malformed_.store(malformed, std::memory_order_relaxed);
+	fraction_.store(fraction, std::memory_order_relaxed);
+}
+
+batch_report batch_progress::snapshot() const {
+	batch_report report;
+	report.skipped_ = skipped_.load(std::memory_order_relaxed);
+	report.malformed_ = malformed_.load(std::memory_order_relaxed);
+	report.wall_seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+
+	for (int i = 0; i < num_slots_; ++i) {
+		std::lock_guard<std::mutex> lock(slots_[i].mutex_);
+		report.workers_.push_back(slots_[i].report_);
+		report.counters_ += slots_[i].counters_;
+	}
+
+	for (const auto& w : report.workers_) {
+		report.graphs_ += w.graphs_;
+		report.solves_ += w.solves_;
+		report.bounded_ += w.bounded_;
+	}
+
+	return report;
+}
+
+std::vector<in_flight_graph> batch_progress::in_flight() const {
+	const auto now = std::chrono::steady_clock::now();
+	std::vector<in_flight_graph> graphs;
+
+	for (int i = 0; i < num_slots_; ++i) {
+		const worker_slot& s = slots_[i];
+		std::lock_guard<std::mutex> lock(s.mutex_);
+
+		if (s.busy_) {
+			const std::uint64_t nodes = s.nodes_ + s.live_nodes_.load(std::memory_order_relaxed);
+			graphs.push_back({ i, s.line_, s.num_cols_, std::chrono::duration<double>(now - s.started_).count(), nodes });
+		}
+	}
+
+	std::stable_sort(graphs.begin(), graphs.end(), [](const in_flight_graph& a, const in_flight_graph& b) {
+		return a.seconds_ > b.seconds_;
+	});
+
+	return graphs;
+}
+
+void batch_progress::print_line(std::ostream& os) {
+	const batch_report report = snapshot();
+	const auto now = std::chrono::steady_clock::now();
+	const double dt = std::chrono::duration<double>(now - last_time_).count();
+	const bool first = last_time_ == start_;
+
+	// The reader runs ahead of the workers by up to the capacity of the
+	// queues, so the fraction read is scaled down to the lines done
+	const std::uint64_t queued = queued_.load(std::memory_order_relaxed);
+	const std::uint64_t passed = report.skipped_ + report.malformed_;
+	double fraction = fraction_.load(std::memory_order_relaxed);
+	if (fraction > 0 && queued + passed > 0) {
+		fraction *= static_cast<double>(std::min(report.graphs_, queued) + passed) / (queued + passed);
+	}
+
+	if (dt > 0) {
+		graph_rate_ = smooth(graph_rate_, (report.graphs_ - last_graphs_) / dt, first);
+		fraction_rate_ = smooth(fraction_rate_, (fraction - last_fraction_) / dt, first);
+	}
+
+	std::ostringstream line;
+	line << "Progress " << format_duration(report.wall_seconds_) << ": " << report.graphs_ << " graphs";
+
+	if (fraction >= 0) {
+		line << " (" << std::fixed << std::setprecision(1) << 100 * fraction << "% done)";
+	}
+
+	line << ", " << std::fixed << std::setprecision(1) << graph_rate_ << " graphs/s, " << std::setprecision(2)
+		<< (dt > 0 ? (report.counters_.nodes_ - last_nodes_) / dt / 1e6 : 0.0) << " Mnodes/s";
+
+	if (fraction >= 0 && fraction_rate_ > 0) {
+		line << ", ETA " << format_duration((1 - fraction) / fraction_rate_);
+	}
+
+	const auto graphs = in_flight();
+	if (!graphs.empty()) {
+		const in_flight_graph& g = graphs.front();
+		line << "; longest in flight " << shorten(g.line_) << " at k=" << g.num_cols_ << " for "
+			<< format_duration(g.seconds_) << ", " << g.nodes_ << " nodes";
+	}
+
+	os << line.str() << "\n";
+	os.flush();
+
+	last_time_ = now;
+	last_graphs_ = report.graphs_;
+	last_nodes_ = report.counters_.nodes_;
+	last_fraction_ = fraction;
+}
+
+void batch_progress::dump(std::ostream& os) const {
+	std::ostringstream text;
+	text << "Progress dump, " << queued_.load(std::memory_order_relaxed) << " graphs queued so far\n";
+	print_batch_report(snapshot(), text);
+
+	const auto graphs = in_flight();
+	text << graphs.size() << " graphs in flight\n";
+
+	for (const auto& g : graphs) {
+		text << "Worker " << g.worker_ << ": " << g.line_ << " at k=" << g.num_cols_ << " for "
+			<< format_duration(g.seconds_) << ", " << g.nodes_ << " nodes\n";
+	}
+
+	os << text.str();
+	os.flush();
+}
+
+void batch_progress::run() {
+	auto next_line = start_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		std::chrono::duration<double>(interval_));
+
+	std::unique_lock<std::mutex> lock(mutex_);
+
+	while (!wake_.wait_for(lock, REPORTER_TICK, [this]() { return done_; })) {
+		lock.unlock();
+
+		if (dump_requested.exchange(false, std::memory_order_relaxed)) {
+			dump(os_);
+		}
+
+		if (interval_ > 0 && std::chrono::steady_clock::now() >= next_line) {
+			print_line(os_);
+			next_line = last_time_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+				std::chrono::duration<double>(interval_));
+		}
+
+		lock.lock();
+	}
+}
+
+std::string format_duration(double seconds) {
+	const long long s = static_cast<long long>(std::max(seconds, 0.0) + 0.5);
+	std::ostringstream text;
+	text << std::setfill('0');
+
+	if (s >= 86400) {
+		text << s / 86400 << "d" << std::setw(2) << s % 86400 / 3600 << "h";
+	}
+	else if (s >= 3600) {
+		text << s / 3600 << "h" << std::setw(2) << s % 3600 / 60 << "m";
+	}
+	else if (s >= 60) {
+		text << s / 60 << "m" << std::setw(2) << s % 60 << "s";
+	}
+	else {
+		text << s << "s";
+	}
+
+	return text.str();
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#ifndef PROGRESS_HPP
+#define PROGRESS_HPP
+
+#include "batch.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A graph a worker is solving
+struct in_flight_graph {
+	int worker_{ 0 };
+	std::string line_;
+	int num_cols_{ 0 };
+	double seconds_{ 0 };
+
+	// Nodes of the games of the graph solved so far, and of the one being
+	// solved up to the last LIVE_NODES_INTERVAL
+	std::uint64_t nodes_{ 0 };
+};
+
+// Live progress of a batch run. Workers record every graph and game in
+// their own slot, behind a lock only the reporter ever contends, and the
+// reader records how far into the input it is. A reporter thread prints a
+// line every interval seconds with the throughput since the last one, an
+// ETA and the graph in flight the longest, and, on SIGUSR1, dumps the
+// totals so far with every graph in flight. The workers never wait for it
+// beyond a copy of their slot.
+class batch_progress {
+  public:
+	// Without a positive interval, no lines are printed; without report,
+	// there is no reporter thread at all and SIGUSR1 is left alone
+	batch_progress(int workers, std::ostream& os, double interval, bool report);
+	~batch_progress();
+	batch_progress(const batch_progress&) = delete;
+	batch_progress& operator=(const batch_progress&) = delete;
+
+	void begin_graph(int worker, const std::string& line);
+	// The counters of the game add their nodes to the slot of the worker as
+	// the game goes on, until end_solve()
+	void begin_solve(int worker, int num_cols, search_counters& counters);
+	void end_solve(int worker, search_counters& counters);
+
+	// The totals of the worker, with the graph just solved
+	void end_graph(int worker, const worker_report& report, const search_counters& counters);
+
+	// Graphs queued for the workers so far, lines skipped and malformed,
+	// and the fraction of the input read, or a negative number if it is
+	// unknown
+	void read(std::uint64_t queued, std::uint64_t skipped, std::uint64_t malformed, double fraction);
+
+	// The totals of the finished graphs
+	batch_report snapshot() const;
+
+	// Longest in flight first
+	std::vector<in_flight_graph> in_flight() const;
+
+	void print_line(std::ostream& os);
+	void dump(std::ostream& os) const;
+
+  private:
+	struct alignas(64) worker_slot {
+		mutable std::mutex mutex_;
+		worker_report report_;
+		search_counters counters_;
+
+		bool busy_{ false };
+		std::string line_;
+		int num_cols_{ 0 };
+		std::chrono::steady_clock::time_point started_;
+		std::uint64_t nodes_{ 0 };
+
+		// Of the game being solved, added to without the lock
+		std::atomic<std::uint64_t> live_nodes_{ 0 };
+	};
+
+	void run();
+
+	std::unique_ptr<worker_slot[]> slots_;
+	const int num_slots_;
+	std::ostream& os_;
+	const double interval_;
+	const std::chrono::steady_clock::time_point start_;
+
+	std::atomic<std::uint64_t> queued_{ 0 };
+	std::atomic<std::uint64_t> skipped_{ 0 };
+	std::atomic<std::uint64_t> malformed_{ 0 };
+	std::atomic<double> fraction_{ -1 };
+
+	// Of the last line, for the rates and the ETA; reporter only
+	std::chrono::steady_clock::time_point last_time_;
+	std::uint64_t last_graphs_{ 0 };
+	std::uint64_t last_nodes_{ 0 };
+	double last_fraction_{ 0 };
+	double fraction_rate_{ 0 };
+	double graph_rate_{ 0 };
+
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	bool done_{ false };
+	std::thread thread_;
+
+	// Of SIGUSR1, restored when the reporter stops
+	void (*previous_handler_)(int) { nullptr };
+};
+
+// As "1d02h", "3h12m", "4m05s" or "12s"
+std::string format_duration(double seconds);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,133 @@
+#ifndef REDUCTIONS_HPP
+#define REDUCTIONS_HPP
+
+#include "common.hpp"
+#include "bitset.hpp"
+
+#include <bit>
+
+// Reductions that hold for every coloring, shared by the engines. rows(u)
+// is the adjacency row of u and allowed(u) its mask of free colors.
+//
+// Only the first two are used by minimax(): the others decide positions
+// without regard to when the game ends.
+//
+// An uncolored vertex is safe when it has fewer uncolored neighbors than
+// free colors. Every neighbor colored later takes at most one of its free
+// colors away, so a safe vertex stays safe and is never dead. Once every
+// uncolored vertex is safe, the coloring will be completed and Alice has
+// won, whatever both players do.
+template <int Words, typename Rows, typename Allowed>
+wide_bitset<Words> safe_vertices(const wide_bitset<Words>& uncols, Rows&& rows, Allowed&& allowed) {
+	wide_bitset<Words> safe;
+
+	uncols.for_each([&](int u) {
+		if ((rows(u) & uncols).count() < std::popcount(allowed(u))) {
+			safe.set(u);
+		}
+	});
+
+	return safe;
+}
+
+// The safe vertices that no path of uncolored vertices joins to an unsafe
+// one. Coloring them never changes the free colors of an unsafe vertex, so
+// all of them get colored and each only adds one move to the game, in any
+// order and any color: the moves on them are equivalent, and trying one of
+// them is enough.
+template <int Words, typename Rows>
+wide_bitset<Words> tempo_vertices(const wide_bitset<Words>& uncols, const wide_bitset<Words>& safe, Rows&& rows) {
+	wide_bitset<Words> reached = uncols & ~safe;
+	wide_bitset<Words> frontier = reached;
+
+	while (frontier.any()) {
+		wide_bitset<Words> next;
+		frontier.for_each([&](int u) { next |= rows(u); });
+
+		frontier = next & uncols & ~reached;
+		reached |= frontier;
+	}
+
+	return uncols & ~reached;
+}
+
+// Bob's threats, from the attack masks: attacked(c) holds the vertices with
+// a neighbor colored c. An uncolored vertex v whose only free color is c is
+// threatened if an uncolored neighbor w of v may still be colored c, as Bob
+// then colors w with c and leaves v dead.
+
+// The uncolored vertices with exactly one free color
+template <int Words, typename Attacked>
+wide_bitset<Words> critical_vertices(const wide_bitset<Words>& uncols, int num_cols, Attacked&& attacked) {
+	wide_bitset<Words> ones;
+	wide_bitset<Words> twos;
+
+	for (int c = 0; c < num_cols; ++c) {
+		const wide_bitset<Words> free = uncols & ~attacked(c);
+		twos |= ones & free;
+		ones |= free;
+	}
+
+	return ones & ~twos;
+}
+
+// Whether Bob, to move, wins at once
+template <int Words, typename Rows, typename Attacked>
+bool has_bob_threat(const wide_bitset<Words>& uncols, int num_cols, Rows&& rows, Attacked&& attacked) {
+	const wide_bitset<Words> critical = critical_vertices(uncols, num_cols, attacked);
+
+	if (critical.none()) {
+		return false;
+	}
+
+	for (int c = 0; c < num_cols; ++c) {
+		const wide_bitset<Words> open = uncols & ~attacked(c);
+		bool threat = false;
+
+		(critical & open).for_each([&](int v) { threat = threat || (rows(v) & open).any(); });
+
+		if (threat) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// With Alice to move, the vertices at which her move may stop every threat:
+// v itself, or a vertex that is or neighbors every w that can take c from
+// v. Any other move loses at Bob's next move, and if there is none, Alice
+// has lost already. All uncolored vertices if there is no threat.
+template <int Words, typename Rows, typename Attacked>
+wide_bitset<Words> threat_defusers(const wide_bitset<Words>& uncols, int num_cols, Rows&& rows, Attacked&& attacked) {
+	const wide_bitset<Words> critical = critical_vertices(uncols, num_cols, attacked);
+	wide_bitset<Words> defusers = uncols;
+
+	if (critical.none()) {
+		return defusers;
+	}
+
+	for (int c = 0; c < num_cols; ++c) {
+		const wide_bitset<Words> open = uncols & ~attacked(c);
+
+		(critical & open).for_each([&](int v) {
+			const wide_bitset<Words> killers = rows(v) & open;
+
+			if (killers.any()) {
+				wide_bitset<Words> region = uncols;
+				killers.for_each([&](int w) {
+					wide_bitset<Words> closed = rows(w);
+					closed.set(w);
+					region &= closed;
+				});
+
+				region.set(v);
+				defusers &= region;
+			}
+		});
+	}
+
+	return defusers;
+}
+
+#endif
\ No newline at end of file
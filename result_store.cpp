@@ -0,0 +1,268 @@
+#include "result_store.hpp"
+
+#include <cassert>
+#include <charconv>
+#include <filesystem>
+#include <functional>
+
+namespace {
+	static constexpr std::size_t INITIAL_SLOTS = 1024;
+
+	// Reads the complete lines of a file. A last line without its newline is
+	// cut short by a crash, so it is not passed on; the byte offset where it
+	// starts is returned.
+	template <typename Callback>
+	std::uint64_t for_each_line(std::ifstream& in, Callback&& callback) {
+		std::uint64_t complete = 0;
+		std::string line;
+
+		while (std::getline(in, line)) {
+			if (in.eof()) {
+				break;
+			}
+
+			complete += line.size() + 1;
+			callback(std::string_view(line));
+		}
+
+		return complete;
+	}
+}
+
+result_index::result_index()
+	: keys_(INITIAL_SLOTS, 0),
+	offsets_(INITIAL_SLOTS, 0),
+	values_(INITIAL_SLOTS, NO_RESULT) { }
+
+bool result_index::insert(std::string_view graph6, int k) {
+	assert(k >= 0 && k < 128);
+	assert(graph6.find('\n') == std::string_view::npos);
+
+	// At most half full
+	if (2 * (size_ + 1) > keys_.size()) {
+		grow();
+	}
+
+	const std::uint64_t h = key(graph6);
+	const std::size_t i = slot(h, graph6);
+
+	if (keys_[i] != 0) {
+		return false;
+	}
+
+	keys_[i] = h;
+	offsets_[i] = arena_.size();
+	values_[i] = static_cast<std::int8_t>(k);
+	arena_.append(graph6);
+	arena_.push_back('\n');
+	++size_;
+	return true;
+}
+
+int result_index::find(std::string_view graph6) const {
+	const std::size_t i = slot(key(graph6), graph6);
+
+	return keys_[i] != 0 ? values_[i] : NO_RESULT;
+}
+
+std::size_t result_index::size() const {
+	return size_;
+}
+
+std::uint64_t result_index::key(std::string_view graph6) {
+	// 0 marks an empty slot
+	const std::uint64_t h = std::hash<std::string_view>{}(graph6);
+	return h != 0 ? h : 1;
+}
+
+std::size_t result_index::slot(std::uint64_t key, std::string_view graph6) const {
+	const std::size_t mask = keys_.size() - 1;
+	std::size_t i = key & mask;
+
+	// Strings are only compared when the hashes match
+	while (keys_[i] != 0 && (keys_[i] != key || stored(i) != graph6)) {
+		i = (i + 1) & mask;
+	}
+
+	return i;
+}
+
+std::string_view result_index::stored(std::size_t i) const {
+	const std::size_t end = arena_.find('\n', offsets_[i]);
+	return std::string_view(arena_).substr(offsets_[i], end - offsets_[i]);
+}
+
+void result_index::grow() {
+	std::vector<std::uint64_t> keys(2 * keys_.size(), 0);
+	std::vector<std::uint64_t> offsets(2 * keys_.size(), 0);
+	std::vector<std::int8_t> values(2 * keys_.size(), NO_RESULT);
+
+	keys.swap(keys_);
+	offsets.swap(offsets_);
+	values.swap(values_);
+
+	// The strings are all distinct, so each goes to the first free slot
+	const std::size_t mask = keys_.size() - 1;
+
+	for (std::size_t i = 0; i < keys.size(); ++i) {
+		if (keys[i] != 0) {
+			std::size_t j = keys[i] & mask;
+			while (keys_[j] != 0) {
+				j = (j + 1) & mask;
+			}
+
+			keys_[j] = keys[i];
+			offsets_[j] = offsets[i];
+			values_[j] = values[i];
+		}
+	}
+}
+
+bool parse_result_line(std::string_view line, std::string_view& graph6, int& k) {
+	if (!line.empty() && line.back() == '\r') {
+		line.remove_suffix(1);
+	}
+
+	const auto space = line.find(' ');
+	if (space == 0 || space == std::string_view::npos) {
+		return false;
+	}
+
+	const char* first = line.data() + space + 1;
+	const char* last = line.data() + line.size();
+	const auto [end, error] = std::from_chars(first, last, k);
+
+	// Further fields, such as the number of games solved, are left alone
+	if (error != std::errc() || (end != last && *end != ' ') || first == last || k < 0 || k >= 128) {
+		return false;
+	}
+
+	graph6 = line.substr(0, space);
+	return true;
+}
+
+result_store::result_store(const std::string& path)
+	: path_(path)
+{
+	std::error_code ec;
+	std::ifstream in(path, std::ios::binary);
+
+	if (in && std::filesystem::is_regular_file(path, ec)) {
+		const std::uint64_t complete = for_each_line(in, [this](std::string_view line) {
+			std::string_view graph6;
+			int k = NO_RESULT;
+
+			if (parse_result_line(line, graph6, k)) {
+				index_.insert(graph6, k);
+			}
+			else {
+				++dropped_;
+			}
+		});
+
+		in.close();
+
+		if (complete < std::filesystem::file_size(path)) {
+			++dropped_;
+			std::filesystem::resize_file(path, complete);
+		}
+	}
+
+	out_.open(path, std::ios::binary | std::ios::app);
+}
+
+bool result_store::is_open() const {
+	return out_.is_open();
+}
+
+bool result_store::contains(std::string_view graph6) const {
+	return index_.find(graph6) != NO_RESULT;
+}
+
+int result_store::find(std::string_view graph6) const {
+	return index_.find(graph6);
+}
+
+std::size_t result_store::size() const {
+	return index_.size();
+}
+
+std::size_t result_store::num_dropped() const {
+	return dropped_;
+}
+
+void result_store::append(std::string_view graph6, int k) {
+	if (index_.insert(graph6, k)) {
+		// One write per line
+		const std::string line = std::string(graph6) + " " + std::to_string(k) + "\n";
+		out_.write(line.data(), line.size());
+	}
+}
+
+std::ostream& result_store::stream() {
+	return out_;
+}
+
+bool result_store::flush() {
+	out_.flush();
+	return out_.is_open() && out_.good();
+}
+
+merge_report merge_results(const std::vector<std::string>& inputs, const std::string& output) {
+	merge_report report;
+	result_index index;
+
+	const std::string temporary = output + ".tmp";
+	std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+
+	for (const auto& input : inputs) {
+		std::ifstream in(input, std::ios::binary);
+		if (!in.is_open()) {
+			++report.failed_;
+			continue;
+		}
+
+		const std::uint64_t complete = for_each_line(in, [&](std::string_view line) {
+			std::string_view graph6;
+			int k = NO_RESULT;
+
+			if (!parse_result_line(line, graph6, k)) {
+				++report.dropped_;
+				return;
+			}
+
+			const int known = index.find(graph6);
+
+			if (known == NO_RESULT) {
+				index.insert(graph6, k);
+				out << line.substr(0, line.find('\r')) << "\n";
+				++report.results_;
+			}
+			else if (known == k) {
+				++report.duplicates_;
+			}
+			else {
+				++report.conflicts_;
+			}
+		});
+
+		if (complete < std::filesystem::file_size(input)) {
+			++report.dropped_;
+		}
+	}
+
+	out.close();
+	if (!out) {
+		++report.failed_;
+	}
+
+	if (report.failed_ > 0) {
+		std::error_code ec;
+		std::filesystem::remove(temporary, ec);
+		return report;
+	}
+
+	std::filesystem::rename(temporary, output);
+
+	return report;
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#ifndef RESULT_STORE_HPP
+#define RESULT_STORE_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+static constexpr int NO_RESULT = -1;
+
+// Open addressing hash table from graph6 strings to k, with at most half of
+// the slots in use. A slot keeps the 64-bit hash of its string and where the
+// string starts in an arena of newline-terminated strings, which is only
+// compared on a matching hash.
+class result_index {
+  public:
+	result_index();
+
+	// False if graph6 is present already
+	bool insert(std::string_view graph6, int k);
+
+	// The k of graph6, or NO_RESULT
+	int find(std::string_view graph6) const;
+
+	std::size_t size() const;
+
+  private:
+	static std::uint64_t key(std::string_view graph6);
+	std::size_t slot(std::uint64_t key, std::string_view graph6) const;
+	std::string_view stored(std::size_t i) const;
+	void grow();
+
+	std::vector<std::uint64_t> keys_;
+	std::vector<std::uint64_t> offsets_;
+	std::vector<std::int8_t> values_;
+	std::string arena_;
+	std::size_t size_{ 0 };
+};
+
+// The results of a family run: a text file of "<graph6> <k>" lines, indexed
+// in memory once when opened, so a resumed run skips every solved graph in
+// O(1) instead of rescanning the file.
+//
+// New results are only ever appended, one whole line per write. If a crash
+// cuts the last line short, the next open drops that line from the file, so
+// the file always consists of complete results.
+class result_store {
+  public:
+	explicit result_store(const std::string& path);
+	result_store(const result_store&) = delete;
+	result_store& operator=(const result_store&) = delete;
+
+	// False if the file could not be opened for appending
+	bool is_open() const;
+
+	bool contains(std::string_view graph6) const;
+
+	// The recorded k, or NO_RESULT
+	int find(std::string_view graph6) const;
+
+	std::size_t size() const;
+
+	// Lines of the file that were cut short or could not be parsed
+	std::size_t num_dropped() const;
+
+	void append(std::string_view graph6, int k);
+
+	// For writing whole "<graph6> <k>" lines directly, as the batch writer
+	// does. Lines written here are not indexed until the next open.
+	std::ostream& stream();
+
+	// False if the file is not open or any write so far has failed
+	bool flush();
+
+  private:
+	std::string path_;
+	std::ofstream out_;
+	result_index index_;
+	std::size_t dropped_{ 0 };
+};
+
+struct merge_report {
+	std::size_t results_{ 0 };
+	std::size_t duplicates_{ 0 };
+	std::size_t conflicts_{ 0 };
+	std::size_t dropped_{ 0 };
+	std::size_t failed_{ 0 };
+};
+
+// Combines result files, e.g., the outputs of shards, into output. The first
+// result of every graph is kept, in order of appearance. Repeated graphs are
+// counted as duplicates, or as conflicts if their k differs. The output is
+// written to a temporary file that then replaces output, so output may also
+// be one of the inputs (compaction). An input that cannot be read, or an
+// output that cannot be written, counts as failed; output is then left as is.
+merge_report merge_results(const std::vector<std::string>& inputs, const std::string& output);
+
+// Splits a "<graph6> <k>" line, which may go on with more fields after a
+// space; false if it is malformed
+bool parse_result_line(std::string_view line, std::string_view& graph6, int& k);
+
+#endif
\ No newline at end of file
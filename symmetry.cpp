@@ -0,0 +1,410 @@
+#include "symmetry.hpp"
+
+#include "bitboard_coloring.hpp"
+#include "game_state.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <numeric>
+#include <set>
+
+namespace {
+	typedef std::vector<index_t> partition;
+
+	index_t low_bit(index_t x) {
+		return x & (0 - x);
+	}
+
+	// Splits cells until all vertices of a cell have the same number of
+	// neighbors in every cell. Sub-cells are ordered by that number, so the
+	// result does not depend on the vertex labels.
+	void refine(const graph& g, partition& p) {
+		for (bool changed = true; changed; ) {
+			changed = false;
+
+			for (std::size_t w = 0; w < p.size() && !changed; ++w) {
+				for (std::size_t x = 0; x < p.size() && !changed; ++x) {
+					if (std::has_single_bit(p[x])) {
+						continue;
+					}
+
+					std::array<index_t, BIT_LEN + 1> by_count{};
+					int groups = 0;
+
+					for (index_t rest = p[x]; rest != 0; rest &= rest - 1) {
+						const index_t u = std::countr_zero(rest);
+						auto& group = by_count[std::popcount(g.get_neighbors(u) & p[w])];
+
+						groups += group == 0;
+						group |= 1ULL << u;
+					}
+
+					if (groups > 1) {
+						partition split;
+						for (const auto cell : by_count) {
+							if (cell != 0) {
+								split.push_back(cell);
+							}
+						}
+
+						p.erase(p.begin() + x);
+						p.insert(p.begin() + x, split.cbegin(), split.cend());
+						changed = true;
+					}
+				}
+			}
+		}
+	}
+
+	partition individualize(const partition& p, std::size_t t, index_t u) {
+		partition q = p;
+		q[t] &= ~(1ULL << u);
+		q.insert(q.begin() + t, 1ULL << u);
+		return q;
+	}
+
+	index_t apply(const std::vector<int>& perm, index_t mask) {
+		index_t image = 0;
+		for (; mask != 0; mask &= mask - 1) {
+			image |= 1ULL << perm[std::countr_zero(mask)];
+		}
+
+		return image;
+	}
+
+	// All elements of the group generated by gens
+	std::vector<std::vector<int>> list_group(const std::vector<std::vector<int>>& gens, int n) {
+		std::vector<int> identity(n);
+		std::iota(identity.begin(), identity.end(), 0);
+
+		std::set<std::vector<int>> seen = { identity };
+		std::vector<std::vector<int>> elements = { identity };
+
+		for (std::size_t i = 0; i < elements.size(); ++i) {
+			for (const auto& gen : gens) {
+				std::vector<int> next(n);
+				for (int u = 0; u < n; ++u) {
+					next[u] = gen[elements[i][u]];
+				}
+
+				if (seen.insert(next).second) {
+					elements.push_back(next);
+				}
+			}
+		}
+
+		return elements;
+	}
+
+	std::size_t target_cell(const partition& p) {
+		for (std::size_t i = 0; i < p.size(); ++i) {
+			if (!std::has_single_bit(p[i])) {
+				return i;
+			}
+		}
+
+		return p.size();
+	}
+
+	bool same_shape(const partition& a, const partition& b) {
+		if (a.size() != b.size()) {
+			return false;
+		}
+
+		for (std::size_t i = 0; i < a.size(); ++i) {
+			if (std::popcount(a[i]) != std::popcount(b[i])) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Follows the first path of the search tree to a discrete partition and
+	// then, from the deepest level up, looks for a leaf equivalent to the
+	// first one below every other vertex of the target cell. Vertices already
+	// known to be in the same orbit are skipped.
+	class automorphism_search {
+	  public:
+		automorphism_search(const graph& g, const partition& cells)
+			: g_(g), cells_(cells), parent_(g.num_vertices())
+		{
+			std::iota(parent_.begin(), parent_.end(), 0);
+
+			partition p = cells;
+			refine(g_, p);
+			path_.push_back(p);
+
+			for (std::size_t t = target_cell(p); t < p.size(); t = target_cell(p)) {
+				const index_t v = std::countr_zero(p[t]);
+				targets_.push_back(t);
+				fixed_.push_back(v);
+
+				p = individualize(p, t, v);
+				refine(g_, p);
+				path_.push_back(p);
+			}
+		}
+
+		void run() {
+			for (std::size_t level = targets_.size(); level-- > 0; ) {
+				const partition& p = path_[level];
+				const std::size_t t = targets_[level];
+				const index_t v = fixed_[level];
+
+				for (index_t rest = p[t] & ~(1ULL << v); rest != 0; rest &= rest - 1) {
+					const index_t w = std::countr_zero(rest);
+
+					if (find(v) == find(w)) {
+						continue;
+					}
+
+					partition q = individualize(p, t, w);
+					refine(g_, q);
+
+					if (same_shape(q, path_[level + 1])) {
+						find_equivalent_leaf(q, level + 1);
+					}
+				}
+
+				// The orbit of v under the stabilizer of the earlier fixed points
+				int orbit = 0;
+				for (index_t rest = p[t]; rest != 0; rest &= rest - 1) {
+					orbit += find(v) == find(std::countr_zero(rest));
+				}
+
+				group_order_ *= orbit;
+			}
+		}
+
+		std::vector<index_t> orbits() {
+			std::vector<index_t> masks(g_.num_vertices(), 0);
+			for (int u = 0; u < static_cast<int>(g_.num_vertices()); ++u) {
+				masks[find(u)] |= 1ULL << u;
+			}
+
+			std::vector<index_t> result;
+			for (const auto mask : masks) {
+				if (mask != 0) {
+					result.push_back(mask);
+				}
+			}
+
+			return result;
+		}
+
+		std::vector<std::vector<int>> generators_;
+		double group_order_{ 1 };
+
+	  private:
+		bool find_equivalent_leaf(const partition& p, std::size_t level) {
+			const std::size_t t = target_cell(p);
+
+			if (t == p.size()) {
+				return try_leaf(p);
+			}
+
+			for (index_t rest = p[t]; rest != 0; rest &= rest - 1) {
+				partition q = individualize(p, t, std::countr_zero(rest));
+				refine(g_, q);
+
+				if (same_shape(q, path_[level + 1]) && find_equivalent_leaf(q, level + 1)) {
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		bool try_leaf(const partition& leaf) {
+			const partition& first = path_.back();
+			std::vector<int> perm(g_.num_vertices());
+
+			for (std::size_t i = 0; i < leaf.size(); ++i) {
+				perm[std::countr_zero(first[i])] = std::countr_zero(leaf[i]);
+			}
+
+			for (int u = 0; u < static_cast<int>(g_.num_vertices()); ++u) {
+				if (apply(perm, g_.get_neighbors(u)) != g_.get_neighbors(perm[u])) {
+					return false;
+				}
+			}
+
+			for (const auto cell : cells_) {
+				if (apply(perm, cell) != cell) {
+					return false;
+				}
+			}
+
+			for (int u = 0; u < static_cast<int>(g_.num_vertices()); ++u) {
+				parent_[find(u)] = find(perm[u]);
+			}
+
+			generators_.push_back(perm);
+			return true;
+		}
+
+		int find(int u) {
+			while (parent_[u] != u) {
+				u = parent_[u] = parent_[parent_[u]];
+			}
+
+			return u;
+		}
+
+		const graph& g_;
+		const partition cells_;
+		std::vector<int> parent_;
+
+		// The first path: refined partitions, target cells and fixed vertices
+		std::vector<partition> path_;
+		std::vector<std::size_t> targets_;
+		std::vector<index_t> fixed_;
+	};
+}
+
+std::vector<index_t> automorphism_orbits(const graph& g, const std::vector<index_t>& cells,
+	std::vector<std::vector<int>>* generators, double* group_order) {
+	assert(g.num_vertices() <= BIT_LEN);
+
+	automorphism_search search(g, cells);
+	search.run();
+
+	if (generators != nullptr) {
+		*generators = search.generators_;
+	}
+
+	if (group_order != nullptr) {
+		*group_order = search.group_order_;
+	}
+
+	return search.orbits();
+}
+
+graph_symmetry::graph_symmetry(const graph& g, int orbit_plies)
+	: g_(g),
+	orbit_plies_(orbit_plies),
+	twins_below_(g.num_vertices(), 0)
+{
+	// Wider graphs are searched by the wide engine, which finds its own twins
+	if (g.num_vertices() > BIT_LEN) {
+		return;
+	}
+
+	const index_t all = g.num_vertices() >= 64 ? ALL_ONES : (1ULL << g.num_vertices()) - 1;
+
+	for (index_t v = 0; v < g.num_vertices(); ++v) {
+		for (index_t u = 0; u < v; ++u) {
+			const index_t nu = g.get_neighbors(u) & ~(1ULL << v);
+			const index_t nv = g.get_neighbors(v) & ~(1ULL << u);
+
+			if (nu == nv) {
+				twins_below_[v] |= 1ULL << u;
+				has_twin_below_ |= 1ULL << v;
+			}
+		}
+	}
+
+	root_orbits_ = automorphism_orbits(g, { all }, &generators_, &group_order_);
+
+	if (group_order_ > 1 && group_order_ <= MAX_LISTED_AUTOMORPHISMS) {
+		elements_ = list_group(generators_, g.num_vertices());
+	}
+}
+
+index_t graph_symmetry::candidate_vertices(const bitboard_coloring& col, search_counters& counters) const {
+	std::array<index_t, BIT_LEN> classes;
+
+	// The classes only matter where orbits are taken
+	const int ply = col.num_colored_vertices();
+	if (ply < orbit_plies_ && group_order_ > 1) {
+		for (int c = 0; c < col.num_colors(); ++c) {
+			classes[c] = col.color_class(c);
+		}
+	}
+
+	return candidate_vertices(col.uncolored(), classes.data(), col.num_colors(), ply, counters);
+}
+
+index_t graph_symmetry::candidate_vertices(index_t uncols, const index_t* classes, int num_cols, int ply, search_counters& counters) const {
+	index_t cand = 0;
+
+	// Without automorphisms, stabilizers are trivial too
+	if (ply < orbit_plies_ && group_order_ > 1) {
+		std::vector<index_t> cells = { uncols };
+		for (int c = 0; c < num_cols; ++c) {
+			if (classes[c] != 0) {
+				cells.push_back(classes[c]);
+			}
+		}
+
+		if (ply > 0 && !elements_.empty()) {
+			// Keep the vertices not mapped lower by an automorphism that 
+			// fixes every color class, i.e., the minima of the orbits
+			cand = uncols;
+
+			for (const auto& perm : elements_) {
+				const bool fixes = std::all_of(cells.cbegin(), cells.cend(), 
+					[&perm](index_t cell) { return apply(perm, cell) == cell; });
+
+				if (fixes) {
+					for (index_t rest = cand; rest != 0; rest &= rest - 1) {
+						const index_t v = std::countr_zero(rest);
+
+						if (perm[v] < static_cast<int>(v)) {
+							cand &= ~(1ULL << v);
+						}
+					}
+				}
+			}
+		}
+		else {
+			const auto orbits = ply > 0 ? automorphism_orbits(g_, cells) : root_orbits_;
+
+			// Orbits never mix colored and uncolored vertices
+			for (const auto orbit : orbits) {
+				if (orbit & uncols) {
+					cand |= low_bit(orbit & uncols);
+				}
+			}
+		}
+
+		counters.orbit_prunes_ += std::popcount(uncols) - std::popcount(cand);
+		return cand;
+	}
+
+	cand = uncols;
+	for (index_t rest = uncols & has_twin_below_; rest != 0; rest &= rest - 1) {
+		const index_t v = std::countr_zero(rest);
+
+		if (twins_below_[v] & uncols) {
+			cand &= ~(1ULL << v);
+		}
+	}
+
+	counters.twin_prunes_ += std::popcount(uncols) - std::popcount(cand);
+	return cand;
+}
+
+index_t graph_symmetry::twins_below(index_t v) const {
+	assert(v < g_.num_vertices());
+	return twins_below_[v];
+}
+
+const std::vector<index_t>& graph_symmetry::root_orbits() const {
+	return root_orbits_;
+}
+
+const std::vector<std::vector<int>>& graph_symmetry::generators() const {
+	return generators_;
+}
+
+double graph_symmetry::group_order() const {
+	return group_order_;
+}
+
+int graph_symmetry::orbit_plies() const {
+	return orbit_plies_;
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef SYMMETRY_HPP
+#define SYMMETRY_HPP
+
+#include "common.hpp"
+#include "graph.hpp"
+
+#include <vector>
+
+class bitboard_coloring;
+struct search_counters;
+
+// Automorphism search by partition refinement and individualization on the
+// 64-bit adjacency rows. Returns the orbits of the automorphisms of g that
+// map every cell of the given partition onto itself. The generators found
+// on the way are stored if requested.
+std::vector<index_t> automorphism_orbits(const graph& g, const std::vector<index_t>& cells,
+	std::vector<std::vector<int>>* generators = nullptr, double* group_order = nullptr);
+
+static constexpr int DEFAULT_ORBIT_PLIES = 2;
+
+// Groups up to this order are listed, and stabilizers are found by
+// filtering the list instead of searching
+static constexpr double MAX_LISTED_AUTOMORPHISMS = 1024;
+
+// Symmetries of a graph used to skip moves equivalent to one already tried.
+// Up to orbit_plies colored vertices, only one vertex per orbit of the
+// automorphisms fixing the current coloring is tried. At any depth, a
+// vertex is skipped if it has an uncolored twin (same open or closed
+// neighborhood) of smaller index. Graphs of more than 64 vertices get no
+// symmetries here.
+class graph_symmetry {
+  public:
+	explicit graph_symmetry(const graph& g, int orbit_plies = DEFAULT_ORBIT_PLIES);
+
+	index_t candidate_vertices(const bitboard_coloring& col, search_counters& counters) const;
+
+	// The same for a coloring given by its uncolored vertices, its color
+	// classes and its number of colored vertices
+	index_t candidate_vertices(index_t uncols, const index_t* classes, int num_cols, int ply, search_counters& counters) const;
+
+	index_t twins_below(index_t v) const;
+	const std::vector<index_t>& root_orbits() const;
+	const std::vector<std::vector<int>>& generators() const;
+	double group_order() const;
+	int orbit_plies() const;
+
+  private:
+	const graph& g_;
+	const int orbit_plies_;
+	std::vector<index_t> twins_below_;
+	index_t has_twin_below_{ 0 };
+	std::vector<index_t> root_orbits_;
+	std::vector<std::vector<int>> generators_;
+	std::vector<std::vector<int>> elements_;
+	double group_order_{ 1 };
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "tablebase.hpp"
+
+#include "graph.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace {
+	// The coloring with colors[u] at u, 0 for uncolored and c + 1 for color c,
+	// is entry sum colors[u] * (num_cols + 1)^u. A child adds (c + 1) * 
+	// (num_cols + 1)^u to its parent, so its entry is always further on.
+	class tablebase {
+	  public:
+		tablebase(const graph& g, int num_cols)
+			: g_(g),
+			n_(g.num_vertices()),
+			num_cols_(num_cols),
+			all_(n_ >= 64 ? ALL_ONES : (1ULL << n_) - 1),
+			powers_(n_ + 1, 1),
+			bits_((tablebase_bytes(n_, num_cols) + 7) / 8)
+		{
+			for (int u = 1; u <= n_; ++u) {
+				powers_[u] = powers_[u - 1] * (num_cols + 1);
+			}
+		}
+
+		// Decides the colorings with layer colored vertices, once those with
+		// one more are decided
+		std::uint64_t solve_layer(int layer, int threads) {
+			std::vector<index_t> subsets;
+			for (index_t colored = 0; colored <= all_; ++colored) {
+				if (std::popcount(colored) == layer) {
+					subsets.push_back(colored);
+				}
+			}
+
+			std::atomic<std::size_t> next{ 0 };
+			std::atomic<std::uint64_t> decided{ 0 };
+
+			const auto work = [&]() {
+				std::uint64_t states = 0;
+				std::array<index_t, MAX_TABLEBASE_COLORS> attack{};
+
+				for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < subsets.size(); ) {
+					color_subset(subsets[i], subsets[i], 0, attack, layer % 2 == 0, states);
+				}
+
+				decided.fetch_add(states, std::memory_order_relaxed);
+			};
+
+			// Small layers are not worth a thread
+			if (threads <= 1 || subsets.size() < static_cast<std::size_t>(threads)) {
+				work();
+			}
+			else {
+				std::vector<std::thread> pool;
+				for (int t = 0; t < threads; ++t) {
+					pool.emplace_back(work);
+				}
+				for (auto& thread : pool) {
+					thread.join();
+				}
+			}
+
+			return decided.load();
+		}
+
+		bool alice_wins(std::uint64_t entry) const {
+			return (bits_[entry / 64].load(std::memory_order_relaxed) >> (entry % 64) & 1) != 0;
+		}
+
+	  private:
+		// Every proper coloring of the vertices of colored, with the lowest
+		// ones of rest still to color
+		void color_subset(index_t colored, index_t rest, std::uint64_t entry,
+			std::array<index_t, MAX_TABLEBASE_COLORS>& attack, bool alice, std::uint64_t& states) {
+			if (rest == 0) {
+				++states;
+				if (decide(colored, entry, attack, alice)) {
+					bits_[entry / 64].fetch_or(1ULL << (entry % 64), std::memory_order_relaxed);
+				}
+				return;
+			}
+
+			const int v = std::countr_zero(rest);
+			const index_t nbrs = g_.get_neighbors(v);
+
+			for (int c = 0; c < num_cols_; ++c) {
+				if ((attack[c] >> v & 1) != 0) {
+					continue;
+				}
+
+				const index_t saved = attack[c];
+				attack[c] |= nbrs;
+				color_subset(colored, rest & (rest - 1), entry + (c + 1) * powers_[v], attack, alice, states);
+				attack[c] = saved;
+			}
+		}
+
+		bool decide(index_t colored, std::uint64_t entry, const std::array<index_t, MAX_TABLEBASE_COLORS>& attack,
+			bool alice) const {
+			const index_t uncols = all_ & ~colored;
+
+			if (uncols == 0) {
+				return true;
+			}
+
+			index_t blocked = uncols;
+			for (int c = 0; c < num_cols_; ++c) {
+				blocked &= attack[c];
+			}
+
+			if (blocked != 0) {
+				return false;
+			}
+
+			for (index_t rest = uncols; rest != 0; rest &= rest - 1) {
+				const int u = std::countr_zero(rest);
+
+				for (int c = 0; c < num_cols_; ++c) {
+					if ((attack[c] >> u & 1) == 0 && alice_wins(entry + (c + 1) * powers_[u]) == alice) {
+						return alice;
+					}
+				}
+			}
+
+			return !alice;
+		}
+
+		const graph& g_;
+		const int n_;
+		const int num_cols_;
+		const index_t all_;
+		std::vector<std::uint64_t> powers_;
+		std::vector<std::atomic<std::uint64_t>> bits_;
+	};
+}
+
+std::size_t tablebase_bytes(int n, int num_cols) {
+	if (n > static_cast<int>(BIT_LEN) || num_cols < 1 || num_cols > MAX_TABLEBASE_COLORS) {
+		return std::numeric_limits<std::size_t>::max();
+	}
+
+	// Entries up to 2^60, so that the bits of a table can be counted
+	std::uint64_t entries = 1;
+	for (int u = 0; u < n; ++u) {
+		if (entries > (1ULL << 60) / (num_cols + 1)) {
+			return std::numeric_limits<std::size_t>::max();
+		}
+		entries *= num_cols + 1;
+	}
+
+	return (entries + 7) / 8;
+}
+
+Victory solve_outcome_tablebase(const graph& g, int num_cols, search_counters* counters, const search_options& options) {
+	assert(tablebase_bytes(g.num_vertices(), num_cols) != std::numeric_limits<std::size_t>::max());
+
+	tablebase table(g, num_cols);
+	std::uint64_t decided = 0;
+
+	for (int layer = g.num_vertices(); layer >= 0; --layer) {
+		decided += table.solve_layer(layer, options.threads_);
+	}
+
+	if (counters != nullptr) {
+		++counters->tablebase_solves_;
+		counters->tablebase_states_ += decided;
+	}
+
+	return table.alice_wins(0) ? Victory::Alice : Victory::Bob;
+}
\ No newline at end of file
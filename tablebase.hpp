@@ -0,0 +1,29 @@
+#ifndef TABLEBASE_HPP
+#define TABLEBASE_HPP
+
+#include "common.hpp"
+#include "game_state.hpp"
+#include "minimax.hpp"
+
+#include <cstddef>
+
+class graph;
+
+// Largest number of colors of a tablebase
+static constexpr int MAX_TABLEBASE_COLORS = 8;
+
+// Bytes of the tablebase of a graph of n vertices in num_cols colors: one
+// bit for every coloring that leaves each vertex uncolored or gives it one
+// of the colors, whether proper or not. SIZE_MAX if there is no tablebase.
+std::size_t tablebase_bytes(int n, int num_cols);
+
+// As solve_outcome(), by retrograde analysis: every proper coloring is
+// decided from those with one more colored vertex, starting from the full
+// colorings, and the table keeps one bit for each. The colorings with the
+// same number of colored vertices are split between options.threads_
+// threads. Time and memory only depend on the order of g and num_cols, not
+// on how hard the game is.
+Victory solve_outcome_tablebase(const graph& g, int num_cols, search_counters* counters = nullptr,
+	const search_options& options = search_options());
+
+#endif
\ No newline at end of file
@@ -1,12 +1,45 @@
 #include "tests.hpp"
 #include "graph.hpp"
 #include "vertex_coloring.hpp"
+#include "bitboard_coloring.hpp"
 #include "common.hpp"
 #include "minimax.hpp"
-
+#include "game_state.hpp"
+#include "transposition_table.hpp"
+#include "zobrist.hpp"
+#include "symmetry.hpp"
+#include "dfpn.hpp"
+#include "batch.hpp"
+#include "result_store.hpp"
+#include "mapped_file.hpp"
+#include "graph6.hpp"
+#include "bitset.hpp"
+#include "wide_search.hpp"
+#include "fixed_coloring.hpp"
+#include "fixed_search.hpp"
+#include "endgame.hpp"
+#include "tablebase.hpp"
+#include "bounds.hpp"
+#include "bench_suite.hpp"
+#include "perf_counters.hpp"
+#include "progress.hpp"
+#include "estimate.hpp"
+
+#include <algorithm>
 #include <cassert>
+#include <bit>
 #include <bitset>
 #include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <limits>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string_view>
+#include <thread>
 
 namespace {
 	// A 4-cycle with a chord and a pendant
@@ -21,6 +54,16 @@ namespace {
 
 		return g;
 	}
+
+	// Solvers with a table of their own, as in batch runs
+	solver_factory get_test_solver(std::size_t megabytes = 1) {
+		return [megabytes]() -> outcome_solver {
+			auto tt = std::make_shared<transposition_table>(megabytes);
+			return [tt](const graph& g, int num_cols, const graph_symmetry& sym, search_counters& counters) {
+				return solve_outcome(g, num_cols, *tt, &sym, &counters);
+			};
+		};
+	}
 }
 
 void test_all() {
@@ -29,6 +72,30 @@ void test_all() {
 	test_full_coloring();
 	test_deadend();
 	test_minimax();
+	test_transposition_table();
+	test_solve_outcome();
+	test_bitboard_coloring();
+	test_color_symmetry();
+	test_graph_symmetry();
+	test_move_ordering();
+	test_dfpn();
+	test_parallel_search();
+	test_batch();
+	test_result_store();
+	test_mapped_file();
+	test_graph6();
+	test_wide_graphs();
+	test_fixed_kernels();
+	test_safe_reductions();
+	test_bob_threats();
+	test_endgame();
+	test_tablebase();
+	test_bounds();
+	test_search_stats();
+	test_bench_suite();
+	test_perf_counters();
+	test_progress();
+	test_estimate();
 }
 
 void test_graph() {
@@ -90,6 +157,48 @@ void test_graph() {
 		// A graph on 27 vertices with clique number 4
 		graph g = read_graph6("Z???O__O?G??????cCA?_A_?P???ECGOA?G@?hI?oGW_bQS_PPjW@{D~}?Jw");
 		assert(has_triangle(g) && has_k_four(g));
+		assert(clique_number(g) == 4 && !has_clique(g, 5));
+	}
+
+	{
+		for (int i = 1; i < 10; ++i) {
+			assert(clique_number(get_complete_graph(i)) == i);
+		}
+
+		assert(clique_number(graph(5)) == 1 && clique_number(graph(0)) == 0);
+		assert(clique_number(get_cycle(9)) == 2 && clique_number(get_wheel(9)) == 3);
+
+		// The largest subset whose pairs are all edges
+		std::mt19937_64 rng(20);
+
+		for (int trial = 0; trial < 200; ++trial) {
+			const int n = 1 + trial % 12;
+			graph g(n);
+
+			for (int u = 0; u < n; ++u) {
+				for (int v = u + 1; v < n; ++v) {
+					if (rng() % (2 + trial % 3) != 0) {
+						g.add_edge(u, v);
+					}
+				}
+			}
+
+			int largest = 0;
+			for (index_t subset = 1; subset < (1ULL << n); ++subset) {
+				bool clique = true;
+				for (index_t rest = subset; rest != 0 && clique; rest &= rest - 1) {
+					const int u = std::countr_zero(rest);
+					clique = (g.get_neighbors(u) | (1ULL << u) | ~subset) == ALL_ONES;
+				}
+
+				if (clique) {
+					largest = std::max(largest, std::popcount(subset));
+				}
+			}
+
+			assert(clique_number(g) == largest);
+			assert(has_triangle(g) == (largest >= 3) && has_k_four(g) == (largest >= 4));
+		}
 	}
 
 	std::cout << "OK\n";
@@ -420,5 +529,2060 @@ void test_minimax() {
 		std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count() / 1000.0 << "s \n";
 	}
 
+	std::cout << "OK\n";
+}
+
+void test_transposition_table() {
+	std::cout << "Testing transposition table ... ";
+
+	{
+		// Keys are maintained incrementally and do not depend on move order
+		graph g = get_test_graph();
+		vertex_coloring col1(g, 3);
+		vertex_coloring col2(g, 3);
+
+		assert(col1.zobrist_hash() == 0);
+
+		col1.color_vertex(0, 0);
+		col1.color_vertex(4, 1);
+		col2.color_vertex(4, 1);
+		col2.color_vertex(0, 0);
+
+		assert(col1.zobrist_hash() == col2.zobrist_hash());
+		assert(col1.zobrist_hash() == (zobrist_key(0, 0) ^ zobrist_key(4, 1)));
+
+		col1.uncolor_vertex(4, 1);
+		col1.uncolor_vertex(0, 0);
+		assert(col1.zobrist_hash() == 0);
+	}
+
+	{
+		transposition_table tt(1);
+		tt_entry e;
+
+		assert(!tt.probe(42, e));
+
+		tt.store(42, -7, Bound::Upper, 5, move(3, 1));
+		assert(tt.probe(42, e));
+		assert(e.value_ == -7 && e.bound_ == Bound::Upper && e.depth_ == 5);
+		assert(e.vertex_ == 3 && e.color_ == 1);
+
+		// Same key overwrites in place
+		tt.store(42, 9, Bound::Exact, 5, move(2, 0));
+		assert(tt.probe(42, e) && e.value_ == 9 && e.bound_ == Bound::Exact);
+
+		// A new search does not see the entries of the previous one
+		tt.new_search();
+		assert(!tt.probe(42, e));
+	}
+
+	{
+		// When a bucket is full, the shallowest entry is replaced
+		transposition_table tt(1);
+		const index_t stride = tt.num_entries() / TT_BUCKET_SIZE;
+		tt_entry e;
+
+		for (index_t i = 0; i < TT_BUCKET_SIZE; ++i) {
+			tt.store(i * stride, 1, Bound::Exact, 10 + i, move());
+		}
+
+		tt.store(TT_BUCKET_SIZE * stride, 1, Bound::Exact, 20, move());
+
+		assert(!tt.probe(0, e));
+		for (index_t i = 1; i <= TT_BUCKET_SIZE; ++i) {
+			assert(tt.probe(i * stride, e));
+		}
+	}
+
+	{
+		// Searching with and without a table gives the same scores
+		const std::vector<std::string> graphs = { "G?AFCs", "GQz~vk", "FhCKG", "E?~o" };
+
+		for (const auto& s : graphs) {
+			graph g = read_graph6(s);
+
+			for (int k = 2; k <= 4; ++k) {
+				bitboard_coloring col1(g, k);
+				game_state plain(col1);
+
+				bitboard_coloring col2(g, k);
+				transposition_table tt(1);
+				game_state cached(col2, &tt);
+
+				assert(minimax(plain, true).second == minimax(cached, true).second);
+				assert(play_optimally(g, k).first == play_optimally(g, k, tt).first);
+			}
+		}
+	}
+
+	std::cout << "OK\n";
+}
+
+void test_solve_outcome() {
+	std::cout << "Testing solve_outcome ... ";
+
+	{
+		// Agrees with playing the game out via minimax
+		const std::vector<std::string> graphs = { "G?AFCs", "GQz~vk", "FhCKG", "E?~o", "H?AADrq" };
+
+		for (const auto& s : graphs) {
+			graph g = read_graph6(s);
+
+			for (int k = 2; k <= 4; ++k) {
+				transposition_table tt(1);
+				const Victory win = solve_outcome(g, k, tt);
+				assert(win == play_optimally(g, k).first);
+
+				// The principal line ends in a win for the same player
+				auto line = principal_line(g, k, tt);
+				assert(line.first == win);
+				assert(!line.second.empty());
+			}
+		}
+	}
+
+	{
+		graph g = get_cycle(4);
+		assert(solve_outcome(g, 2) == Victory::Bob);
+		assert(solve_outcome(g, 3) == Victory::Alice);
+
+		for (int i = 3; i < 8; ++i) {
+			assert(solve_outcome(get_star(i), 2) == Victory::Alice);
+		}
+	}
+
+	std::cout << "OK\n";
+}
+
+void test_bitboard_coloring() {
+	std::cout << "Testing bitboard coloring ... ";
+
+	{
+		graph g = get_complete_graph(3);
+		bitboard_coloring col(g, 2);
+
+		col.color_vertex(0, 0);
+		col.color_vertex(1, 1);
+		assert(col.is_deadend());
+		assert(!col.has_conflict());
+
+		col.uncolor_vertex(1, 1);
+		assert(!col.is_deadend());
+		assert(col.get_allowed_colors(1) == 0b10);
+	}
+
+	{
+		// Random games (with conflicts allowed) agree with vertex_coloring
+		const std::vector<std::string> graphs = { "G?AFCs", "GQz~vk", "H?AADrq", "E?~o" };
+		std::mt19937 gen(1);
+
+		for (const auto& s : graphs) {
+			graph g = read_graph6(s);
+
+			for (int k = 2; k <= 5; ++k) {
+				vertex_coloring ref(g, k);
+				bitboard_coloring col(g, k);
+				std::vector<move> played;
+
+				for (int step = 0; step < 200; ++step) {
+					const bool undo = !played.empty() &&
+						(col.is_colored() || std::uniform_int_distribution<int>(0, 2)(gen) == 0);
+
+					if (undo) {
+						const move m = played.back();
+						played.pop_back();
+						ref.uncolor_vertex(m.vertex_, m.color_);
+						col.uncolor_vertex(m.vertex_, m.color_);
+					}
+					else {
+						const auto uncols = col.uncolored();
+						auto u = std::uniform_int_distribution<int>(0, g.num_vertices() - 1)(gen);
+						while (!((uncols >> u) & 1ULL)) {
+							u = (u + 1) % g.num_vertices();
+						}
+
+						const int c = std::uniform_int_distribution<int>(0, k - 1)(gen);
+						played.emplace_back(u, c);
+						ref.color_vertex(u, c);
+						col.color_vertex(u, c);
+					}
+
+					assert(ref.is_colored() == col.is_colored());
+					assert(ref.is_deadend() == col.is_deadend());
+					assert(ref.has_conflict() == col.has_conflict());
+					assert(ref.zobrist_hash() == col.zobrist_hash());
+					assert(ref.num_colored_vertices() == col.num_colored_vertices());
+
+					for (index_t i = 0; i < g.num_vertices(); ++i) {
+						assert(ref.get_allowed_colors(i) == col.get_allowed_colors(i));
+						assert(ref.is_colored(i) == col.is_colored(i));
+					}
+				}
+			}
+		}
+	}
+
+	std::cout << "OK\n";
+}
+
+void test_color_symmetry() {
+	std::cout << "Testing color symmetry breaking ... ";
+
+	{
+		graph g = get_test_graph();
+		bitboard_coloring col(g, 4);
+
+		// All colors are unused at first
+		assert(col.representative_colors() == 0b1);
+
+		col.color_vertex(0, 2);
+		assert(col.representative_colors() == 0b101);
+
+		col.color_vertex(4, 1);
+		assert(col.representative_colors() == 0b111);
+
+		// Colors 0 and 2 are blocked at both uncolored vertices 1 and 3,
+		// while colors 1 and 3 are blocked at neither
+		col.color_vertex(2, 0);
+		assert(col.representative_colors() == 0b11);
+	}
+
+	{
+		// Pruning interchangeable colors preserves scores and outcomes
+		const std::vector<std::string> graphs = { "G?AFCs", "GQz~vk", "FhCKG", "E?~o", "H?AADrq" };
+
+		for (const auto& s : graphs) {
+			graph g = read_graph6(s);
+
+			for (int k = 2; k <= 5; ++k) {
+				bitboard_coloring col1(g, k);
+				game_state full(col1);
+				full.break_color_symmetry_ = false;
+
+				bitboard_coloring col2(g, k);
+				game_state reduced(col2);
+
+				if (g.num_vertices() < 9) {
+					assert(minimax(full, true).second == minimax(reduced, true).second);
+				}
+
+				assert(alice_wins(full) == alice_wins(reduced));
+			}
+		}
+	}
+
+	std::cout << "OK\n";
+}
+
+void test_graph_symmetry() {
+	std::cout << "Testing graph symmetry ... ";
+
+	{
+		// Orders of the automorphism groups of cycles, stars and wheels
+		for (int n = 5; n < 12; ++n) {
+			const graph_symmetry cycle(get_cycle(n));
+			assert(cycle.group_order() == 2 * n);
+			assert(cycle.root_orbits().size() == 1);
+
+			const graph_symmetry wheel(get_wheel(n));
+			assert(wheel.group_order() == 2 * (n - 1));
+			assert(wheel.root_orbits().size() == 2);
+		}
+
+		double factorial = 1;
+		for (int n = 3; n < 10; ++n) {
+			factorial *= n - 1;
+			const graph_symmetry star(get_star(n));
+			assert(star.group_order() == factorial);
+			assert(star.root_orbits().size() == 2);
+		}
+	}
+
+	{
+		// The generators are automorphisms
+		graph g = read_graph6("G?AFCs");
+		const graph_symmetry sym(g);
+
+		for (const auto& perm : sym.generators()) {
+			for (index_t u = 0; u < g.num_vertices(); ++u) {
+				for (index_t v = u + 1; v < g.num_vertices(); ++v) {
+					assert(g.has_edge(u, v) == g.has_edge(perm[u], perm[v]));
+				}
+			}
+		}
+	}
+
+	{
+		// Leaves of a star are twins, the center is not
+		graph g = get_star(5);
+		const graph_symmetry sym(g);
+
+		assert(sym.twins_below(0) == 0);
+		assert(sym.twins_below(1) == 0);
+		assert(sym.twins_below(4) == 0b1110);
+	}
+
+	{
+		// Pruning symmetric vertices preserves scores and outcomes
+		const std::vector<std::string> graphs = { "G?AFCs", "GQz~vk", "FhCKG", "E?~o", "H?AADrq", 
+			"I?D_f@Z_o", "IKc@g[OOG", "Igh?c?ECO" };
+
+		for (const auto& s : graphs) {
+			graph g = read_graph6(s);
+			const graph_symmetry sym(g);
+
+			for (int k = 2; k <= 4; ++k) {
+				bitboard_coloring col1(g, k);
+				game_state plain(col1);
+
+				bitboard_coloring col2(g, k);
+				game_state pruned(col2, nullptr, &sym);
+
+				if (g.num_vertices() < 9) {
+					assert(minimax(plain, true).second == minimax(pruned, true).second);
+				}
+
+				assert(alice_wins(plain) == alice_wins(pruned));
+			}
+		}
+	}
+
+	std::cout << "OK\n";
+}
+
+void test_move_ordering() {
+	std::cout << "Testing move ordering ... ";
+
+	{
+		// Moves come out once each, the hint first
+		graph g = read_graph6("G?AFCs");
+		bitboard_coloring col(g, 3);
+		col.color_vertex(0, 1);
+
+		move_orderer ordering(g);
+		const index_t vertices = col.uncolored();
+		const auto& moves = ordering.order_moves(col, vertices, ALL_ONES, move(5, 2));
+
+		assert(moves.front().vertex_ == 5 && moves.front().color_ == 2);
+
+		std::size_t expected = 0;
+		for (index_t rest = vertices; rest != 0; rest &= rest - 1) {
+			expected += std::popcount(col.get_allowed_colors(std::countr_zero(rest)));
+		}
+		assert(moves.size() == expected);
+
+		for (std::size_t i = 0; i < moves.size(); ++i) {
+			assert(col.is_allowed(moves[i].vertex_, moves[i].color_));
+			for (std::size_t j = i + 1; j < moves.size(); ++j) {
+				assert(moves[i].vertex_ != moves[j].vertex_ || moves[i].color_ != moves[j].color_);
+			}
+		}
+	}
+
+	{
+		// Every policy gives the same scores and outcomes
+		const std::vector<Ordering> policies = { Ordering::Natural, Ordering::Static, Ordering::History };
+		const std::vector<std::string> graphs = { "G?AFCs", "GQz~vk", "FhCKG", "H?AADrq", "IKc@g[OOG" };
+
+		for (const auto& s : graphs) {
+			graph g = read_graph6(s);
+
+			for (int k = 2; k <= 4; ++k) {
+				bitboard_coloring col1(g, k);
+				game_state natural(col1);
+				natural.ordering_.set_policy(true, Ordering::Natural);
+				natural.ordering_.set_policy(false, Ordering::Natural);
+
+				const bool win = alice_wins(natural);
+				const int score = g.num_vertices() < 9 ? minimax(natural, true).second : 0;
+
+				for (const auto alice : policies) {
+					for (const auto bob : policies) {
+						bitboard_coloring col2(g, k);
+						game_state ordered(col2);
+						ordered.ordering_.set_policy(true, alice);
+						ordered.ordering_.set_policy(false, bob);
+
+						assert(alice_wins(ordered) == win);
+						if (g.num_vertices() < 9) {
+							assert(minimax(ordered, true).second == score);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	{
+		Ordering ordering;
+		assert(parse_ordering("history", ordering) && ordering == Ordering::History);
+		assert(parse_ordering(to_string(Ordering::Static), ordering) && ordering == Ordering::Static);
+		assert(!parse_ordering("random", ordering));
+	}
+
+	std::cout << "OK\n";
+}
+
+void test_dfpn() {
+	std::cout << "Testing proof-number search ... ";
+
+	{
+		pn_table table(1);
+		std::uint32_t pn = 0;
+		std::uint32_t dn = 0;
+
+		assert(!table.probe(42, pn, dn));
+
+		table.store(42, 3, 5);
+		assert(table.probe(42, pn, dn) && pn == 3 && dn == 5);
+
+		// Same key overwrites in place
+		table.store(42, 0, PN_INFINITY);
+		assert(table.probe(42, pn, dn) && pn == 0 && dn == PN_INFINITY);
+
+		// A new search does not see the entries of the previous one
+		table.new_search();
+		assert(!table.probe(42, pn, dn));
+	}
+
+	{
+		// When a bucket is full, solved entries outlive unsolved ones
+		pn_table table(1);
+		const index_t stride = table.num_entries() / PN_BUCKET_SIZE;
+		std::uint32_t pn = 0;
+		std::uint32_t dn = 0;
+
+		table.store(0, PN_INFINITY, 0);
+		table.store(stride, 2, 2);
+		table.store(2 * stride, 1, 1);
+		table.store(3 * stride, 4, 4);
+
+		assert(table.probe(0, pn, dn));
+		assert(table.probe(stride, pn, dn));
+		assert(!table.probe(2 * stride, pn, dn));
+		assert(table.probe(3 * stride, pn, dn));
+	}
+
+	{
+		// Agrees with alpha-beta, with and without symmetry pruning
+		const std::vector<std::string> graphs = { "G?AFCs", "GQz~vk", "FhCKG", "E?~o", "H?AADrq", 
+			"I?D_f@Z_o", "IKc@g[OOG", "Igh?c?ECO" };
+		pn_table table(1);
+		transposition_table tt(1);
+
+		for (const auto& s : graphs) {
+			graph g = read_graph6(s);
+
+			for (int k = 1; k <= 5; ++k) {
+				const Victory win = solve_outcome(g, k, tt);
+				assert(solve_outcome_dfpn(g, k, table) == win);
+
+				bitboard_coloring col(g, k);
+				game_state plain(col);
+				table.new_search();
+				assert(dfpn_alice_wins(plain, table) == (win == Victory::Alice));
+			}
+		}
+	}
+
+	{
+		Engine engine;
+		assert(parse_engine("dfpn", engine) && engine == Engine::ProofNumber);
+		assert(parse_engine(to_string(Engine::AlphaBeta), engine) && engine == Engine::AlphaBeta);
+		assert(parse_engine(to_string(Engine::Tablebase), engine) && engine == Engine::Tablebase);
+		assert(!parse_engine("mcts", engine));
+	}
+
+	std::cout << "OK\n";
+}
+
+void test_parallel_search() {
+	std::cout << "Testing parallel search ... ";
+
+	{
+		// Concurrent stores into a tiny table never produce an entry that 
+		// mixes two stores: every hit carries the value stored with its key
+		transposition_table tt(1);
+		std::vector<std::thread> threads;
+
+		for (int t = 0; t < 4; ++t) {
+			threads.emplace_back([&tt, t]() {
+				std::mt19937_64 rng(t);
+				tt_entry e;
+
+				for (int i = 0; i < 200000; ++i) {
+					const index_t key = rng() % 100000;
+					const int value = static_cast<int>(key % 1000);
+
+					if (tt.probe(key, e)) {
+						assert(e.value_ == value && e.depth_ == key % 64);
+						assert(e.vertex_ == static_cast<int>(key % 50));
+					}
+
+					tt.store(key, value, Bound::Exact, key % 64, move(key % 50, t));
+				}
+			});
+		}
+
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+
+	{
+		// Any number of threads gives the serial outcome
+		const std::vector<std::string> graphs = { "G?AFCs", "GQz~vk", "H?AADrq", "I?D_f@Z_o", "IKc@g[OOG" };
+		transposition_table serial_tt(1);
+		transposition_table parallel_tt(1);
+
+		for (const auto& s : graphs) {
+			graph g = read_graph6(s);
+
+			for (int k = 2; k <= 4; ++k) {
+				const Victory win = solve_outcome(g, k, serial_tt);
+
+				for (int threads = 2; threads <= 4; ++threads) {
+					search_options options;
+					options.threads_ = threads;
+					search_counters counters;
+
+					assert(solve_outcome(g, k, parallel_tt, nullptr, &counters, options) == win);
+					assert(counters.nodes_ > 0);
+				}
+			}
+		}
+	}
+
+	std::cout << "OK\n";
+}
+
+void test_batch() {
+	std::cout << "Testing batch driver ... ";
+
+	const std::vector<std::string> graphs = { "G?AFCs", "GQz~vk", "FhCKG", "E?~o", "H?AADrq", 
+		"I?D_f@Z_o", "IKc@g[OOG", "Igh?c?ECO" };
+
+	const solver_factory make_solver = get_test_solver();
+
+	std::string input;
+	std::string expected;
+	for (const auto& s : graphs) {
+		search_counters counters;
+		std::vector<solve_record> solves;
+		const int k = game_chromatic_number(read_graph6(s), make_solver(), counters, solves);
+
+		input += s + "\n";
+		expected += s + " " + std::to_string(k) + " " + std::to_string(solves.size()) + "\n";
+	}
+
+	const auto sorted_lines = [](const std::string& text) {
+		std::vector<std::string> lines;
+		std::istringstream iss(text);
+		for (std::string line; std::getline(iss, line); ) {
+			lines.push_back(line);
+		}
+
+		std::sort(lines.begin(), lines.end());
+		return lines;
+	};
+
+	for (int workers = 1; workers <= 4; ++workers) {
+		batch_options options;
+		options.workers_ = workers;
+		options.queue_capacity_ = 2;
+		options.verbose_ = false;
+
+		{
+			// In input order
+			std::istringstream in(input);
+			std::ostringstream out;
+			const batch_report report = run_g6_batch(in, out, make_solver, options);
+
+			assert(out.str() == expected);
+			assert(report.graphs_ == graphs.size() && report.skipped_ == 0);
+			assert(report.workers_.size() == static_cast<std::size_t>(workers));
+
+			std::uint64_t solved = 0;
+			for (const auto& w : report.workers_) {
+				solved += w.graphs_;
+			}
+			assert(solved == graphs.size());
+		}
+
+		{
+			// In completion order, leaving out the lines already solved
+			options.completion_order_ = true;
+
+			std::istringstream in(input);
+			std::ostringstream out;
+			const batch_report report = run_g6_batch(in, out, make_solver, options, 
+				[](std::string_view line) { return line == "FhCKG"; });
+
+			auto lines = sorted_lines(expected);
+			lines.erase(std::find_if(lines.begin(), lines.end(), [](const std::string& line) { return line.starts_with("FhCKG "); }));
+
+			assert(sorted_lines(out.str()) == lines);
+			assert(report.graphs_ == graphs.size() - 1 && report.skipped_ == 1);
+		}
+	}
+
+	std::cout << "OK\n";
+}
+
+void test_result_store() {
+	std::cout << "Testing result store ... ";
+
+	const auto dir = std::filesystem::temp_directory_path();
+	const std::string path = (dir / "vcg-test-store.result").string();
+	const std::string shard = (dir / "vcg-test-shard.result").string();
+	const std::string merged = (dir / "vcg-test-merged.result").string();
+
+	const auto read_file = [](const std::string& file) {
+		std::ifstream in(file, std::ios::binary);
+		return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	};
+
+	const auto write_file = [](const std::string& file, const std::string& text) {
+		std::ofstream out(file, std::ios::binary | std::ios::trunc);
+		out << text;
+	};
+
+	{
+		// The index grows past its initial size
+		result_index index;
+		for (int i = 0; i < 5000; ++i) {
+			assert(index.insert("g" + std::to_string(i), i % 7));
+		}
+
+		assert(!index.insert("g42", 0));
+		assert(index.size() == 5000);
+
+		for (int i = 0; i < 5000; ++i) {
+			assert(index.find("g" + std::to_string(i)) == i % 7);
+		}
+		assert(index.find("h1") == NO_RESULT);
+	}
+
+	{
+		std::string_view graph6;
+		int k = 0;
+
+		assert(parse_result_line("H?AADrq 3", graph6, k) && graph6 == "H?AADrq" && k == 3);
+		assert(parse_result_line("H?AADrq 3\r", graph6, k) && k == 3);
+		assert(!parse_result_line("H?AADrq", graph6, k));
+		assert(!parse_result_line("H?AADrq ", graph6, k));
+		assert(!parse_result_line(" 3", graph6, k));
+		assert(!parse_result_line("H?AADrq 3x", graph6, k));
+		assert(parse_result_line("H?AADrq 3 2", graph6, k) && graph6 == "H?AADrq" && k == 3);
+	}
+
+	{
+		// A last line cut short by a crash is dropped from the file
+		write_file(path, "G?AFCs 4\nGQz~vk 5\nH?AA");
+
+		{
+			result_store store(path);
+			assert(store.size() == 2 && store.num_dropped() == 1);
+			assert(store.find("G?AFCs") == 4 && store.find("GQz~vk") == 5);
+			assert(!store.contains("H?AA") && !store.contains("H?AADrq"));
+			assert(read_file(path) == "G?AFCs 4\nGQz~vk 5\n");
+
+			store.append("H?AADrq", 3);
+			store.append("G?AFCs", 4);
+			store.stream() << "FhCKG 3\n";
+			assert(store.is_open() && store.flush());
+		}
+
+		result_store store(path);
+		assert(store.size() == 4 && store.num_dropped() == 0);
+		assert(store.find("H?AADrq") == 3 && store.find("FhCKG") == 3);
+		assert(read_file(path) == "G?AFCs 4\nGQz~vk 5\nH?AADrq 3\nFhCKG 3\n");
+	}
+
+	{
+		// A file that cannot be written fails to open, and its writes fail
+		result_store store((dir / "vcg-test-missing" / "vcg-test-store.result").string());
+		assert(!store.is_open() && store.size() == 0);
+
+		store.append("H?AADrq", 3);
+		assert(!store.flush());
+	}
+
+	{
+		// Merging keeps first results, with all their fields, and reports
+		// duplicates and conflicts
+		write_file(shard, "E?~o 3 1\nH?AADrq 3\nGQz~vk 4\nbad\n");
+
+		const merge_report report = merge_results({ path, shard }, merged);
+		assert(report.results_ == 5 && report.duplicates_ == 1);
+		assert(report.conflicts_ == 1 && report.dropped_ == 1);
+		assert(read_file(merged) == "G?AFCs 4\nGQz~vk 5\nH?AADrq 3\nFhCKG 3\nE?~o 3 1\n");
+
+		// Compaction in place
+		write_file(shard, "E?~o 3\nE?~o 3\nFhCKG 3\n");
+		assert(merge_results({ shard }, shard).results_ == 2);
+		assert(read_file(shard) == "E?~o 3\nFhCKG 3\n");
+	}
+
+	{
+		// A missing input fails the merge and leaves the output untouched
+		const std::string missing = (dir / "vcg-test-missing.result").string();
+		std::filesystem::remove(missing);
+
+		const merge_report report = merge_results({ shard, missing }, merged);
+		assert(report.failed_ == 1);
+		assert(read_file(merged) == "G?AFCs 4\nGQz~vk 5\nH?AADrq 3\nFhCKG 3\nE?~o 3 1\n");
+		assert(!std::filesystem::exists(merged + ".tmp"));
+	}
+
+	std::filesystem::remove(path);
+	std::filesystem::remove(shard);
+	std::filesystem::remove(merged);
+
+	std::cout << "OK\n";
+}
+
+void test_mapped_file() {
+	std::cout << "Testing mapped file ... ";
+
+	const std::string path = (std::filesystem::temp_directory_path() / "vcg-test-mapped.g6").string();
+
+	const auto write_file = [&path](const std::string& text) {
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		out << text;
+	};
+
+	{
+		// Both scans agree with a plain one at every alignment
+		std::string text(100, 'x');
+		for (std::size_t i = 0; i < text.size(); i += 7) {
+			text[i] = '\n';
+		}
+
+		for (std::size_t first = 0; first < 40; ++first) {
+			for (std::size_t last = first; last <= text.size(); last += 13) {
+				const char* p = text.data();
+				assert(find_newline(p + first, p + last) == std::find(p + first, p + last, '\n'));
+				assert(count_newlines(p + first, p + last) == static_cast<std::uint64_t>(std::count(p + first, p + last, '\n')));
+
+				std::vector<std::uint64_t> ends;
+				index_newlines(p, p + first, p + last, ends);
+				assert(ends.size() == count_newlines(p + first, p + last));
+				assert(std::all_of(ends.cbegin(), ends.cend(), [&](std::uint64_t e) { return text[e] == '\n'; }));
+			}
+		}
+	}
+
+	{
+		shard_spec shard;
+		assert(parse_shard("2/5", shard) && shard.index_ == 2 && shard.count_ == 5);
+		assert(!parse_shard("5/5", shard) && !parse_shard("0/0", shard));
+		assert(!parse_shard("1", shard) && !parse_shard("-1/2", shard) && !parse_shard("1/", shard));
+	}
+
+	// Lines of varying length, blank and CRLF lines, and no final line break
+	std::vector<std::string> expected;
+	std::string text;
+	for (int i = 0; i < 3000; ++i) {
+		expected.push_back("G" + std::string(i % 37, static_cast<char>('?' + i % 60)));
+		text += expected.back() + (i % 11 == 0 ? "\r\n" : "\n");
+		if (i % 17 == 0) {
+			text += "\n";
+		}
+	}
+	text.pop_back();
+	write_file(text);
+
+	{
+		const mapped_file file(path);
+		assert(file.is_open() && file.size() == text.size());
+
+		// The shards partition the lines, in order, however many there are
+		for (bool by_lines : { false, true }) {
+			for (int count : { 1, 2, 3, 7, 64, 5000 }) {
+				std::vector<std::string> lines;
+				std::uint64_t previous_end = 0;
+
+				for (int i = 0; i < count; ++i) {
+					shard_lines shard(file, { i, count, by_lines });
+					assert(shard.begin() == previous_end && shard.begin() <= shard.end());
+					previous_end = shard.end();
+
+					std::string_view line;
+					while (shard.next(line)) {
+						lines.emplace_back(line);
+					}
+				}
+
+				assert(previous_end == text.size());
+				assert(lines == expected);
+			}
+		}
+	}
+
+	{
+		write_file("");
+		const mapped_file file(path);
+		std::string_view line;
+		assert(file.is_open() && file.size() == 0 && !shard_lines(file).next(line));
+	}
+
+	std::filesystem::remove(path);
+	assert(!mapped_file(path).is_open());
+
+	std::cout << "OK\n";
+}
+
+void test_graph6() {
+	std::cout << "Testing graph6 decoding ... ";
+
+	// Bit by bit from the format description
+	const auto decode_slowly = [](const std::string& s, std::vector<index_t>& rows) {
+		const bool digraph = s[0] == '&';
+		const std::size_t header = digraph + (s[digraph] == '~' ? 4 : 1);
+		const int n = static_cast<int>(rows.size());
+		std::size_t t = 0;
+
+		const auto bit = [&]() {
+			const int x = s[header + t / 6] - 63;
+			const bool b = (x >> (5 - t % 6)) & 1;
+			++t;
+			return b;
+		};
+
+		for (int a = 0; a < n; ++a) {
+			for (int b = 0; b < (digraph ? n : a); ++b) {
+				// Columns of the upper triangle, or rows of the matrix
+				if (bit() && a != b) {
+					rows[a] |= 1ULL << b;
+					rows[b] |= 1ULL << a;
+				}
+			}
+		}
+	};
+
+	std::mt19937_64 rng(20240611);
+
+	for (int n = 0; n <= MAX_GRAPH6_VERTICES; ++n) {
+		for (int density = 0; density <= 4; ++density) {
+			graph g(n);
+			for (int u = 0; u < n; ++u) {
+				for (int v = u + 1; v < n; ++v) {
+					if (static_cast<int>(rng() % 4) < density) {
+						g.add_edge(u, v);
+					}
+				}
+			}
+
+			for (bool digraph : { false, true }) {
+				const std::string s = to_graph6(g, digraph);
+				std::vector<index_t> expected(n, 0);
+				decode_slowly(s, expected);
+
+				index_t rows[MAX_GRAPH6_VERTICES];
+				assert(decode_graph6(s, rows) == n);
+				assert(std::equal(expected.cbegin(), expected.cend(), rows));
+
+				for (int u = 0; u < n; ++u) {
+					assert(rows[u] == g.get_neighbors(u));
+				}
+
+				const graph h = read_graph6(s);
+				assert(h.num_vertices() == static_cast<index_t>(n) && h.num_edges() == g.num_edges());
+			}
+		}
+	}
+
+	{
+		// One-way arcs and loops of a digraph
+		index_t rows[MAX_GRAPH6_VERTICES];
+		assert(decode_graph6("&BQ?", rows) == 3);
+		assert(rows[0] == 0b010 && rows[1] == 0b001 && rows[2] == 0);
+
+		// Malformed lines
+		for (const auto& s : { "", "&", ":Fa@x^", "H?AADr", "H?AADrqq", "H?AAD q", "H?AAD\x80q", "~?@A", "~~?????A" }) {
+			assert(decode_graph6(s, rows) == NOT_GRAPH6);
+		}
+	}
+
+	{
+		// Storage is reused, and a malformed line does not disturb the others
+		graph6_batch batch;
+		const std::vector<std::string_view> first = { "H?AADrq", "GQz~vk", "bad", "G?AFCs" };
+		assert(!batch.decode(first.data(), first.size()));
+		assert(batch.size() == 4 && batch.num_vertices(2) == NOT_GRAPH6);
+
+		for (std::size_t i : { 0, 1, 3 }) {
+			const graph g = read_graph6(first[i]);
+			assert(batch.num_vertices(i) == static_cast<int>(g.num_vertices()));
+			for (int u = 0; u < batch.num_vertices(i); ++u) {
+				assert(batch.rows(i)[u] == g.get_neighbors(u));
+			}
+		}
+
+		const std::vector<std::string_view> second = { "GQz~vk" };
+		assert(batch.decode(second.data(), second.size()));
+		assert(batch.size() == 1 && batch.rows(0)[0] == read_graph6("GQz~vk").get_neighbors(0));
+	}
+
+	std::cout << "OK\n";
+}
+
+void test_wide_graphs() {
+	std::cout << "Testing graphs of more than 64 vertices ... ";
+
+	{
+		wide_bitset<2> b = wide_bitset<2>::below(70);
+		assert(b.count() == 70 && b.test(69) && !b.test(70));
+
+		b.reset(0);
+		b.reset(64);
+		assert(b.lowest() == 1 && b.count() == 68);
+		assert((b & ~b).none() && (b | ~b) == wide_bitset<2>::below(128));
+
+		std::vector<int> elements;
+		(wide_bitset<2>::below(66) & ~wide_bitset<2>::below(62)).for_each([&](int u) { elements.push_back(u); });
+		assert((elements == std::vector<int>{ 62, 63, 64, 65 }));
+
+		static_assert(words_for(64) == 1 && words_for(65) == 2 && words_for(256) == 4 && words_for(257) == 8);
+	}
+
+	{
+		const graph g = get_cycle(200);
+		assert(g.num_vertices() == 200 && g.num_words() == 4 && g.num_edges() == 200);
+		assert(g.has_edge(0, 199) && g.has_edge(63, 64) && !g.has_edge(0, 100));
+		assert(g.get_degree(64) == 2 && !has_triangle(g));
+
+		// Through the header of more than 62 vertices, in both formats
+		for (bool digraph : { false, true }) {
+			const graph h = read_graph6(to_graph6(g, digraph));
+			assert(h.num_vertices() == 200 && h.num_edges() == 200);
+
+			for (int u = 0; u < 200; ++u) {
+				assert(std::equal(g.row(u), g.row(u) + g.num_words(), h.row(u)));
+			}
+		}
+
+		assert(has_triangle(get_wheel(100)) && !has_k_four(get_wheel(100)) && has_k_four(get_complete_graph(70)));
+		assert(clique_number(get_complete_graph(70)) == 70 && clique_number(get_wheel(300)) == 3);
+
+		// A clique of 9 across the words of a sparse graph
+		graph planted(300);
+		for (int u = 0; u < 300; ++u) {
+			planted.add_edge(u, (u + 1) % 300);
+		}
+		for (int i = 0; i < 9; ++i) {
+			for (int j = i + 1; j < 9; ++j) {
+				planted.add_edge(33 * i + 5, 33 * j + 5);
+			}
+		}
+		assert(clique_number(planted) == 9 && has_clique(planted, 9) && !has_clique(planted, 10));
+	}
+
+	{
+		// K(m, m) needs the same number of colors at both widths
+		const auto complete_bipartite = [](int m) {
+			graph g(2 * m);
+			for (int u = 0; u < m; ++u) {
+				for (int v = m; v < 2 * m; ++v) {
+					g.add_edge(u, v);
+				}
+			}
+			return g;
+		};
+
+		transposition_table tt;
+		const graph narrow = complete_bipartite(30);
+		const graph wide = complete_bipartite(45);
+
+		for (int k = 1; k <= 4; ++k) {
+			assert(solve_outcome(narrow, k, tt) == solve_outcome(wide, k, tt));
+			assert(solve_outcome_dfpn(wide, k, *std::make_unique<pn_table>(1)) == solve_outcome(wide, k, tt));
+		}
+
+		// Stars need 2 colors, complete graphs one per vertex
+		const graph star = get_star(300);
+		assert(solve_outcome(star, 1, tt) == Victory::Bob && solve_outcome(star, 2, tt) == Victory::Alice);
+		assert(solve_outcome(get_complete_graph(100), 63, tt) == Victory::Bob);
+
+		search_options options;
+		options.threads_ = 3;
+		assert(solve_outcome(wide, 2, tt, nullptr, nullptr, options) == solve_outcome(wide, 2, tt));
+
+		// The replayed game is legal and ends as solved
+		auto game = play_optimally(star, 2, tt);
+		assert(game.first == Victory::Alice && game.second.size() == 300);
+		assert(game.second.front().vertex_ == 0);
+	}
+
+	{
+		// The batch driver takes wide lines too
+		std::istringstream in(to_graph6(get_star(100)) + "\n" + to_graph6(get_star(200)) + "\n");
+		std::ostringstream out;
+
+		batch_options options;
+		options.verbose_ = false;
+		const batch_report report = run_g6_batch(in, out, get_test_solver(4), options);
+		assert(report.graphs_ == 2 && report.malformed_ == 0);
+		assert(out.str() == to_graph6(get_star(100)) + " 2 1\n" + to_graph6(get_star(200)) + " 2 1\n");
+	}
+
+	std::cout << "OK\n";
+}
+
+void test_fixed_kernels() {
+	std::cout << "Testing fixed kernels ... ";
+
+	{
+		// The same masks as bitboard_coloring along a random game
+		std::mt19937_64 rng(7);
+
+		for (int trial = 0; trial < 50; ++trial) {
+			graph g(12);
+			for (int u = 0; u < 12; ++u) {
+				for (int v = u + 1; v < 12; ++v) {
+					if (rng() % 3 == 0) {
+						g.add_edge(u, v);
+					}
+				}
+			}
+
+			bitboard_coloring col(g, 4);
+			fixed_coloring<1, 4> fixed = fixed_coloring<1, 4>::empty(12);
+
+			while (!col.is_colored() && !col.is_deadend()) {
+				for (int u = 0; u < 12; ++u) {
+					assert(fixed.get_allowed_colors(u) == col.get_allowed_colors(u));
+				}
+				assert(fixed.representative_colors() == col.representative_colors());
+				assert(fixed.hash_ == col.zobrist_hash() && !fixed.is_deadend());
+
+				const index_t uncols = col.uncolored();
+				index_t u = std::countr_zero(uncols);
+				for (int skip = rng() % std::popcount(uncols); skip > 0; --skip) {
+					u = std::countr_zero(uncols & ~((2ULL << u) - 1));
+				}
+
+				const int c = std::countr_zero(col.get_allowed_colors(u));
+				col.color_vertex(u, c);
+				fixed.color_vertex(wide_bitset<1>::from_words(g.row(u)), u, c);
+			}
+
+			assert(fixed.is_colored() == col.is_colored() && fixed.is_deadend() == col.is_deadend());
+		}
+	}
+
+	{
+		// The kernels search the tree of the generic engine
+		const std::vector<std::string> graphs = { "G?AFCs", "GQz~vk", "H?AADrq", "I?D_f@Z_o", "IKc@g[OOG" };
+		transposition_table tt(4);
+
+		for (const auto& s : graphs) {
+			const graph g = read_graph6(s);
+			const graph_symmetry sym(g);
+
+			for (int k = MIN_FIXED_COLORS; k <= 5; ++k) {
+				for (const auto ordering : { Ordering::Natural, Ordering::Static }) {
+					search_options generic;
+					generic.alice_ordering_ = ordering;
+					generic.fixed_kernels_ = false;
+					search_options fixed = generic;
+					fixed.fixed_kernels_ = true;
+
+					// From the same empty table, as replacement depends on it
+					search_counters c1;
+					search_counters c2;
+					tt.clear();
+					const Victory win = solve_outcome(g, k, tt, &sym, &c1, generic);
+					tt.clear();
+					assert(solve_outcome(g, k, tt, &sym, &c2, fixed) == win);
+					assert(c1.nodes_ == c2.nodes_ && c1.orbit_prunes_ == c2.orbit_prunes_ && c1.twin_prunes_ == c2.twin_prunes_);
+
+					fixed.threads_ = 3;
+					assert(solve_outcome(g, k, tt, &sym, nullptr, fixed) == win);
+				}
+
+				// A legal game, won by the solved winner
+				const auto game = play_optimally(g, k, tt);
+				assert(game.first == solve_outcome(g, k, tt));
+
+				auto moves = game.second;
+				bitboard_coloring col(g, k);
+				while (!moves.empty()) {
+					assert(col.is_allowed(moves.front().vertex_, moves.front().color_));
+					col.color_vertex(moves.front().vertex_, moves.front().color_);
+					moves.pop();
+				}
+				assert(col.is_colored() == (game.first == Victory::Alice));
+			}
+		}
+	}
+
+	{
+		// And that of the wide engine
+		graph bipartite(80);
+		for (int u = 0; u < 40; ++u) {
+			for (int v = 40; v < 80; ++v) {
+				bipartite.add_edge(u, v);
+			}
+		}
+
+		const graph star = get_star(200);
+		transposition_table tt(4);
+
+		for (const auto& [g, k] : { std::pair<const graph*, int>{ &bipartite, 3 }, std::pair{ &star, 3 }, std::pair{ &star, 8 } }) {
+			search_options generic;
+			generic.fixed_kernels_ = false;
+
+			search_counters c1;
+			search_counters c2;
+			tt.clear();
+			const Victory win = solve_outcome(*g, k, tt, nullptr, &c1, generic);
+			tt.clear();
+			assert(solve_outcome(*g, k, tt, nullptr, &c2) == win);
+			assert(c1.nodes_ == c2.nodes_ && c1.twin_prunes_ == c2.twin_prunes_);
+		}
+	}
+
+	std::cout << "OK\n";
+}
+
+void test_safe_reductions() {
+	std::cout << "Testing safe-vertex reductions ... ";
+
+	{
+		// On the path 0 - 1 - 2 - 3 with 2 colors, only the inner vertices
+		// are unsafe; once 1 is colored, 0 has no uncolored neighbor and is
+		// a tempo vertex
+		graph g(4);
+		g.add_edge(0, 1);
+		g.add_edge(1, 2);
+		g.add_edge(2, 3);
+
+		bitboard_coloring col(g, 2);
+		assert(col.safe_vertices() == 0b1001);
+		assert(col.tempo_vertices(col.safe_vertices()) == 0);
+
+		col.color_vertex(1, 0);
+		assert(col.safe_vertices() == 0b1001 && col.tempo_vertices(0b1001) == 0b0001);
+
+		// 2 has one free color left for its one uncolored neighbor
+		col.color_vertex(3, 1);
+		assert(col.safe_vertices() == 0b0001);
+
+		col.uncolor_vertex(3, 1);
+		col.color_vertex(2, 1);
+		game_state node(col);
+		assert(node.is_safe_win());
+	}
+
+	{
+		// Same outcome and minimax value as the plain search, on every engine
+		std::mt19937_64 rng(11);
+		transposition_table tt(4);
+		pn_table table(1);
+
+		for (int trial = 0; trial < 60; ++trial) {
+			const int n = 6 + trial % 4;
+			graph g(n);
+			for (int u = 0; u < n; ++u) {
+				for (int v = u + 1; v < n; ++v) {
+					if (rng() % (trial % 2 == 0 ? 4 : 2) == 0) {
+						g.add_edge(u, v);
+					}
+				}
+			}
+
+			const graph_symmetry sym(g);
+
+			for (int k = 1; k <= 4; ++k) {
+				search_options plain;
+				plain.safe_reductions_ = false;
+				plain.fixed_kernels_ = false;
+
+				const Victory win = solve_outcome(g, k, tt, &sym, nullptr, plain);
+
+				for (const bool fixed : { false, true }) {
+					search_options reduced;
+					reduced.fixed_kernels_ = fixed;
+					assert(solve_outcome(g, k, tt, &sym, nullptr, reduced) == win);
+				}
+
+				assert(solve_outcome_dfpn(g, k, table, &sym) == win);
+
+				if (n <= 7) {
+					bitboard_coloring c1(g, k);
+					bitboard_coloring c2(g, k);
+					game_state full(c1, nullptr, &sym);
+					game_state reduced(c2, nullptr, &sym);
+					full.safe_reductions_ = false;
+
+					assert(minimax(full, true).second == minimax(reduced, true).second);
+				}
+			}
+		}
+	}
+
+	{
+		// Most of a sparse graph is decided by safe colorings
+		const graph g = get_cycle(14);
+		transposition_table tt;
+
+		search_options plain;
+		plain.safe_reductions_ = false;
+
+		search_counters c1;
+		search_counters c2;
+		assert(solve_outcome(g, 3, tt, nullptr, &c1, plain) == solve_outcome(g, 3, tt, nullptr, &c2));
+		assert(c2.safe_wins_ > 0 && c2.nodes_ * 4 < c1.nodes_);
+	}
+
+	std::cout << "OK\n";
+}
+
+void test_bob_threats() {
+	std::cout << "Testing Bob's threats ... ";
+
+	{
+		// Paths 0 - 1 - 2, 3 - 4 and 5 - 6 - 7 and an isolated 8, with 2 colors
+		graph g(9);
+		g.add_edge(0, 1);
+		g.add_edge(1, 2);
+		g.add_edge(3, 4);
+		g.add_edge(5, 6);
+		g.add_edge(6, 7);
+
+		bitboard_coloring col(g, 2);
+		col.color_vertex(0, 0);
+
+		// Bob colors 2 with 1, and 1 is dead
+		assert(col.has_bob_threat());
+
+		// 4 has one free color but no uncolored neighbor to lose it to, so
+		// only the threat on 1 is left: Alice colors 1 or 2
+		col.color_vertex(3, 0);
+		assert(col.threat_defusers() == 0b110);
+
+		// With a second threat, she cannot stop both
+		col.color_vertex(5, 0);
+		col.color_vertex(8, 0);
+		assert(col.threat_defusers() == 0);
+
+		game_state node(col);
+		for (const index_t u : { 0, 3, 5, 8 }) {
+			node.remove(u);
+		}
+
+		index_t defusers = ALL_ONES;
+		assert(node.is_threat_win(defusers) && node.counters_.threat_wins_ == 1);
+
+		node.bob_threats_ = false;
+		assert(!node.is_threat_win(defusers) && !alice_wins(node));
+	}
+
+	{
+		// Same outcome as without any reductions, on every engine
+		std::mt19937_64 rng(13);
+		transposition_table tt(4);
+		pn_table table(1);
+		search_counters counters;
+
+		for (int trial = 0; trial < 60; ++trial) {
+			const int n = 7 + trial % 4;
+			graph g(n);
+			for (int u = 0; u < n; ++u) {
+				for (int v = u + 1; v < n; ++v) {
+					if (rng() % (trial % 2 == 0 ? 4 : 2) == 0) {
+						g.add_edge(u, v);
+					}
+				}
+			}
+
+			const graph_symmetry sym(g);
+
+			for (int k = 2; k <= 4; ++k) {
+				search_options plain;
+				plain.safe_reductions_ = false;
+				plain.bob_threats_ = false;
+				plain.fixed_kernels_ = false;
+
+				const Victory win = solve_outcome(g, k, tt, &sym, nullptr, plain);
+
+				for (const bool fixed : { false, true }) {
+					search_options reduced;
+					reduced.fixed_kernels_ = fixed;
+					assert(solve_outcome(g, k, tt, &sym, &counters, reduced) == win);
+				}
+
+				assert(solve_outcome_dfpn(g, k, table, &sym) == win);
+			}
+		}
+
+		assert(counters.threat_wins_ > 0 && counters.threat_prunes_ > 0);
+	}
+
+	std::cout << "OK\n";
+}
+
+void test_endgame() {
+	std::cout << "Testing the endgame solver ... ";
+
+	{
+		std::uint64_t nodes = 0;
+
+		// Nothing left to color
+		assert(solve_endgame(endgame(), false, nodes) && nodes == 1);
+
+		// An edge whose ends may only take color 0: whoever moves kills the
+		// other end
+		endgame e;
+		e.size_ = 2;
+		e.adj_ = { 0b10, 0b01 };
+		e.free_ = { 0b1, 0b1 };
+		assert(!solve_endgame(e, true, nodes) && !solve_endgame(e, false, nodes));
+
+		// With a second color at one end, Alice colors the other one first
+		e.free_[1] = 0b11;
+		assert(solve_endgame(e, true, nodes) && !solve_endgame(e, false, nodes));
+
+		// The same from a coloring: a path 0-1-2-3 in two colors, with 0
+		// colored 0 and 3 colored 1
+		graph g(4);
+		g.add_edge(0, 1);
+		g.add_edge(1, 2);
+		g.add_edge(2, 3);
+
+		bitboard_coloring col(g, 2);
+		col.color_vertex(0, 0);
+		col.color_vertex(3, 1);
+
+		const endgame rest = col.get_endgame();
+		assert(rest.size_ == 2 && rest.adj_[0] == 0b10 && rest.free_[0] == 0b10 && rest.free_[1] == 0b01);
+		assert(solve_endgame(rest, true, nodes));
+	}
+
+	{
+		// Same outcome with any crossover, on every engine
+		std::mt19937_64 rng(17);
+		transposition_table tt(4);
+		pn_table table(1);
+		search_counters counters;
+
+		for (int trial = 0; trial < 60; ++trial) {
+			const int n = 7 + trial % 4;
+			graph g(n);
+			for (int u = 0; u < n; ++u) {
+				for (int v = u + 1; v < n; ++v) {
+					if (rng() % (trial % 2 == 0 ? 4 : 2) == 0) {
+						g.add_edge(u, v);
+					}
+				}
+			}
+
+			const graph_symmetry sym(g);
+
+			for (int k = 2; k <= 4; ++k) {
+				search_options plain;
+				plain.endgame_vertices_ = 0;
+				plain.fixed_kernels_ = false;
+
+				const Victory win = solve_outcome(g, k, tt, &sym, nullptr, plain);
+
+				for (const int vertices : { 2, 4, MAX_ENDGAME_VERTICES, n }) {
+					for (const bool fixed : { false, true }) {
+						search_options options;
+						options.endgame_vertices_ = vertices;
+						options.fixed_kernels_ = fixed;
+						assert(solve_outcome(g, k, tt, &sym, &counters, options) == win);
+					}
+				}
+
+				assert(solve_outcome_dfpn(g, k, table, &sym) == win);
+			}
+		}
+
+		assert(counters.endgame_solves_ > 0 && counters.endgame_nodes_ >= counters.endgame_solves_);
+	}
+
+	std::cout << "OK\n";
+}
+
+void test_tablebase() {
+	std::cout << "Testing tablebases ... ";
+
+	assert(tablebase_bytes(11, 4) == (48828125 + 7) / 8);
+	assert(tablebase_bytes(64, 3) == std::numeric_limits<std::size_t>::max());
+	assert(tablebase_bytes(5, MAX_TABLEBASE_COLORS + 1) == std::numeric_limits<std::size_t>::max());
+
+	{
+		// Same outcome as alpha-beta, with any number of threads
+		std::mt19937_64 rng(18);
+		transposition_table tt(4);
+
+		for (int trial = 0; trial < 40; ++trial) {
+			const int n = 4 + trial % 5;
+			graph g(n);
+			for (int u = 0; u < n; ++u) {
+				for (int v = u + 1; v < n; ++v) {
+					if (rng() % (trial % 2 == 0 ? 3 : 2) == 0) {
+						g.add_edge(u, v);
+					}
+				}
+			}
+
+			for (int k = 1; k <= 4; ++k) {
+				search_options plain;
+				plain.tablebase_megabytes_ = 0;
+				const Victory win = solve_outcome(g, k, tt, nullptr, nullptr, plain);
+
+				for (const int threads : { 1, 3 }) {
+					search_options options;
+					options.threads_ = threads;
+
+					search_counters counters;
+					assert(solve_outcome_tablebase(g, k, &counters, options) == win);
+					assert(counters.tablebase_solves_ == 1 && counters.tablebase_states_ > 0);
+				}
+			}
+		}
+	}
+
+	{
+		// Alpha-beta gives up at its node limit, and solve_outcome() then
+		// hands over to the tablebase
+		const graph g = get_wheel(8);
+		transposition_table tt;
+
+		for (const bool fixed : { false, true }) {
+			search_options limited;
+			limited.fixed_kernels_ = fixed;
+			limited.node_limit_ = 1;
+
+			tt.clear();
+			assert(!try_solve_outcome(g, 3, tt, nullptr, nullptr, limited).has_value());
+
+			limited.node_limit_ = 0;
+			assert(try_solve_outcome(g, 3, tt, nullptr, nullptr, limited) == solve_outcome(g, 3));
+		}
+
+		search_options options;
+		options.engine_ = Engine::Tablebase;
+
+		search_counters counters;
+		assert(solve_outcome(g, 3, tt, nullptr, &counters, options) == solve_outcome(g, 3));
+		assert(counters.tablebase_solves_ == 1 && counters.nodes_ == 0);
+
+		// Without room for the table, the engine falls back to alpha-beta
+		options.tablebase_megabytes_ = 0;
+		counters = search_counters();
+		solve_outcome(g, 3, tt, nullptr, &counters, options);
+		assert(counters.tablebase_solves_ == 0 && counters.nodes_ > 0);
+	}
+
+	{
+		// Nothing to color, so Alice has already won
+		const graph g(0);
+		transposition_table tt;
+
+		search_options options;
+		options.engine_ = Engine::Tablebase;
+
+		for (int k = 1; k <= 3; ++k) {
+			search_counters counters;
+			assert(solve_outcome(g, k, tt, nullptr, &counters, options) == Victory::Alice);
+			assert(counters.tablebase_solves_ == 1);
+		}
+	}
+
+	std::cout << "OK\n";
+}
+
+void test_bounds() {
+	std::cout << "Testing bounds ... ";
+
+	// Outerplanar if some order of the vertices on a circle has no two
+	// crossing edges
+	const auto on_circle = [](const graph& g) {
+		const int n = static_cast<int>(g.num_vertices());
+		std::vector<int> order(n);
+		std::iota(order.begin(), order.end(), 0);
+
+		do {
+			std::vector<int> pos(n);
+			for (int i = 0; i < n; ++i) {
+				pos[order[i]] = i;
+			}
+
+			bool crossing = false;
+			for (int a = 0; a < n && !crossing; ++a) {
+				for (int b = a + 1; b < n && !crossing; ++b) {
+					if (!g.has_edge(a, b)) {
+						continue;
+					}
+
+					const int lo = std::min(pos[a], pos[b]);
+					const int hi = std::max(pos[a], pos[b]);
+
+					const auto inside = [&](int c) { return lo < pos[c] && pos[c] < hi; };
+					const auto outside = [&](int c) { return pos[c] < lo || pos[c] > hi; };
+
+					for (int c = 0; c < n && !crossing; ++c) {
+						for (int d = c + 1; d < n && !crossing; ++d) {
+							crossing = g.has_edge(c, d) && ((inside(c) && outside(d)) || (outside(c) && inside(d)));
+						}
+					}
+				}
+			}
+
+			if (!crossing) {
+				return true;
+			}
+		} while (std::next_permutation(order.begin() + 1, order.end()));
+
+		return false;
+	};
+
+	{
+		std::mt19937_64 rng(19);
+
+		for (int trial = 0; trial < 300; ++trial) {
+			const int n = 1 + trial % 7;
+			const int density = 2 + trial % 4;
+			graph g(n);
+
+			for (int u = 0; u < n; ++u) {
+				for (int v = u + 1; v < n; ++v) {
+					if (rng() % density == 0) {
+						g.add_edge(u, v);
+					}
+				}
+			}
+
+			assert(is_outerplanar(g) == on_circle(g));
+		}
+
+		graph k23(5);
+		for (int u = 0; u < 2; ++u) {
+			for (int v = 2; v < 5; ++v) {
+				k23.add_edge(u, v);
+			}
+		}
+
+		assert(!is_outerplanar(k23) && !is_outerplanar(get_complete_graph(4)) && !is_outerplanar(get_wheel(6)));
+		assert(is_outerplanar(get_cycle(30)) && is_outerplanar(get_star(100)) && is_outerplanar(get_cycle(100)));
+
+		assert(is_forest(get_star(9)) && !is_forest(get_cycle(9)));
+		assert(is_cycle(get_cycle(9)) && !is_cycle(get_star(9)) && !is_cycle(get_wheel(9)));
+		assert(is_bipartite(get_cycle(8)) && !is_bipartite(get_cycle(9)) && is_bipartite(get_star(9)));
+	}
+
+	const solver_factory make_solver = get_test_solver();
+
+	{
+		// The bounds hold the number found by trying every k from 1
+		std::mt19937_64 rng(20);
+		std::vector<graph> graphs;
+
+		for (int trial = 0; trial < 60; ++trial) {
+			const int n = 4 + trial % 6;
+			graph g(n);
+
+			for (int u = 0; u < n; ++u) {
+				for (int v = u + 1; v < n; ++v) {
+					if (rng() % (2 + trial % 3) == 0) {
+						g.add_edge(u, v);
+					}
+				}
+			}
+
+			graphs.push_back(std::move(g));
+		}
+
+		// A tree and an outerplanar fan of high degree
+		graph tree(10);
+		graph fan(11);
+		for (int u = 1; u < 10; ++u) {
+			tree.add_edge(u < 6 ? 0 : u - 4, u);
+			fan.add_edge(0, u);
+			fan.add_edge(u, u + 1);
+		}
+		fan.add_edge(0, 10);
+
+		assert(get_game_bounds(tree).upper_ == 4 && get_game_bounds(fan).upper_ == 7);
+		graphs.push_back(std::move(tree));
+		graphs.push_back(std::move(fan));
+
+		for (const auto& g : graphs) {
+			transposition_table tt(1);
+			int k = 1;
+			while (solve_outcome(g, k, tt) != Victory::Alice) {
+				++k;
+			}
+
+			const game_bounds b = get_game_bounds(g);
+			assert(b.lower_ <= k && k <= b.upper_);
+
+			search_counters counters;
+			std::vector<solve_record> solves;
+			assert(game_chromatic_number(g, make_solver(), counters, solves) == k);
+			assert(static_cast<int>(solves.size()) == std::min(k, b.upper_ - 1) - b.lower_ + 1);
+		}
+	}
+
+	{
+		// No search where the bounds meet
+		search_counters counters;
+		std::vector<solve_record> solves(1);
+
+		for (int n = 4; n < 10; ++n) {
+			assert(game_chromatic_number(get_cycle(n), make_solver(), counters, solves) == 3 && solves.empty());
+		}
+
+		assert(game_chromatic_number(get_complete_graph(3), make_solver(), counters, solves) == 3 && solves.empty());
+		assert(game_chromatic_number(get_complete_graph(6), make_solver(), counters, solves) == 6 && solves.empty());
+		assert(counters.nodes_ == 0);
+	}
+
+	std::cout << "OK\n";
+}
+
+void test_search_stats() {
+	std::cout << "Testing search statistics ... ";
+
+	const graph g = read_graph6("H?AADrq");
+
+	if constexpr (SEARCH_STATS) {
+		// Every engine counts each node at its ply
+		for (int engine = 0; engine < 4; ++engine) {
+			transposition_table tt(1);
+			pn_table pn(1);
+			search_counters c;
+			search_options options;
+			options.fixed_kernels_ = engine == 1;
+			options.tablebase_megabytes_ = 0;
+
+			if (engine == 2) {
+				options.engine_ = Engine::ProofNumber;
+				solve_outcome_dfpn(g, 3, pn, nullptr, &c, options);
+			}
+			else if (engine == 3) {
+				bitboard_coloring col(g, 3);
+				game_state root(col, &tt);
+				const auto score = minimax(root, true);
+				assert(score.second > 0);
+				c = root.counters_;
+			}
+			else {
+				solve_outcome(g, 3, tt, nullptr, &c, options);
+			}
+
+			std::uint64_t nodes = 0;
+			for (const std::uint64_t n : c.ply_nodes_) {
+				nodes += n;
+			}
+
+			assert(c.nodes_ > 1 && nodes == c.nodes_);
+			assert(c.ply_nodes_[0] >= 1 && c.ply_nodes_[c.max_ply_] > 0 && c.max_ply_ <= 9);
+			assert(c.tt_hits_ <= c.tt_probes_ && c.cutoffs_ < c.nodes_);
+		}
+
+		// Sums add up and keep the deepest ply
+		search_counters a;
+		search_counters b;
+		a.record_node(2);
+		a.record_probe(true);
+		b.record_node(70);
+		b.record_probe(false);
+		b.record_cutoff();
+		b.record_terminal();
+		a += b;
+
+		assert(a.ply_nodes_[2] == 1 && a.ply_nodes_[MAX_STATS_PLIES - 1] == 1 && a.max_ply_ == 70);
+		assert(a.tt_probes_ == 2 && a.tt_hits_ == 1 && a.cutoffs_ == 1 && a.terminals_ == 1);
+	}
+
+	{
+		std::vector<solve_record> solves(2);
+		solves[0].num_cols_ = 2;
+		solves[0].seconds_ = 0.5;
+		solves[0].counters_.nodes_ = 3;
+		solves[0].counters_.max_ply_ = 1;
+		solves[0].counters_.ply_nodes_[0] = 1;
+		solves[0].counters_.ply_nodes_[1] = 2;
+		solves[1].num_cols_ = 3;
+		solves[1].outcome_ = Victory::Alice;
+		solves[1].counters_.nodes_ = 1;
+		solves[1].counters_.ply_nodes_[0] = 1;
+		solves[1].counters_.tt_probes_ = 4;
+
+		assert(format_solves(solves, StatsFormat::None).empty());
+		assert(format_solves({}, StatsFormat::Csv) == "-" && format_solves({}, StatsFormat::Json) == "[]");
+		assert(format_solves(solves, StatsFormat::Csv) == "2,bob,0.5,3,0,0,0,0,1,1/2;3,alice,0,1,0,4,0,0,0,1");
+		assert(format_solves(solves, StatsFormat::Json) ==
+			"[{\"k\":2,\"winner\":\"bob\",\"seconds\":0.5,\"nodes\":3,\"cutoffs\":0,\"tt_probes\":0,"
+			"\"tt_hits\":0,\"terminals\":0,\"max_ply\":1,\"ply_nodes\":[1,2]},"
+			"{\"k\":3,\"winner\":\"alice\",\"seconds\":0,\"nodes\":1,\"cutoffs\":0,\"tt_probes\":4,"
+			"\"tt_hits\":0,\"terminals\":0,\"max_ply\":0,\"ply_nodes\":[1]}]");
+
+		StatsFormat format = StatsFormat::None;
+		assert(parse_stats_format("json", format) && format == StatsFormat::Json);
+		assert(!parse_stats_format("xml", format));
+	}
+
+	{
+		// The batch driver writes the statistics after each result, where
+		// result files still read it
+		batch_options options;
+		options.verbose_ = false;
+		options.stats_ = StatsFormat::Csv;
+
+		std::istringstream in("H?AADrq\nFhCKG\n");
+		std::ostringstream out;
+		const batch_report report = run_g6_batch(in, out, get_test_solver(), options);
+
+		std::istringstream lines(out.str());
+		for (std::string line; std::getline(lines, line); ) {
+			std::string_view graph6;
+			int k = 0;
+			assert(parse_result_line(line, graph6, k));
+			assert(std::count(line.begin(), line.end(), ' ') == 3);
+
+			const std::string fields = line.substr(line.find(' ', line.find(' ') + 1) + 1);
+			const std::size_t solves = std::stoul(fields);
+			const std::string csv = fields.substr(fields.find(' ') + 1);
+			assert(solves == 0 ? csv == "-" : std::count(csv.begin(), csv.end(), ';') + 1 == static_cast<long>(solves));
+		}
+
+		assert(report.graphs_ == 2 && report.solves_ > 0);
+	}
+
+	std::cout << "OK\n";
+}
+
+void test_bench_suite() {
+	std::cout << "Testing benchmark suite ... ";
+
+	// Every answer of the corpus lies within the bounds of its graph
+	for (const auto& c : get_corpus()) {
+		const graph g = read_graph6(c.graph6_);
+		const game_bounds b = get_game_bounds(g);
+		assert(b.lower_ <= c.k_ && c.k_ <= b.upper_);
+	}
+
+	{
+		suite_results results;
+		results["fixed/cycles"] = { 1.5, 2.25, 1e6, 400 };
+		results["dfpn/wheels"] = { 10, 12, 2.5e5, 80 };
+
+		std::stringstream json;
+		write_suite_results(results, json);
+
+		suite_results read;
+		assert(read_suite_results(json, read) && read.size() == 2);
+		assert(read["fixed/cycles"].median_ms_ == 1.5 && read["fixed/cycles"].p95_ms_ == 2.25);
+		assert(read["dfpn/wheels"].nodes_per_sec_ == 2.5e5 && read["dfpn/wheels"].solves_per_sec_ == 80);
+
+		for (const std::string bad : { "", "{", "{\"a\": 1}", "{\"a\": {\"median_ms\": x}}", "{} {}" }) {
+			std::istringstream in(bad);
+			assert(!read_suite_results(in, read));
+		}
+
+		std::istringstream empty("{}");
+		assert(read_suite_results(empty, read) && read.empty());
+	}
+
+	{
+		// Slowdowns count beyond the threshold and the noise floor, and only
+		// for keys in both
+		suite_results baseline;
+		baseline["a"] = { 10, 10, 0, 0 };
+		baseline["b"] = { 10, 10, 0, 0 };
+		baseline["c"] = { 0.5, 0.5, 0, 0 };
+
+		suite_results results;
+		results["a"] = { 11, 11, 0, 0 };
+		results["b"] = { 12, 12, 0, 0 };
+		results["c"] = { 1.2, 1.2, 0, 0 };
+		results["d"] = { 100, 100, 0, 0 };
+
+		assert(find_regressions(baseline, results, 0.15) == std::vector<std::string>{ "b" });
+		assert(find_regressions(baseline, results, 0.25).empty());
+	}
+
+	{
+		// A short run against its own results passes, and fails with a
+		// baseline it cannot read or a configuration it does not know
+		const auto path = std::filesystem::temp_directory_path() / "vcg_test_bench_suite.json";
+
+		suite_options options;
+		options.trials_ = 1;
+		options.configs_ = { "tablebase" };
+		options.save_ = path.string();
+
+		std::ostringstream out;
+		assert(run_bench_suite(options, out));
+		assert(out.str().find("tablebase/cycles") != std::string::npos);
+
+		options.baseline_ = path.string();
+		options.save_.clear();
+		options.threshold_ = 1000;
+		assert(run_bench_suite(options, out));
+
+		options.baseline_ = path.string() + ".missing";
+		assert(!run_bench_suite(options, out));
+
+		options.baseline_.clear();
+		options.configs_ = { "minimax" };
+		assert(!run_bench_suite(options, out));
+
+		std::filesystem::remove(path);
+	}
+
+	std::cout << "OK\n";
+}
+
+void test_perf_counters() {
+	std::cout << "Testing hardware counters ... ";
+
+	perf_counters perf;
+	assert(perf.available() == (perf.has(PerfEvent::Cycles) || perf.has(PerfEvent::Instructions) ||
+		perf.has(PerfEvent::BranchMisses) || perf.has(PerfEvent::CacheMisses)));
+	assert(perf.available() || !perf.error().empty());
+
+	// Without counters every count is missing; with them, only those of
+	// the events that could not be opened
+	perf.start();
+	volatile std::uint64_t sum = 0;
+	for (std::uint64_t i = 0; i < 100000; ++i) {
+		sum = sum + i;
+	}
+	const perf_sample sample = perf.stop();
+
+	for (const PerfEvent e : { PerfEvent::Cycles, PerfEvent::Instructions, PerfEvent::BranchMisses, PerfEvent::CacheMisses }) {
+		assert(sample.has(e) == perf.has(e) || (!sample.has(e) && perf.available()));
+		assert(std::string(perf_counters::name(e)).size() > 0);
+	}
+
+	if (sample.has(PerfEvent::Instructions)) {
+		assert(sample.get(PerfEvent::Instructions) >= 100000);
+	}
+
+	std::cout << "OK\n";
+}
+
+void test_progress() {
+	std::cout << "Testing batch progress ... ";
+
+	assert(format_duration(12.4) == "12s" && format_duration(245) == "4m05s");
+	assert(format_duration(3 * 3600 + 12 * 60) == "3h12m" && format_duration(86400 + 2 * 3600) == "1d02h");
+
+	{
+		std::ostringstream os;
+		batch_progress progress(2, os, 0, false);
+
+		search_counters c;
+		c.nodes_ = 5;
+
+		progress.begin_graph(1, "H?AADrq");
+		progress.begin_solve(1, 3, c);
+		progress.end_solve(1, c);
+		assert(c.live_nodes_ == nullptr);
+
+		// A game in flight shows its nodes up to the last interval
+		search_counters live;
+		progress.begin_solve(1, 4, live);
+		for (std::uint64_t i = 0; i < LIVE_NODES_INTERVAL + 1; ++i) {
+			live.count_node();
+		}
+
+		auto graphs = progress.in_flight();
+		assert(graphs.size() == 1 && graphs[0].worker_ == 1 && graphs[0].line_ == "H?AADrq");
+		assert(graphs[0].num_cols_ == 4 && graphs[0].nodes_ == 5 + LIVE_NODES_INTERVAL);
+
+		progress.read(10, 3, 1, 0.5);
+		progress.print_line(os);
+		assert(os.str().find("14.3% done") != std::string::npos && os.str().find("ETA") != std::string::npos);
+		assert(os.str().find("longest in flight H?AADrq at k=4") != std::string::npos);
+
+		worker_report w;
+		w.graphs_ = 1;
+		w.solves_ = 2;
+		progress.end_graph(1, w, c);
+
+		assert(progress.in_flight().empty());
+		const batch_report report = progress.snapshot();
+		assert(report.graphs_ == 1 && report.solves_ == 2 && report.counters_.nodes_ == 5);
+		assert(report.skipped_ == 3 && report.malformed_ == 1 && report.workers_.size() == 2);
+
+		std::ostringstream dump;
+		progress.dump(dump);
+		assert(dump.str().find("Progress dump, 10 graphs queued") == 0 && dump.str().find("0 graphs in flight") != std::string::npos);
+	}
+
+	{
+		// The engines and their threads add to the count of a game while
+		// they search it
+		const graph g = read_graph6("M_`oOi?SZ?G]jdLF?");
+
+		for (const int threads : { 1, 2 }) {
+			transposition_table tt(1);
+			std::atomic<std::uint64_t> live{ 0 };
+			search_counters c;
+			c.live_nodes_ = &live;
+
+			search_options options;
+			options.threads_ = threads;
+			solve_outcome(g, 4, tt, nullptr, &c, options);
+
+			assert(c.nodes_ >= LIVE_NODES_INTERVAL && live > 0 && live <= c.nodes_);
+			assert(live % LIVE_NODES_INTERVAL == 0);
+		}
+	}
+
+#ifdef SIGUSR1
+	{
+		// The reporter dumps on SIGUSR1 while a worker is busy
+		std::ostringstream os;
+		{
+			batch_progress progress(1, os, 0, true);
+			progress.begin_graph(0, "FhCKG");
+			std::raise(SIGUSR1);
+			std::this_thread::sleep_for(std::chrono::milliseconds(500));
+		}
+
+		assert(os.str().find("Progress dump") == 0 && os.str().find("Worker 0: FhCKG at k=0") != std::string::npos);
+	}
+#endif
+
+	std::cout << "OK\n";
+}
+
+namespace {
+	// The nodes of the tree estimate_tree_size() samples
+	std::uint64_t count_tree(game_state& node) {
+		bitboard_coloring& col = node.col_;
+
+		if (col.is_colored() || col.is_deadend() || col.has_conflict() || node.is_safe_win()) {
+			return 1;
+		}
+
+		index_t defusers = ALL_ONES;
+
+		if (node.is_threat_win(defusers) || node.is_endgame()) {
+			return 1;
+		}
+
+		std::uint64_t nodes = 1;
+		const std::vector<move> moves = node.generate_moves(move(), defusers);
+
+		for (const move m : moves) {
+			col.color_vertex(m.vertex_, m.color_);
+			node.remove(m.vertex_);
+			nodes += count_tree(node);
+			col.uncolor_vertex(m.vertex_, m.color_);
+			node.add(m.vertex_);
+		}
+
+		return nodes;
+	}
+}
+
+void test_estimate() {
+	std::cout << "Testing tree size estimates ... ";
+
+	assert(degeneracy(get_cycle(7)) == 2 && degeneracy(get_star(6)) == 1);
+	assert(degeneracy(get_complete_graph(6)) == 5 && degeneracy(get_wheel(8)) == 3);
+	assert(degeneracy(read_graph6("Z???O__O?G??????cCA?_A_?P???ECGOA?G@?hI?oGW_bQS_PPjW@{D~}?Jw")) >= 3);
+
+	{
+		// The estimate is unbiased, so many probes come close to the tree
+		for (const auto& [s, num_cols] : { std::pair{ "H?AADrq", 3 }, std::pair{ "GQz~vk", 5 }, std::pair{ "G?AFCs", 4 } }) {
+			const graph g = read_graph6(s);
+			const graph_symmetry sym(g);
+
+			bitboard_coloring col(g, num_cols);
+			game_state root(col, nullptr, &sym);
+			const double exact = static_cast<double>(count_tree(root));
+
+			std::mt19937_64 rng(25);
+			const double estimate = estimate_tree_size(g, num_cols, &sym, 20000, rng);
+			assert(std::abs(estimate - exact) < 0.1 * exact);
+		}
+
+		std::mt19937_64 rng(25);
+		assert(estimate_tree_size(get_cycle(70), 3, nullptr, 4, rng) == UNKNOWN_ESTIMATE);
+	}
+
+	{
+		// Graphs settled by their bounds are predicted to need no search
+		std::mt19937_64 rng(25);
+		const graph_features k5 = get_graph_features(get_complete_graph(5), DEFAULT_ESTIMATE_PROBES, rng);
+		assert(k5.lower_ == 5 && k5.upper_ == 5 && k5.tree_size_ == 0 && predict_solve_nodes(k5) == 0);
+
+		const graph_features f = get_graph_features(read_graph6("H?AADrq"), DEFAULT_ESTIMATE_PROBES, rng);
+		assert(f.vertices_ == 9 && f.edges_ == 11 && f.lower_ < f.upper_ && f.tree_size_ > 1);
+
+		graph_features bigger = f;
+		bigger.tree_size_ *= 100;
+		assert(predict_solve_nodes(f) > 0 && predict_solve_nodes(bigger) > predict_solve_nodes(f));
+	}
+
+	{
+		// Scheduled runs solve every graph once, heaviest predicted first,
+		// and log the prediction of each
+		const solver_factory make_solver = get_test_solver();
+
+		const std::string input = "FhCKG\nH?AADrq\nEQzO\nGQz~vk\nG?AFCs\nD~{\n";
+
+		batch_options options;
+		options.verbose_ = false;
+
+		std::istringstream in(input);
+		std::ostringstream expected;
+		run_g6_batch(in, expected, make_solver, options);
+
+		options.schedule_window_ = 64;
+		options.completion_order_ = true;
+		std::ostringstream log;
+		options.estimate_log_ = &log;
+
+		std::istringstream in2(input);
+		std::ostringstream out;
+		const batch_report report = run_g6_batch(in2, out, make_solver, options);
+		assert(report.graphs_ == 6);
+
+		const auto lines = [](const std::string& text) {
+			std::vector<std::string> result;
+			std::istringstream iss(text);
+			for (std::string line; std::getline(iss, line); ) {
+				result.push_back(line);
+			}
+			return result;
+		};
+
+		auto sorted = lines(out.str());
+		auto sorted_expected = lines(expected.str());
+		std::sort(sorted.begin(), sorted.end());
+		std::sort(sorted_expected.begin(), sorted_expected.end());
+		assert(sorted == sorted_expected);
+
+		std::vector<std::string> logged;
+		for (const auto& line : lines(log.str())) {
+			std::istringstream fields(line);
+			std::string graph6;
+			int vertices = 0, edges = 0, degeneracy = 0, lower = 0, upper = 0;
+			double tree_size = 0, prediction = 0;
+			std::uint64_t actual = 0;
+			fields >> graph6 >> vertices >> edges >> degeneracy >> lower >> upper >> tree_size >> prediction >> actual;
+
+			assert(fields && read_graph6(graph6).num_vertices() == static_cast<index_t>(vertices));
+			assert(lower < upper ? prediction > 0 && actual > 0 : prediction == 0 && actual == 0);
+			logged.push_back(graph6);
+		}
+
+		std::sort(logged.begin(), logged.end());
+		assert(logged == std::vector<std::string>({ "D~{", "EQzO", "FhCKG", "G?AFCs", "GQz~vk", "H?AADrq" }));
+	}
+
 	std::cout << "OK\n";
 }
\ No newline at end of file
@@ -13,4 +13,52 @@ void test_deadend();
 
 void test_minimax();
 
+void test_transposition_table();
+
+void test_solve_outcome();
+
+void test_bitboard_coloring();
+
+void test_color_symmetry();
+
+void test_graph_symmetry();
+
+void test_move_ordering();
+
+void test_dfpn();
+
+void test_parallel_search();
+
+void test_batch();
+
+void test_result_store();
+
+void test_mapped_file();
+
+void test_graph6();
+
+void test_wide_graphs();
+
+void test_fixed_kernels();
+
+void test_safe_reductions();
+
+void test_bob_threats();
+
+void test_endgame();
+
+void test_tablebase();
+
+void test_bounds();
+
+void test_search_stats();
+
+void test_bench_suite();
+
+void test_perf_counters();
+
+void test_progress();
+
+void test_estimate();
+
 #endif
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "transposition_table.hpp"
+
+#include "zobrist.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+transposition_table::transposition_table(std::size_t megabytes) {
+	const std::size_t bytes = std::max<std::size_t>(megabytes, 1) << 20;
+
+	num_buckets_ = std::bit_floor(bytes / sizeof(tt_bucket));
+	buckets_ = std::make_unique<tt_bucket[]>(num_buckets_);
+	mask_ = num_buckets_ - 1;
+	new_search();
+}
+
+void transposition_table::new_search() {
+	index_t state = ++searches_;
+	salt_ = splitmix64(state);
+	++age_;
+}
+
+void transposition_table::clear() {
+	for (std::size_t i = 0; i < num_buckets_; ++i) {
+		for (auto& slot : buckets_[i].slots_) {
+			slot.check_.store(0, std::memory_order_relaxed);
+			slot.data_.store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+bool transposition_table::probe(index_t key, tt_entry& e) const {
+	key ^= salt_;
+
+	for (const auto& slot : bucket(key).slots_) {
+		const std::uint64_t data = slot.data_.load(std::memory_order_relaxed);
+		const index_t check = slot.check_.load(std::memory_order_relaxed);
+
+		if ((check ^ data) == key) {
+			e = unpack(key, data);
+
+			if (e.bound_ != Bound::None) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void transposition_table::store(index_t key, int value, Bound bound, int depth, move best) {
+	assert(bound != Bound::None);
+	assert(depth >= 0 && depth < 256);
+	key ^= salt_;
+
+	// Replace the same position if present, then an empty slot, then an
+	// entry of an earlier search, and finally the shallowest entry. Under
+	// concurrent stores the choice may be based on a stale view, which
+	// only costs an entry.
+	auto& slots = bucket(key).slots_;
+	tt_slot* victim = nullptr;
+	int victim_score = std::numeric_limits<int>::max();
+
+	for (auto& slot : slots) {
+		const std::uint64_t data = slot.data_.load(std::memory_order_relaxed);
+		const index_t check = slot.check_.load(std::memory_order_relaxed);
+		const tt_entry entry = unpack(check ^ data, data);
+
+		if (entry.bound_ != Bound::None && entry.key_ == key) {
+			victim = &slot;
+			break;
+		}
+
+		const int score = entry.bound_ == Bound::None ? -512 :
+			entry.depth_ - (entry.age_ != age_ ? 256 : 0);
+
+		if (score < victim_score) {
+			victim_score = score;
+			victim = &slot;
+		}
+	}
+
+	tt_entry e;
+	e.value_ = static_cast<std::int16_t>(value);
+	e.depth_ = static_cast<std::uint8_t>(depth);
+	e.age_ = age_;
+	e.bound_ = bound;
+	e.vertex_ = static_cast<std::int8_t>(best.vertex_);
+	e.color_ = static_cast<std::int8_t>(best.color_);
+
+	const std::uint64_t data = pack(e);
+	victim->check_.store(key ^ data, std::memory_order_relaxed);
+	victim->data_.store(data, std::memory_order_relaxed);
+}
+
+std::size_t transposition_table::num_entries() const {
+	return num_buckets_ * TT_BUCKET_SIZE;
+}
+
+std::uint64_t transposition_table::pack(const tt_entry& e) {
+	return static_cast<std::uint16_t>(e.value_) |
+		static_cast<std::uint64_t>(e.depth_) << 16 |
+		static_cast<std::uint64_t>(e.age_) << 24 |
+		static_cast<std::uint64_t>(e.bound_) << 32 |
+		static_cast<std::uint64_t>(static_cast<std::uint8_t>(e.vertex_)) << 40 |
+		static_cast<std::uint64_t>(static_cast<std::uint8_t>(e.color_)) << 48;
+}
+
+tt_entry transposition_table::unpack(index_t key, std::uint64_t data) {
+	tt_entry e;
+	e.key_ = key;
+	e.value_ = static_cast<std::int16_t>(data & 0xFFFF);
+	e.depth_ = static_cast<std::uint8_t>(data >> 16);
+	e.age_ = static_cast<std::uint8_t>(data >> 24);
+	e.bound_ = static_cast<Bound>(static_cast<std::uint8_t>(data >> 32));
+	e.vertex_ = static_cast<std::int8_t>(data >> 40);
+	e.color_ = static_cast<std::int8_t>(data >> 48);
+	return e;
+}
+
+tt_bucket& transposition_table::bucket(index_t key) {
+	return buckets_[key & mask_];
+}
+
+const tt_bucket& transposition_table::bucket(index_t key) const {
+	return buckets_[key & mask_];
+}
\ No newline at end of file
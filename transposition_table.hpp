@@ -0,0 +1,84 @@
+#ifndef TRANSPOSITION_TABLE_HPP
+#define TRANSPOSITION_TABLE_HPP
+
+#include "common.hpp"
+#include "move.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+static constexpr std::size_t DEFAULT_TT_MEGABYTES = 16;
+
+enum class Bound : std::uint8_t {
+	None = 0,
+	Exact = 1,
+	Lower = 2,
+	Upper = 3
+};
+
+// 16 bytes; scores fit in 16 bits as they are bounded by the graph order
+struct tt_entry {
+	index_t key_{ 0 };
+	std::int16_t value_{ 0 };
+	std::uint8_t depth_{ 0 };
+	std::uint8_t age_{ 0 };
+	Bound bound_{ Bound::None };
+	std::int8_t vertex_{ -1 };
+	std::int8_t color_{ -1 };
+};
+
+// An entry as stored: everything but the key packed into one word, and the
+// key XOR that word in the other (Hyatt and Mann's lockless hashing). Both
+// words are written and read separately without locks; if two threads 
+// write the same slot at once, the words of a torn slot do not match and 
+// the slot is simply a miss.
+struct tt_slot {
+	std::atomic<index_t> check_{ 0 };
+	std::atomic<std::uint64_t> data_{ 0 };
+};
+
+static constexpr std::size_t TT_BUCKET_SIZE = 4;
+
+// One bucket fills a cache line, so a probe touches a single line
+struct alignas(64) tt_bucket {
+	std::array<tt_slot, TT_BUCKET_SIZE> slots_;
+};
+
+// A fixed-size, bucketed transposition table. Each search gets its own salt
+// that is mixed into the keys, so entries from earlier searches (possibly of
+// different graphs) never verify and are the first to be replaced.
+//
+// probe() and store() may be called from several threads at once, e.g., by
+// the helpers of a parallel search. new_search() and clear() may not.
+class transposition_table {
+  public:
+	explicit transposition_table(std::size_t megabytes = DEFAULT_TT_MEGABYTES);
+	transposition_table(const transposition_table&) = delete;
+	transposition_table& operator=(const transposition_table&) = delete;
+
+	void new_search();
+	void clear();
+
+	bool probe(index_t key, tt_entry& e) const;
+	void store(index_t key, int value, Bound bound, int depth, move best);
+
+	std::size_t num_entries() const;
+
+  private:
+	static std::uint64_t pack(const tt_entry& e);
+	static tt_entry unpack(index_t key, std::uint64_t data);
+
+	tt_bucket& bucket(index_t key);
+	const tt_bucket& bucket(index_t key) const;
+
+	std::unique_ptr<tt_bucket[]> buckets_;
+	std::size_t num_buckets_{ 0 };
+	index_t mask_{ 0 };
+	index_t salt_{ 0 };
+	index_t searches_{ 0 };
+	std::uint8_t age_{ 0 };
+};
+
+#endif
\ No newline at end of file
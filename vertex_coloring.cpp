@@ -1,5 +1,7 @@
 #include "vertex_coloring.hpp"
 
+#include "zobrist.hpp"
+
 #include <cassert>
 
 void vertex_coloring::color_vertex(index_t u, index_t c) {
@@ -10,6 +12,7 @@ void vertex_coloring::color_vertex(index_t u, index_t c) {
 
 	col_[u] = c;
 	++colored_vertices_;
+	hash_ ^= zobrist_key(u, c);
 	attack_neighbors(g_.get_neighbors(u), c);
 
 	assert(is_colored(u, c));
@@ -24,6 +27,7 @@ void vertex_coloring::uncolor_vertex(index_t u, index_t c) {
 
 	col_[u] = unassigned_;
 	--colored_vertices_;
+	hash_ ^= zobrist_key(u, c);
 	free_neighbors(g_.get_neighbors(u), c);
 
 	assert(!is_colored(u, c));
@@ -116,15 +120,7 @@ bool vertex_coloring::equal(const vertex_coloring other) const {
 }
 
 std::size_t vertex_coloring::zobrist_hash() const {
-	std::size_t h = 0;
-
-	for (auto i = 0; i < col_.size(); ++i) {
-		if (col_[i] != unassigned_) {
-			h ^= zobrist_[i][col_[i]];
-		}
-	}
-
-	return h;
+	return hash_;
 }
 
 void vertex_coloring::print() const {
@@ -177,7 +173,7 @@ void vertex_coloring::attack_neighbors(index_t adj, index_t c) {
 #elif defined(__GNUC__)
 	while (adj != 0) {
 		const auto j = __builtin_ctzll(adj);
-		const auto lb = tmp & -tmp;
+		const auto lb = adj & (0 - adj);
 		adj ^= lb;
 
 		++attack_[j][c];
@@ -195,7 +191,7 @@ void vertex_coloring::free_neighbors(index_t adj, index_t c) {
 #elif defined(__GNUC__)
 	while (adj != 0) {
 		const auto j = __builtin_ctzll(adj);
-		const auto lb = tmp & -tmp;
+		const auto lb = adj & (0 - adj);
 		adj ^= lb;
 
 		--attack_[j][c];
@@ -7,7 +7,6 @@
 #include <algorithm>
 #include <cassert>
 #include <bitset>
-#include <random>
 
 class vertex_coloring {
   public:
@@ -15,22 +14,9 @@ class vertex_coloring {
         : g_(g), 
         num_cols_(num_cols), 
         col_(g.num_vertices(), unassigned_), 
-        attack_(g.num_vertices(), std::vector<index_t>(num_cols)),
-        zobrist_(g.num_vertices(), std::vector<index_t>(num_cols))
+        attack_(g.num_vertices(), std::vector<index_t>(num_cols))
     { 
         assert(num_cols_ > 0 && num_cols_ < BIT_LEN);
-
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<index_t> distrib(
-            std::numeric_limits<index_t>::min(), std::numeric_limits<index_t>::max());
-
-        for (auto i = 0; i < zobrist_.size(); ++i) {
-            for (auto j = 0; j < zobrist_[i].size(); ++j) {
-                zobrist_[i][j] = distrib(gen);
-            }
-        }
-
         check_invariant();
     }
 
@@ -71,9 +57,9 @@ class vertex_coloring {
     const index_t unassigned_{ 9000 };
     std::vector<index_t> col_;
     std::vector<std::vector<index_t>> attack_;
-    std::vector<std::vector<index_t>> zobrist_;
     const int num_cols_;
     int colored_vertices_{ 0 };
+    index_t hash_{ 0 };
 };
 
 bool operator==(const vertex_coloring& c1, const vertex_coloring& c2);
@@ -0,0 +1,144 @@
+#ifndef WIDE_COLORING_HPP
+#define WIDE_COLORING_HPP
+
+#include "common.hpp"
+#include "bitset.hpp"
+#include "graph.hpp"
+#include "zobrist.hpp"
+
+#include <cassert>
+#include <vector>
+
+// bitboard_coloring for graphs of more than 64 vertices: the same masks, as
+// bitsets of Words words. As there, uncolor_vertex() must undo the most
+// recent color_vertex() that has not been undone yet.
+template <int Words>
+class wide_coloring {
+  public:
+	typedef wide_bitset<Words> bitset;
+
+	wide_coloring(const graph& g, int num_cols)
+		: n_(g.num_vertices()),
+		num_cols_(num_cols),
+		uncolored_(bitset::below(g.num_vertices())),
+		rows_(g.num_vertices()),
+		attack_(num_cols),
+		undo_(g.num_vertices())
+	{
+		assert(num_cols_ > 0 && num_cols_ < static_cast<int>(BIT_LEN));
+		assert(g.num_words() == Words);
+
+		for (int u = 0; u < n_; ++u) {
+			rows_[u] = bitset::from_words(g.row(u));
+		}
+	}
+
+	wide_coloring(const wide_coloring&) = delete;
+	wide_coloring& operator=(const wide_coloring&) = delete;
+
+	void color_vertex(int u, int c) {
+		assert(u >= 0 && u < n_ && c >= 0 && c < num_cols_);
+		assert(uncolored_.test(u) && !attack_[c].test(u));
+
+		undo_[colored_vertices_++] = attack_[c];
+		attack_[c] |= rows_[u];
+		uncolored_.reset(u);
+		hash_ ^= wide_zobrist_key(u, c);
+	}
+
+	void uncolor_vertex(int u, int c) {
+		assert(colored_vertices_ > 0 && !uncolored_.test(u));
+
+		attack_[c] = undo_[--colored_vertices_];
+		uncolored_.set(u);
+		hash_ ^= wide_zobrist_key(u, c);
+	}
+
+	index_t get_allowed_colors(int u) const {
+		index_t allowed = 0;
+		for (int c = 0; c < num_cols_; ++c) {
+			allowed |= static_cast<index_t>(!attack_[c].test(u)) << c;
+		}
+
+		return allowed;
+	}
+
+	int num_colored_vertices() const {
+		return colored_vertices_;
+	}
+
+	int num_vertices() const {
+		return n_;
+	}
+
+	int num_colors() const {
+		return num_cols_;
+	}
+
+	bool is_colored() const {
+		return uncolored_.none();
+	}
+
+	bool is_deadend() const {
+		// An uncolored vertex attacked in every color
+		bitset dead = uncolored_;
+		for (int c = 0; c < num_cols_ && dead.any(); ++c) {
+			dead &= attack_[c];
+		}
+
+		return dead.any();
+	}
+
+	// As bitboard_coloring::representative_colors()
+	index_t representative_colors() const {
+		index_t reps = 0;
+
+		for (int c = 0; c < num_cols_; ++c) {
+			const bitset blocked = attack_[c] & uncolored_;
+			bool equivalent = false;
+
+			for (int d = 0; d < c && !equivalent; ++d) {
+				equivalent = ((reps >> d) & 1ULL) && (attack_[d] & uncolored_) == blocked;
+			}
+
+			if (!equivalent) {
+				reps |= 1ULL << c;
+			}
+		}
+
+		return reps;
+	}
+
+	const bitset& uncolored() const {
+		return uncolored_;
+	}
+
+	const bitset& attacked(int c) const {
+		return attack_[c];
+	}
+
+	const bitset& neighbors(int u) const {
+		return rows_[u];
+	}
+
+	index_t zobrist_hash() const {
+		return hash_;
+	}
+
+  private:
+	const int n_;
+	const int num_cols_;
+	int colored_vertices_{ 0 };
+	bitset uncolored_;
+	index_t hash_{ 0 };
+
+	std::vector<bitset> rows_;
+
+	// attack_[c] holds the vertices with a neighbor colored c
+	std::vector<bitset> attack_;
+
+	// attack_[c] before each color_vertex(u, c), in move order
+	std::vector<bitset> undo_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,389 @@
+#include "wide_search.hpp"
+
+#include "endgame.hpp"
+#include "fixed_search.hpp"
+#include "graph.hpp"
+#include "reductions.hpp"
+#include "transposition_table.hpp"
+#include "wide_coloring.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <thread>
+#include <vector>
+
+namespace {
+	// Table depths are 8 bits
+	static constexpr int MAX_TT_DEPTH = 255;
+
+	template <int Words>
+	class wide_search {
+	  public:
+		typedef wide_bitset<Words> bitset;
+
+		wide_search(const graph& g, int num_cols, transposition_table& tt, const search_options& options, int rotation = 0)
+			: col_(g, num_cols),
+			tt_(tt),
+			options_(options),
+			rotation_(rotation),
+			endgame_vertices_(num_cols <= MAX_ENDGAME_COLORS ? std::min(options.endgame_vertices_, MAX_ENDGAME_VERTICES) : 0),
+			lists_(g.num_vertices() + 1),
+			free_count_(g.num_vertices()),
+			twins_below_(g.num_vertices())
+		{
+			const int n = g.num_vertices();
+
+			for (int v = 0; v < n; ++v) {
+				for (int u = 0; u < v; ++u) {
+					bitset nu = col_.neighbors(u);
+					bitset nv = col_.neighbors(v);
+					nu.reset(v);
+					nv.reset(u);
+
+					if (nu == nv) {
+						twins_below_[v].set(u);
+						has_twin_below_.set(v);
+					}
+				}
+			}
+		}
+
+		bool alice_wins() {
+			counters_.count_node();
+			counters_.record_node(col_.num_colored_vertices());
+
+			if (stop_ != nullptr && stop_->load(std::memory_order_relaxed)) {
+				return false;
+			}
+
+			if (col_.is_colored()) {
+				counters_.record_terminal();
+				return true;
+			}
+
+			if (col_.is_deadend()) {
+				counters_.record_terminal();
+				return false;
+			}
+
+			const bitset safe = safe_vertices();
+
+			if (options_.safe_reductions_ && safe == col_.uncolored()) {
+				++counters_.safe_wins_;
+				return true;
+			}
+
+			const bool alice = col_.num_colored_vertices() % 2 == 0;
+			bitset defusers = col_.uncolored();
+
+			if (options_.bob_threats_ && is_threat_win(alice, defusers)) {
+				++counters_.threat_wins_;
+				return false;
+			}
+
+			if (col_.uncolored().count() <= endgame_vertices_) {
+				return solve_endgame(alice);
+			}
+
+			const index_t key = col_.zobrist_hash();
+			tt_entry e;
+			const bool hit = tt_.probe(key, e);
+			counters_.record_probe(hit);
+
+			if (hit) {
+				return e.value_ > 0;
+			}
+
+			bool result = !alice;
+
+			for (const move m : generate_moves(safe, defusers)) {
+				col_.color_vertex(m.vertex_, m.color_);
+				const bool child = alice_wins();
+				col_.uncolor_vertex(m.vertex_, m.color_);
+
+				if (stopped()) {
+					return false;
+				}
+
+				if (child == alice) {
+					counters_.record_cutoff();
+					result = child;
+					break;
+				}
+			}
+
+			// The best move is left out, as vertices past 127 do not fit an entry
+			const int depth = std::min(col_.num_vertices() - col_.num_colored_vertices(), MAX_TT_DEPTH);
+			tt_.store(key, result ? 1 : -1, Bound::Exact, depth, move());
+
+			return result;
+		}
+
+		// A move that keeps the player to move winning, or the first legal
+		// move if there is none
+		move line_move() {
+			const bool alice = col_.num_colored_vertices() % 2 == 0;
+			const std::vector<move>& moves = generate_moves(safe_vertices(), col_.uncolored());
+
+			for (const move m : moves) {
+				col_.color_vertex(m.vertex_, m.color_);
+				const bool child = alice_wins();
+				col_.uncolor_vertex(m.vertex_, m.color_);
+
+				if (child == alice) {
+					return m;
+				}
+			}
+
+			return moves.front();
+		}
+
+		bool stopped() const {
+			return stop_ != nullptr && stop_->load(std::memory_order_relaxed);
+		}
+
+		wide_coloring<Words> col_;
+		search_counters counters_;
+		const std::atomic<bool>* stop_{ nullptr };
+
+	  private:
+		bitset safe_vertices() const {
+			if (!options_.safe_reductions_) {
+				return bitset();
+			}
+
+			return ::safe_vertices(col_.uncolored(), [this](int u) -> const bitset& { return col_.neighbors(u); },
+				[this](int u) { return col_.get_allowed_colors(u); });
+		}
+
+		// As game_state::solve_endgame()
+		bool solve_endgame(bool alice) {
+			const auto rows = [this](int u) -> const bitset& { return col_.neighbors(u); };
+			const auto allowed = [this](int u) { return col_.get_allowed_colors(u); };
+
+			++counters_.endgame_solves_;
+			return ::solve_endgame(make_endgame(col_.uncolored(), rows, allowed), alice, counters_.endgame_nodes_, &endgames_);
+		}
+
+		// As game_state::is_threat_win()
+		bool is_threat_win(bool alice, bitset& defusers) const {
+			const auto rows = [this](int u) -> const bitset& { return col_.neighbors(u); };
+			const auto attacked = [this](int c) -> const bitset& { return col_.attacked(c); };
+
+			if (!alice) {
+				return has_bob_threat(col_.uncolored(), col_.num_colors(), rows, attacked);
+			}
+
+			defusers = threat_defusers(col_.uncolored(), col_.num_colors(), rows, attacked);
+			return defusers.none();
+		}
+
+		// As game_state::generate_moves() with move_orderer: vertices with
+		// an uncolored twin of smaller index, interchangeable colors and all
+		// tempo moves but one are left out, and the moves are sorted by their
+		// static score
+		const std::vector<move>& generate_moves(const bitset& safe, const bitset& defusers) {
+			const int ply = col_.num_colored_vertices();
+			const bool alice = ply % 2 == 0;
+			const Ordering policy = alice ? options_.alice_ordering_ : options_.bob_ordering_;
+			const bitset& uncols = col_.uncolored();
+			const index_t colors = col_.representative_colors();
+
+			bitset cand = uncols;
+			(uncols & has_twin_below_).for_each([&](int v) {
+				if ((twins_below_[v] & uncols).any()) {
+					cand.reset(v);
+				}
+			});
+			counters_.twin_prunes_ += uncols.count() - cand.count();
+
+			int one_color = -1;
+
+			if (options_.safe_reductions_ && safe.any()) {
+				const bitset tempo = tempo_vertices(uncols, safe, [this](int u) -> const bitset& { return col_.neighbors(u); });
+
+				if (tempo.any()) {
+					one_color = tempo.lowest();
+					counters_.tempo_prunes_ += tempo.count() - 1;
+					cand &= ~tempo;
+					cand.set(one_color);
+				}
+			}
+
+			counters_.threat_prunes_ += (cand & ~defusers).count();
+			cand &= defusers;
+
+			auto& list = lists_[ply];
+			list.clear();
+
+			cand.for_each([&](int v) {
+				index_t allowed = col_.get_allowed_colors(v) & colors;
+				if (v == one_color) {
+					allowed &= ~allowed + 1;
+				}
+
+				for (; allowed != 0; allowed &= allowed - 1) {
+					list.emplace_back(v, std::countr_zero(allowed));
+				}
+			});
+
+			if (policy != Ordering::Natural) {
+				order(list, alice);
+			}
+
+			if (rotation_ != 0 && ply < ROTATED_PLIES && list.size() > 1) {
+				std::rotate(list.begin(), list.begin() + rotation_ % list.size(), list.end());
+			}
+
+			return list;
+		}
+
+		// move_orderer's static scores
+		void order(std::vector<move>& list, bool alice) {
+			const bitset& uncols = col_.uncolored();
+			const int k = col_.num_colors();
+
+			uncols.for_each([&](int v) {
+				free_count_[v] = std::popcount(col_.get_allowed_colors(v));
+			});
+
+			keys_.clear();
+
+			for (std::size_t i = 0; i < list.size(); ++i) {
+				const move m = list[i];
+				const bitset nbrs = col_.neighbors(m.vertex_) & uncols;
+				std::uint64_t key = 0;
+
+				if (alice) {
+					key = static_cast<std::uint64_t>(free_count_[m.vertex_]) * MAX_VERTICES + nbrs.count();
+				}
+				else {
+					const bitset hit = nbrs & ~col_.attacked(m.color_);
+					int fewest = k;
+					hit.for_each([&](int u) { fewest = std::min(fewest, free_count_[u]); });
+
+					key = hit.any() ? static_cast<std::uint64_t>(k + 1 - fewest) * MAX_VERTICES + hit.count() : 0;
+				}
+
+				keys_.emplace_back(key, i);
+			}
+
+			std::stable_sort(keys_.begin(), keys_.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+			sorted_.clear();
+			for (const auto& [key, i] : keys_) {
+				sorted_.push_back(list[i]);
+			}
+			list.swap(sorted_);
+		}
+
+		transposition_table& tt_;
+		const search_options options_;
+		const int rotation_;
+		const int endgame_vertices_;
+		endgame_table endgames_;
+
+		std::vector<std::vector<move>> lists_;
+		std::vector<std::pair<std::uint64_t, std::size_t>> keys_;
+		std::vector<move> sorted_;
+		std::vector<int> free_count_;
+
+		std::vector<bitset> twins_below_;
+		bitset has_twin_below_;
+	};
+
+	template <int Words>
+	Victory solve_outcome_words(const graph& g, int num_cols, transposition_table& tt,
+		search_counters* counters, const search_options& options) {
+		tt.new_search();
+
+		// Lazy SMP as in solve_outcome()
+		std::atomic<bool> stop{ false };
+		std::atomic<bool> win{ false };
+		std::vector<search_counters> thread_counters(std::max(options.threads_, 1));
+
+		const auto search = [&](int id) {
+			wide_search<Words> root(g, num_cols, tt, options, id);
+			root.counters_.live_nodes_ = counters != nullptr ? counters->live_nodes_ : nullptr;
+
+			if (thread_counters.size() > 1) {
+				root.stop_ = &stop;
+			}
+
+			const bool result = root.alice_wins();
+
+			if (!root.stopped()) {
+				win.store(result, std::memory_order_relaxed);
+				stop.store(true, std::memory_order_relaxed);
+			}
+
+			thread_counters[id] = root.counters_;
+		};
+
+		std::vector<std::thread> helpers;
+		for (int id = 1; id < static_cast<int>(thread_counters.size()); ++id) {
+			helpers.emplace_back(search, id);
+		}
+
+		search(0);
+
+		for (auto& helper : helpers) {
+			helper.join();
+		}
+
+		if (counters != nullptr) {
+			for (const auto& c : thread_counters) {
+				*counters += c;
+			}
+		}
+
+		return win.load() ? Victory::Alice : Victory::Bob;
+	}
+
+	template <int Words>
+	std::pair<Victory, std::queue<move>> principal_line_words(const graph& g, int num_cols, transposition_table& tt) {
+		wide_search<Words> root(g, num_cols, tt, search_options());
+		std::queue<move> moves;
+
+		while (!root.col_.is_colored() && !root.col_.is_deadend()) {
+			const move next = root.line_move();
+
+			moves.emplace(next);
+			root.col_.color_vertex(next.vertex_, next.color_);
+		}
+
+		return std::make_pair(root.col_.is_colored() ? Victory::Alice : Victory::Bob, moves);
+	}
+}
+
+Victory solve_outcome_wide(const graph& g, int num_cols, transposition_table& tt,
+	search_counters* counters, const search_options& options) {
+	if (use_fixed_kernel(g, num_cols, options)) {
+		return solve_outcome_fixed(g, num_cols, tt, nullptr, counters, options);
+	}
+
+	switch (g.num_words()) {
+	case 2:
+		return solve_outcome_words<2>(g, num_cols, tt, counters, options);
+	case 4:
+		return solve_outcome_words<4>(g, num_cols, tt, counters, options);
+	default:
+		return solve_outcome_words<8>(g, num_cols, tt, counters, options);
+	}
+}
+
+std::pair<Victory, std::queue<move>> principal_line_wide(const graph& g, int num_cols, transposition_table& tt) {
+	if (has_fixed_kernel(g, num_cols)) {
+		return principal_line_fixed(g, num_cols, tt);
+	}
+
+	switch (g.num_words()) {
+	case 2:
+		return principal_line_words<2>(g, num_cols, tt);
+	case 4:
+		return principal_line_words<4>(g, num_cols, tt);
+	default:
+		return principal_line_words<8>(g, num_cols, tt);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#ifndef WIDE_SEARCH_HPP
+#define WIDE_SEARCH_HPP
+
+#include "game_state.hpp"
+#include "minimax.hpp"
+#include "move.hpp"
+
+#include <queue>
+#include <utility>
+
+class graph;
+class transposition_table;
+
+// The search for graphs of more than 64 vertices, on wide_coloring with
+// 2, 4 or 8 words chosen from the order of g. It is alice_wins() with the
+// static and natural move orderings, twin pruning and color symmetry, but
+// without automorphism orbits. solve_outcome(), solve_outcome_dfpn() and
+// play_optimally() hand such graphs over to it.
+Victory solve_outcome_wide(const graph& g, int num_cols, transposition_table& tt,
+	search_counters* counters = nullptr, const search_options& options = search_options());
+
+// As principal_line(), for graphs of more than 64 vertices
+std::pair<Victory, std::queue<move>> principal_line_wide(const graph& g, int num_cols, transposition_table& tt);
+
+#endif
\ No newline at end of file
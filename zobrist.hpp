@@ -0,0 +1,53 @@
+#ifndef ZOBRIST_HPP
+#define ZOBRIST_HPP
+
+#include "common.hpp"
+
+#include <array>
+
+// Zobrist keys for (vertex, color) pairs. The table is generated at compile
+// time from a fixed seed, so all colorings share it and hashes are stable
+// between runs.
+
+static constexpr index_t ZOBRIST_SEED = 0x9E3779B97F4A7C15ULL;
+
+typedef std::array<std::array<index_t, BIT_LEN>, BIT_LEN> zobrist_table;
+
+constexpr index_t splitmix64(index_t& state) {
+	index_t z = (state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+constexpr zobrist_table make_zobrist_table() {
+	zobrist_table t{};
+	index_t state = ZOBRIST_SEED;
+
+	for (index_t u = 0; u < BIT_LEN; ++u) {
+		for (index_t c = 0; c < BIT_LEN; ++c) {
+			t[u][c] = splitmix64(state);
+		}
+	}
+
+	return t;
+}
+
+inline constexpr zobrist_table ZOBRIST = make_zobrist_table();
+
+inline index_t zobrist_key(index_t u, index_t c) {
+	return ZOBRIST[u][c];
+}
+
+// Keys of vertices past the table, in graphs of more than 64 vertices, are
+// mixed from the pair when needed
+inline index_t wide_zobrist_key(index_t u, index_t c) {
+	if (u < BIT_LEN) {
+		return ZOBRIST[u][c];
+	}
+
+	index_t state = ZOBRIST_SEED ^ (u << 6 | c);
+	return splitmix64(state);
+}
+
+#endif
\ No newline at end of file